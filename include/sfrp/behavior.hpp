@@ -180,7 +180,8 @@
 //
 // When b is defined elsewhere, 'Behavior<A> m = n' implies that 'm' and 'n'
 // refer to the same reference. Implementation wise, we handle this by use of a
-// shared pointer.
+// shared pointer. The referenced node is allocated from the current
+// 'BehaviorGraphArena', if there is one. See sfrp_behaviorgrapharena.
 //
 // Usage
 // -----
@@ -381,12 +382,71 @@
 //    }
 //  }
 //..
+//
+// Example 5: Batch Retrieval
+// - - - - - - - - - - - - -
+// Offline users, such as back-testers, frequently know all the times they are
+// interested in ahead of time. Rather than calling 'pull()' once per time, the
+// whole array of times can be handed to 'pullBatch()'.
+//..
+//  std::vector<double> times = /* increasing sample times */;
+//  std::vector<double> values(times.size());
+//  const std::size_t definedCount =
+//      positionBehavior.pullBatch(times.data(), times.size(), values.data());
+//..
+// 'definedCount' is the number of leading times at which 'positionBehavior'
+// is defined. Pure behaviors, such as those created by 'BehaviorUtil::pure()'
+// and 'BehaviorMap' over pure arguments, evaluate the entire batch in a single
+// tight loop. Behaviors that aren't pure, such as those that depend upon a
+// wormhole, are evaluated one time at a time in order so that their results
+// are identical to those of repeated calls to 'pull()'.
+//
+// Pure behaviors may also be sampled with 'evaluate()', which takes an array
+// of times like 'pullBatch()' but doesn't pull the behavior. The times may
+// precede those of previous pulls and the values of previous pulls, including
+// those of the nodes the behavior depends upon, remain valid. Combinators that
+// sub-sample their arguments between pulls, such as
+// 'VectorSpaceUtil::integral()', use it.
+//..
+//  const double earlierTimes[] = {0.25, 0.5};
+//  double earlierValues[2];
+//  const std::size_t evaluatedCount =
+//      positionBehavior.evaluate(earlierTimes, 2, earlierValues);
+//..
+// Only pure behaviors created with an evaluation function, such as those of
+// 'BehaviorUtil::pure()' and 'BehaviorMap' over such behaviors, are evaluated.
+// Other behaviors evaluate no values.
+//
+// Constant Behaviors
+// ------------------
+// A behavior is constant when it has the same value, or is undefined, for all
+// time. Behaviors created with 'fromConstantValue()', such as those returned
+// by 'BehaviorUtil::always()', and behaviors that are no longer defined are
+// constant. Combinators such as 'BehaviorMap' use 'isConstant()' and
+// 'constantValue()' to fold constant arguments when the combined behavior is
+// created, so that constant parts of a graph are not pulled at every time.
+//
+// Piecewise Constant Behaviors
+// ----------------------------
+// Some behaviors, such as those created by 'EventUtil::step()', keep their
+// value between occurrences. Such behaviors report when they change through
+// their value version, see 'valueVersion()' and sfrp_behaviornode, and
+// 'BehaviorMap' results over them apply their function only when an argument
+// changed. Expensive functions of stepped inputs are then evaluated once per
+// change instead of at every pull. Behaviors whose values are compared with
+// the previous ones, such as those returned by 'BehaviorUtil::distinct()',
+// report their changes as well.
 
 #include <boost/function.hpp>
-#include <boost/make_shared.hpp>
 #include <boost/optional.hpp>
 #include <boost/shared_ptr.hpp>
+#include <algorithm>  // std::fill
+#include <cstddef>    // std::size_t
+#include <cstdint>    // std::uint64_t
+#include <sfrp/behaviorgrapharena.hpp>
+#include <sfrp/behaviornode.hpp>
 #include <sfrp/cachedincreasingpartialtimefunction.hpp>
+#include <sfrp/graphpointer.hpp>
 
 namespace sfrp {
 
@@ -418,6 +478,90 @@ struct Behavior {
   // 'boost::none', it will return 'boost::none' thereafter.
   boost::optional<Value> pull(const double time) const;
 
+  // Return the address of the value of this partial time function at the
+  // specified 'time' if it is defined, otherwise return 0. The value is
+  // shared with all the other pulls of this behavior at 'time' and remains
+  // valid until this behavior is pulled at a different time or destroyed. The
+  // behavior is undefined unless the preconditions of 'pull()' hold for
+  // 'time'.
+  //
+  // Note that 'pullPointer()' copies no values and is preferred to 'pull()'
+  // for behaviors of large values.
+  const Value* pullPointer(const double time) const;
+
+  // Load into the specified 'out' array the values of this partial time
+  // function at each of the specified 'n' 'times' until the first time at
+  // which it is not defined. Return the number of values loaded. The result is
+  // equivelent to calling 'pull()' with each of 'times' in order. The behavior
+  // is undefined unless 'times' is strictly increasing, the first time
+  // satisfies the preconditions of 'pull()', and 'out' has room for 'n'
+  // values.
+  //
+  // Note that pure behaviors may be batch pulled by each of their dependents
+  // with the same times.
+  std::size_t pullBatch(const double* times, std::size_t n, Value* out) const;
+
+  // Load into the specified 'out' array the values of this behavior at each of
+  // the specified 'n' 'times' until the first time at which it is not defined
+  // without pulling it. Return the number of values loaded, which is 0 if this
+  // behavior can't be evaluated. Unlike 'pullBatch()', 'times' may precede the
+  // times of previous pulls and no cached value or value version changes. The
+  // behavior is undefined unless 'times' is strictly increasing and 'out' has
+  // room for 'n' values.
+  //
+  // Note that only pure behaviors created with an evaluation function can be
+  // evaluated. See 'fromValuePullFunc()'.
+  std::size_t evaluate(const double* times, std::size_t n, Value* out) const;
+
+  // Return 'true' if the values of this behavior depend only upon time and
+  // pulling it has no side effects, and 'false' otherwise.
+  bool isPure() const;
+
+  // Return 'true' if this behavior has the same value, or is undefined, for
+  // all time and 'false' otherwise. Unlike other behaviors, constant
+  // behaviors may be pulled at any time regardless of the times of previous
+  // pulls.
+  bool isConstant() const;
+
+  // Return the value of this behavior if it is constant and defined and
+  // 'boost::none' otherwise.
+  boost::optional<Value> constantValue() const;
+
+  // Return the value version of the node implementing this behavior, or '0'
+  // if this behavior is no longer defined. The version differs from that of a
+  // previous pull whenever the value may differ from the value of that pull.
+  // See sfrp_behaviornode.
+  std::uint64_t valueVersion() const;
+
+  // Return the graph node implementing this behavior or a null pointer if
+  // this behavior is no longer defined. The node's change tracking may be
+  // configured by combinators that construct this behavior. See
+  // sfrp_behaviornode.
+  boost::shared_ptr<BehaviorNode> node() const;
+
+  // Return the address of the graph node implementing this behavior or a null
+  // pointer if this behavior is no longer defined. The node remains valid as
+  // long as this behavior refers to it.
+  //
+  // Note that unlike 'node()', 'nodeAddress()' changes no reference count.
+  BehaviorNode* nodeAddress() const;
+
+  // Make the node implementing this behavior keep its previous value and
+  // value version whenever it evaluates to an equal value, if this behavior
+  // is still defined. Combinators such as 'BehaviorUtil::distinct()' use this
+  // on the behaviors they construct. See
+  // 'CachedIncreasingPartialTimeFunction::setDistinct()'.
+  void setDistinct() const;
+
+  // Return a behavior implemented by the specified 'node'. The behavior is
+  // undefined unless 'node' is null or was returned by the 'node()' function
+  // of a 'Behavior<Value>' object.
+  static Behavior<Value> fromNode(const boost::shared_ptr<BehaviorNode>& node);
+
+  // Create a new, constant 'Behavior<Value>' object that has the specified
+  // 'value' for all time.
+  static Behavior<Value> fromConstantValue(const Value& value);
+
   // Create a new 'Behavior<Value>' object from the 'valuePullFunc' function.
   // The behavior is undefined unless 'valuePullFunc' returns a value when it
   // is called once and is defined with increasing argument values as long as
@@ -425,8 +569,39 @@ struct Behavior {
   static Behavior<Value> fromValuePullFunc(
       boost::function<boost::optional<Value>(double)> valuePullFunc);
 
+  // Create a new 'Behavior<Value>' object from the 'valuePullFunc' function
+  // and the 'valuePullBatchFunc' function which is used by 'pullBatch()'. The
+  // resulting behavior is pure if the specified 'pure' is 'true'. The behavior
+  // is undefined unless 'valuePullFunc' satisfies the requirements of the
+  // single argument 'fromValuePullFunc()', a call of 'valuePullBatchFunc' is
+  // equivelent to calling 'valuePullFunc' with each of its times in order and
+  // returning the number of defined values, and, if 'pure' is 'true',
+  // 'valuePullFunc' depends only upon its argument and has no side effects.
+  static Behavior<Value> fromValuePullFunc(
+      boost::function<boost::optional<Value>(double)> valuePullFunc,
+      boost::function<std::size_t(const double*, std::size_t, Value*)>
+          valuePullBatchFunc,
+      bool pure);
+
+  // Create a new 'Behavior<Value>' object from the 'valuePullFunc' function,
+  // the 'valuePullBatchFunc' function which is used by 'pullBatch()' and the
+  // specified 'valueEvaluateFunc' function which is used by 'evaluate()'. The
+  // resulting behavior is pure if 'valueEvaluateFunc' isn't empty. The
+  // behavior is undefined unless 'valuePullFunc' and 'valuePullBatchFunc'
+  // satisfy the requirements of the previous 'fromValuePullFunc()' and, if
+  // 'valueEvaluateFunc' isn't empty, 'valuePullFunc' depends only upon its
+  // argument and has no side effects and a call of 'valueEvaluateFunc' loads
+  // the values that 'valuePullBatchFunc' would without pulling any behavior.
+  static Behavior<Value> fromValuePullFunc(
+      boost::function<boost::optional<Value>(double)> valuePullFunc,
+      boost::function<std::size_t(const double*, std::size_t, Value*)>
+          valuePullBatchFunc,
+      boost::function<std::size_t(const double*, std::size_t, Value*)>
+          valueEvaluateFunc);
+
  private:
-  mutable boost::shared_ptr<CachedIncreasingPartialTimeFunction<Value>> m_timeFunction;
+  mutable GraphPointer<CachedIncreasingPartialTimeFunction<Value>>
+      m_timeFunction;
 };
 
 // ===========================================================================
@@ -437,8 +612,50 @@ template <typename A>
 Behavior<A> Behavior<A>::fromValuePullFunc(
     boost::function<boost::optional<A>(double)> valuePullFunc) {
   Behavior<A> result;
-  result.m_timeFunction =
-      boost::make_shared<CachedIncreasingPartialTimeFunction<A>>(std::move(valuePullFunc));
+  result.m_timeFunction = BehaviorGraphArena::makeGraphPointer<
+      CachedIncreasingPartialTimeFunction<A>>(std::move(valuePullFunc));
+  return result;
+}
+
+template <typename A>
+Behavior<A> Behavior<A>::fromValuePullFunc(
+    boost::function<boost::optional<A>(double)> valuePullFunc,
+    boost::function<std::size_t(const double*, std::size_t, A*)>
+        valuePullBatchFunc,
+    bool pure) {
+  Behavior<A> result;
+  result.m_timeFunction = BehaviorGraphArena::makeGraphPointer<
+      CachedIncreasingPartialTimeFunction<A>>(
+      std::move(valuePullFunc), std::move(valuePullBatchFunc), pure);
+  return result;
+}
+
+template <typename A>
+Behavior<A> Behavior<A>::fromValuePullFunc(
+    boost::function<boost::optional<A>(double)> valuePullFunc,
+    boost::function<std::size_t(const double*, std::size_t, A*)>
+        valuePullBatchFunc,
+    boost::function<std::size_t(const double*, std::size_t, A*)>
+        valueEvaluateFunc) {
+  Behavior<A> result;
+  result.m_timeFunction = BehaviorGraphArena::makeGraphPointer<
+      CachedIncreasingPartialTimeFunction<A>>(std::move(valuePullFunc),
+                                              std::move(valuePullBatchFunc),
+                                              std::move(valueEvaluateFunc));
+  return result;
+}
+
+template <typename A>
+Behavior<A> Behavior<A>::fromConstantValue(const A& value) {
+  const auto fill = [value](const double* times, std::size_t n, A* out) {
+    std::fill(out, out + n, value);
+    return n;
+  };
+  Behavior<A> result = fromValuePullFunc(
+      [value](double time) { return boost::make_optional(value); },
+      fill,
+      fill);
+  result.m_timeFunction->setConstant();
   return result;
 }
 
@@ -457,6 +674,86 @@ boost::optional<A> Behavior<A>::pull(const double time) const {
     return boost::none;
 }
 
+template <typename A>
+const A* Behavior<A>::pullPointer(const double time) const {
+  if (m_timeFunction) {
+    const A* const result = m_timeFunction->pullPointer(time);
+    if (!result)
+      m_timeFunction.reset();
+    return result;
+  } else
+    return 0;
+}
+
+template <typename A>
+std::size_t Behavior<A>::pullBatch(const double* times,
+                                   std::size_t n,
+                                   A* out) const {
+  if (m_timeFunction) {
+    const std::size_t count = m_timeFunction->pullBatch(times, n, out);
+    if (count < n)
+      m_timeFunction.reset();
+    return count;
+  } else
+    return 0;
+}
+
+template <typename A>
+std::size_t Behavior<A>::evaluate(const double* times,
+                                  std::size_t n,
+                                  A* out) const {
+  return m_timeFunction ? m_timeFunction->evaluate(times, n, out) : 0;
+}
+
+template <typename A>
+bool Behavior<A>::isPure() const {
+  return !m_timeFunction || m_timeFunction->isPure();
+}
+
+template <typename A>
+bool Behavior<A>::isConstant() const {
+  return !m_timeFunction ||
+         m_timeFunction->changeMode() == BehaviorNode::e_CONSTANT;
+}
+
+template <typename A>
+boost::optional<A> Behavior<A>::constantValue() const {
+  if (!m_timeFunction || !isConstant())
+    return boost::none;
+  // Constant nodes reuse their cached value at every time, so the time of
+  // this pull doesn't matter.
+  return pull(0.0);
+}
+
+template <typename A>
+std::uint64_t Behavior<A>::valueVersion() const {
+  return m_timeFunction ? m_timeFunction->valueVersion() : 0;
+}
+
+template <typename A>
+boost::shared_ptr<BehaviorNode> Behavior<A>::node() const {
+  return boost::shared_ptr<BehaviorNode>(m_timeFunction);
+}
+
+template <typename A>
+BehaviorNode* Behavior<A>::nodeAddress() const {
+  return m_timeFunction.get();
+}
+
+template <typename A>
+void Behavior<A>::setDistinct() const {
+  if (m_timeFunction)
+    m_timeFunction->setDistinct();
+}
+
+template <typename A>
+Behavior<A> Behavior<A>::fromNode(const boost::shared_ptr<BehaviorNode>& node) {
+  Behavior<A> result;
+  result.m_timeFunction =
+      boost::static_pointer_cast<CachedIncreasingPartialTimeFunction<A>>(node);
+  return result;
+}
+
 template <typename A>
 Behavior<A>::Behavior(Behavior<A>&& behavior)
     : m_timeFunction(std::move(behavior.m_timeFunction)) {}
@@ -0,0 +1,751 @@
+#ifndef SFRP_BEHAVIORARRAY_HPP_
+#define SFRP_BEHAVIORARRAY_HPP_
+
+//@PURPOSE: Provide behaviors of arrays of homogeneous entities.
+//
+//@CLASSES:
+//  sfrp::ValueArray: array of values stored as a structure of arrays
+//  sfrp::BehaviorArray: behavior of the values of many entities
+//  sfrp::BehaviorArrayUtil: whole-array behavior operations namespace
+//
+//@SEE_ALSO: sfrp_vectorspaceutil, sfrp_normedvectorspaceutil
+//
+//@DESCRIPTION: This component provides a behavior type, 'BehaviorArray<T>',
+// for the values of many entities of the same kind, and a namespace class,
+// 'BehaviorArrayUtil', of operations on such behaviors.
+//
+// Modelling 'N' entities with 'N' behaviors builds 'N' graphs. For large 'N'
+// the overhead of their nodes, rather than the computations of the nodes,
+// dominates the cost of pulls. A 'BehaviorArray<T>' is a single behavior whose
+// values, 'ValueArray<T>' objects, hold the values of all of the entities.
+// Each operation of 'BehaviorArrayUtil' creates a single node that processes
+// the whole array at every pull. 'map()', 'smooth()', 'integral()' and 'sum()'
+// apply to every element what 'BehaviorMap', 'NormedVectorSpaceUtil::smooth()',
+// 'VectorSpaceUtil::integral()' and 'VectorSpaceUtil::sum()' apply to a single
+// behavior.
+//
+// Storage
+// -------
+// A 'ValueArray<T>' stores its values contiguously. 'ValueArray<Point2D>'
+// stores the 'x' and the 'y' coordinates of its points in two separate
+// contiguous arrays. The kernels of the vector space operations are then
+// simple loops over arrays of 'double' values, which compilers vectorize.
+// The kernel of 'smooth()' takes square roots and is only vectorized when
+// floating point exceptions and 'errno' may be ignored, for instance with the
+// '-fno-math-errno -fno-trapping-math' options of GCC or the '/fp:fast' option
+// of MSVC. 'smisc::Point1D' values are 'double' values and need no special
+// layout.
+//
+// Copies of a 'ValueArray' share its values until either of them is
+// modified, so copying an array, for instance into the cache of a node,
+// copies no values. The stateful operations, 'smooth()', 'integral()' and
+// 'sum()', pull their arguments with 'Behavior::pullPointer()' and keep two
+// arrays: the values of the previous pull, which the cache of their node
+// shares, and those of the pull before, which the cache no longer shares. A
+// pull computes its values into the storage of the latter and swaps the two,
+// so it neither copies nor, once the sizes of the arrays are stable,
+// allocates an array.
+//
+// The arguments of the stateful operations may change size between pulls.
+// The values of new elements start at zero, or at their target for
+// 'smooth()', and those of removed elements are dropped.
+//
+// The stateful operations created while a 'BehaviorCheckpointScope' is active
+// add their state to the registry of the scope (see sfrp_behaviorcheckpoint).
+// The state of 'sum()' is a 'ValueArray<T>' and that of 'smooth()' and
+// 'integral()' is a 'std::pair<ValueArray<T>, double>'. 'ValueArray' objects
+// are serializable with Boost.Serialization.
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: Particles
+// - - - - - - - - - -
+// A particle system moves thousands of particles, each with its own constant
+// velocity.
+//..
+//  sfrp::ValueArray<smisc::Point2D> velocities(10000, smisc::Point2D(0, 0));
+//  for (std::size_t i = 0; i < velocities.size(); ++i)
+//    velocities.set(i, smisc::Point2D(std::cos(i), std::sin(i)));
+//  const sfrp::BehaviorArray<smisc::Point2D> positions =
+//      sfrp::BehaviorArrayUtil::integral(
+//          sfrp::BehaviorArrayUtil::always(velocities));
+//..
+// The positions of all the particles are pulled at once, without copying.
+//..
+//  const sfrp::ValueArray<smisc::Point2D>* const current =
+//      positions.pullPointer(time);
+//  drawPoints(current->xs(), current->ys(), current->size());
+//..
+
+#include <boost/make_shared.hpp>
+#include <boost/optional.hpp>
+#include <boost/serialization/nvp.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/shared_ptr.hpp>
+#include <sfrp/behavior.hpp>
+#include <sfrp/behaviorcheckpoint.hpp>
+#include <sfrp/behaviorgrapharena.hpp>
+#include <smisc/normedvectorspace.hpp>
+#include <smisc/point1d.hpp>
+#include <smisc/point2d.hpp>
+#include <smisc/vectorspace.hpp>
+#include <algorithm>  // std::equal, std::min
+#include <cassert>
+#include <cmath>    // std::sqrt
+#include <cstddef>  // std::size_t
+#include <type_traits>
+#include <utility>  // std::move, std::pair, std::swap
+#include <vector>
+
+namespace sfrp {
+
+// This class implements an array of values stored contiguously.
+template <typename T>
+struct ValueArray {
+  typedef T value_type;
+
+  // Create an empty array.
+  ValueArray();
+
+  // Create an array of the specified 'size' copies of the specified 'value'.
+  ValueArray(std::size_t size, const T& value);
+
+  // Return the number of values of this array.
+  std::size_t size() const;
+
+  // Return the value at the specified 'index'. The behavior is undefined
+  // unless 'index < size()'.
+  T get(std::size_t index) const;
+
+  // Replace the value at the specified 'index' with the specified 'value'. The
+  // behavior is undefined unless 'index < size()'.
+  void set(std::size_t index, const T& value);
+
+  // Return the address of the first value of this array.
+  const T* data() const;
+
+  // Add the specified 'scale' times the values of the specified 'other' array
+  // to the values of this array. The behavior is undefined unless 'T' is a
+  // 'smisc::VectorSpace' and 'other.size() == size()'.
+  void addScaled(double scale, const ValueArray& other);
+
+  // Move each value of this array towards the value of the specified 'target'
+  // array at the same index by no more than the specified 'maxDistance'. The
+  // behavior is undefined unless 'T' is a 'smisc::NormedVectorSpace',
+  // 'target.size() == size()' and 'maxDistance > 0.0'.
+  void moveTowards(const ValueArray& target, double maxDistance);
+
+  // Replace the values of this array with the values of the specified 'base'
+  // array plus the specified 'scale' times those of the specified 'other'
+  // array at the same index. This array takes the size of 'other', and the
+  // missing values of 'base' are zero. The behavior is undefined unless 'T'
+  // is a 'smisc::VectorSpace'.
+  void setScaledSum(const ValueArray& base,
+                    double scale,
+                    const ValueArray& other);
+
+  // Replace the values of this array with the values of the specified 'from'
+  // array moved towards those of the specified 'target' array at the same
+  // index by no more than the specified 'maxDistance'. This array takes the
+  // size of 'target', and the missing values of 'from' are those of 'target'.
+  // The behavior is undefined unless 'T' is a 'smisc::NormedVectorSpace' and
+  // 'maxDistance > 0.0'.
+  void setMovedTowards(const ValueArray& from,
+                       const ValueArray& target,
+                       double maxDistance);
+
+  // Serialize this array with the specified 'archive'.
+  template <typename Archive>
+  void serialize(Archive& archive, const unsigned int version);
+
+ private:
+  // Return the address of the first of the specified 'size' values of this
+  // array, which are no longer shared. The values that are kept are
+  // unspecified and the new ones are copies of the specified 'value'.
+  T* writableData(std::size_t size, const T& value);
+
+  // The values of this array, shared with its copies, or null if it is empty.
+  boost::shared_ptr<std::vector<T>> m_values;
+};
+
+// This class implements an array of points whose coordinates are stored in
+// two separate contiguous arrays.
+template <>
+struct ValueArray<smisc::Point2D> {
+  typedef smisc::Point2D value_type;
+
+  // Create an empty array.
+  ValueArray();
+
+  // Create an array of the specified 'size' copies of the specified 'value'.
+  ValueArray(std::size_t size, const smisc::Point2D& value);
+
+  // Return the number of points of this array.
+  std::size_t size() const;
+
+  // Return the point at the specified 'index'. The behavior is undefined
+  // unless 'index < size()'.
+  smisc::Point2D get(std::size_t index) const;
+
+  // Replace the point at the specified 'index' with the specified 'value'. The
+  // behavior is undefined unless 'index < size()'.
+  void set(std::size_t index, const smisc::Point2D& value);
+
+  // Return the address of the first 'x' coordinate of this array.
+  const double* xs() const;
+
+  // Return the address of the first 'y' coordinate of this array.
+  const double* ys() const;
+
+  // Add the specified 'scale' times the points of the specified 'other' array
+  // to the points of this array. The behavior is undefined unless
+  // 'other.size() == size()'.
+  void addScaled(double scale, const ValueArray& other);
+
+  // Move each point of this array towards the point of the specified 'target'
+  // array at the same index by no more than the specified 'maxDistance'. The
+  // behavior is undefined unless 'target.size() == size()' and
+  // 'maxDistance > 0.0'.
+  void moveTowards(const ValueArray& target, double maxDistance);
+
+  // Replace the points of this array with the points of the specified 'base'
+  // array plus the specified 'scale' times those of the specified 'other'
+  // array at the same index. This array takes the size of 'other', and the
+  // missing points of 'base' are the origin.
+  void setScaledSum(const ValueArray& base,
+                    double scale,
+                    const ValueArray& other);
+
+  // Replace the points of this array with the points of the specified 'from'
+  // array moved towards those of the specified 'target' array at the same
+  // index by no more than the specified 'maxDistance'. This array takes the
+  // size of 'target', and the missing points of 'from' are those of
+  // 'target'. The behavior is undefined unless 'maxDistance > 0.0'.
+  void setMovedTowards(const ValueArray& from,
+                       const ValueArray& target,
+                       double maxDistance);
+
+  // Serialize this array with the specified 'archive'.
+  template <typename Archive>
+  void serialize(Archive& archive, const unsigned int version);
+
+ private:
+  // The coordinates of the points of an array.
+  struct Storage {
+    std::vector<double> xs;
+    std::vector<double> ys;
+  };
+
+  // Make the specified 'size' points of this array no longer shared. The
+  // points that are kept are unspecified and the new ones are the origin.
+  void makeWritable(std::size_t size);
+
+  // The points of this array, shared with its copies, or null if it is
+  // empty.
+  boost::shared_ptr<Storage> m_storage;
+};
+
+// Return 'true' if the specified 'lhs' and 'rhs' arrays have the same values
+// and 'false' otherwise.
+template <typename T>
+bool operator==(const ValueArray<T>& lhs, const ValueArray<T>& rhs);
+
+// Return 'false' if the specified 'lhs' and 'rhs' arrays have the same values
+// and 'true' otherwise.
+template <typename T>
+bool operator!=(const ValueArray<T>& lhs, const ValueArray<T>& rhs);
+
+// A behavior of the values of many entities.
+template <typename T>
+using BehaviorArray = Behavior<ValueArray<T>>;
+
+// This class implements a metafunction returning the type of the values of
+// 'BehaviorArrayUtil::map()'.
+template <typename Function, typename T>
+struct BehaviorArray_MapResult {
+  typedef typename std::decay<
+      typename std::result_of<const Function&(const T&)>::type>::type type;
+};
+
+// This class is a namespace for frp functions that operate on whole arrays.
+// Unless stated otherwise, the result of an operation is undefined unless the
+// arrays of its arguments have the same size at every pull.
+struct BehaviorArrayUtil {
+  // Return a constant behavior whose value is the specified 'values'.
+  template <typename T>
+  static BehaviorArray<T> always(const ValueArray<T>& values);
+
+  // Return a behavior whose elements are the values of the specified
+  // 'behaviors' at the same time. The result is undefined from the first time
+  // at which any of 'behaviors' is undefined.
+  template <typename T>
+  static BehaviorArray<T> fromBehaviors(
+      const std::vector<Behavior<T>>& behaviors);
+
+  // Return a behavior that is the element at the specified 'index' of the
+  // specified 'array'. The result is undefined unless 'index' is less than the
+  // size of the values of 'array'.
+  template <typename T>
+  static Behavior<T> element(const BehaviorArray<T>& array, std::size_t index);
+
+  // Return a behavior whose elements are the results of the specified
+  // 'function' applied to the elements of the specified 'array'.
+  template <typename Function, typename T>
+  static BehaviorArray<typename BehaviorArray_MapResult<Function, T>::type>
+  map(Function function, const BehaviorArray<T>& array);
+
+  // Return a behavior whose elements follow those of the specified 'target'
+  // without exceeding the specified 'maxVelocity', as with
+  // 'NormedVectorSpaceUtil::smooth()'. The result is undefined unless 'T' is a
+  // 'smisc::NormedVectorSpace' and 'maxVelocity' is greater than '0' for all
+  // time values.
+  template <typename T>
+  static BehaviorArray<T> smooth(const Behavior<smisc::Point1D>& maxVelocity,
+                                 const BehaviorArray<T>& target);
+
+  // Return a behavior whose elements are the piece-wise integrals of the
+  // elements of the specified 'array', starting at time '0', as with
+  // 'VectorSpaceUtil::integral()'. The result is undefined unless 'T' is a
+  // 'smisc::VectorSpace'.
+  template <typename T>
+  static BehaviorArray<T> integral(const BehaviorArray<T>& array);
+
+  // Return a behavior whose elements are, at each pull, the sums of the
+  // elements of the specified 'array' at that pull and all previous pulls, as
+  // with 'VectorSpaceUtil::sum()'. The result is undefined unless 'T' is a
+  // 'smisc::VectorSpace'.
+  template <typename T>
+  static BehaviorArray<T> sum(const BehaviorArray<T>& array);
+
+ private:
+  // Add the specified 'state' to the registry of the current
+  // 'BehaviorCheckpointScope', if any.
+  template <typename State>
+  static void addCheckpointState(const boost::shared_ptr<State>& state);
+};
+
+// ===========================================================================
+//                 INLINE DEFINITIONS
+// ===========================================================================
+
+template <typename T>
+ValueArray<T>::ValueArray()
+    : m_values() {}
+
+template <typename T>
+ValueArray<T>::ValueArray(std::size_t size, const T& value)
+    : m_values(size ? boost::make_shared<std::vector<T>>(size, value)
+                    : boost::shared_ptr<std::vector<T>>()) {}
+
+template <typename T>
+std::size_t ValueArray<T>::size() const {
+  return m_values ? m_values->size() : 0;
+}
+
+template <typename T>
+T ValueArray<T>::get(std::size_t index) const {
+  assert(index < size());
+  return (*m_values)[index];
+}
+
+template <typename T>
+void ValueArray<T>::set(std::size_t index, const T& value) {
+  assert(index < size());
+  if (!m_values.unique())
+    m_values = boost::make_shared<std::vector<T>>(*m_values);
+  (*m_values)[index] = value;
+}
+
+template <typename T>
+const T* ValueArray<T>::data() const {
+  return m_values ? m_values->data() : 0;
+}
+
+template <typename T>
+void ValueArray<T>::addScaled(double scale, const ValueArray& other) {
+  assert(other.size() == size());
+  setScaledSum(*this, scale, other);
+}
+
+template <typename T>
+void ValueArray<T>::moveTowards(const ValueArray& target, double maxDistance) {
+  assert(target.size() == size());
+  setMovedTowards(*this, target, maxDistance);
+}
+
+template <typename T>
+void ValueArray<T>::setScaledSum(const ValueArray& base,
+                                 double scale,
+                                 const ValueArray& other) {
+  // The arguments may be, or share their values with, this array. Their
+  // values are kept alive while this array is given new ones.
+  const boost::shared_ptr<std::vector<T>> baseValues = base.m_values;
+  const boost::shared_ptr<std::vector<T>> otherValues = other.m_values;
+  const std::size_t n = otherValues ? otherValues->size() : 0;
+  const std::size_t m = baseValues ? std::min(n, baseValues->size()) : 0;
+  T* const values = writableData(n, smisc::zero<T>());
+  if (n == 0)
+    return;
+  const T* const from = m ? baseValues->data() : 0;
+  const T* const addends = otherValues->data();
+  for (std::size_t i = 0; i < m; ++i)
+    values[i] = from[i] + scale * addends[i];
+  for (std::size_t i = m; i < n; ++i)
+    values[i] = scale * addends[i];
+}
+
+template <typename T>
+void ValueArray<T>::setMovedTowards(const ValueArray& from,
+                                    const ValueArray& target,
+                                    double maxDistance) {
+  assert(maxDistance > 0.0);
+  const boost::shared_ptr<std::vector<T>> fromValues = from.m_values;
+  const boost::shared_ptr<std::vector<T>> targetValues = target.m_values;
+  const std::size_t n = targetValues ? targetValues->size() : 0;
+  const std::size_t m = fromValues ? std::min(n, fromValues->size()) : 0;
+  T* const values = writableData(n, smisc::zero<T>());
+  for (std::size_t i = 0; i < m; ++i) {
+    const T dv = (*targetValues)[i] - (*fromValues)[i];
+    const smisc::Point1D normDv = smisc::norm(dv);
+    values[i] = normDv <= maxDistance
+                    ? (*targetValues)[i]
+                    : (*fromValues)[i] + (maxDistance / normDv) * dv;
+  }
+  for (std::size_t i = m; i < n; ++i)
+    values[i] = (*targetValues)[i];
+}
+
+template <typename T>
+T* ValueArray<T>::writableData(std::size_t size, const T& value) {
+  if (m_values.unique())
+    m_values->resize(size, value);
+  else
+    m_values = boost::make_shared<std::vector<T>>(size, value);
+  return m_values->data();
+}
+
+template <typename T>
+template <typename Archive>
+void ValueArray<T>::serialize(Archive& archive, const unsigned int version) {
+  std::vector<T> values;
+  if (Archive::is_saving::value && m_values)
+    values = *m_values;
+  archive& boost::serialization::make_nvp("values", values);
+  if (Archive::is_loading::value) {
+    m_values = values.empty()
+                   ? boost::shared_ptr<std::vector<T>>()
+                   : boost::make_shared<std::vector<T>>(std::move(values));
+  }
+}
+
+inline ValueArray<smisc::Point2D>::ValueArray()
+    : m_storage() {}
+
+inline ValueArray<smisc::Point2D>::ValueArray(std::size_t size,
+                                              const smisc::Point2D& value)
+    : m_storage() {
+  if (size)
+    m_storage = boost::make_shared<Storage>(
+        Storage{std::vector<double>(size, value.x),
+                std::vector<double>(size, value.y)});
+}
+
+inline std::size_t ValueArray<smisc::Point2D>::size() const {
+  return m_storage ? m_storage->xs.size() : 0;
+}
+
+inline smisc::Point2D ValueArray<smisc::Point2D>::get(
+    std::size_t index) const {
+  assert(index < size());
+  return smisc::Point2D(m_storage->xs[index], m_storage->ys[index]);
+}
+
+inline void ValueArray<smisc::Point2D>::set(std::size_t index,
+                                            const smisc::Point2D& value) {
+  assert(index < size());
+  if (!m_storage.unique())
+    m_storage = boost::make_shared<Storage>(*m_storage);
+  m_storage->xs[index] = value.x;
+  m_storage->ys[index] = value.y;
+}
+
+inline const double* ValueArray<smisc::Point2D>::xs() const {
+  return m_storage ? m_storage->xs.data() : 0;
+}
+
+inline const double* ValueArray<smisc::Point2D>::ys() const {
+  return m_storage ? m_storage->ys.data() : 0;
+}
+
+inline void ValueArray<smisc::Point2D>::addScaled(double scale,
+                                                  const ValueArray& other) {
+  assert(other.size() == size());
+  setScaledSum(*this, scale, other);
+}
+
+inline void ValueArray<smisc::Point2D>::moveTowards(const ValueArray& target,
+                                                    double maxDistance) {
+  assert(target.size() == size());
+  setMovedTowards(*this, target, maxDistance);
+}
+
+inline void ValueArray<smisc::Point2D>::setScaledSum(const ValueArray& base,
+                                                     double scale,
+                                                     const ValueArray& other) {
+  // The arguments may be, or share their points with, this array. Their
+  // points are kept alive while this array is given new ones.
+  const boost::shared_ptr<Storage> baseStorage = base.m_storage;
+  const boost::shared_ptr<Storage> otherStorage = other.m_storage;
+  const std::size_t n = otherStorage ? otherStorage->xs.size() : 0;
+  const std::size_t m = baseStorage ? std::min(n, baseStorage->xs.size()) : 0;
+  makeWritable(n);
+  if (n == 0)
+    return;
+  double* const xs = m_storage->xs.data();
+  double* const ys = m_storage->ys.data();
+  const double* const fromXs = m ? baseStorage->xs.data() : 0;
+  const double* const fromYs = m ? baseStorage->ys.data() : 0;
+  const double* const otherXs = otherStorage->xs.data();
+  const double* const otherYs = otherStorage->ys.data();
+  for (std::size_t i = 0; i < m; ++i)
+    xs[i] = fromXs[i] + scale * otherXs[i];
+  for (std::size_t i = 0; i < m; ++i)
+    ys[i] = fromYs[i] + scale * otherYs[i];
+  for (std::size_t i = m; i < n; ++i) {
+    xs[i] = scale * otherXs[i];
+    ys[i] = scale * otherYs[i];
+  }
+}
+
+inline void ValueArray<smisc::Point2D>::setMovedTowards(
+    const ValueArray& from,
+    const ValueArray& target,
+    double maxDistance) {
+  assert(maxDistance > 0.0);
+  const boost::shared_ptr<Storage> fromStorage = from.m_storage;
+  const boost::shared_ptr<Storage> targetStorage = target.m_storage;
+  const std::size_t n = targetStorage ? targetStorage->xs.size() : 0;
+  const std::size_t m = fromStorage ? std::min(n, fromStorage->xs.size()) : 0;
+  makeWritable(n);
+  if (n == 0)
+    return;
+  double* const xs = m_storage->xs.data();
+  double* const ys = m_storage->ys.data();
+  const double* const fromXs = m ? fromStorage->xs.data() : 0;
+  const double* const fromYs = m ? fromStorage->ys.data() : 0;
+  const double* const targetXs = targetStorage->xs.data();
+  const double* const targetYs = targetStorage->ys.data();
+  const double maxDistanceSquared = maxDistance * maxDistance;
+
+  // The loop selects between both outcomes instead of branching so that it can
+  // be vectorized. Note that the division and square root of points that are
+  // within reach are discarded.
+  for (std::size_t i = 0; i < m; ++i) {
+    const double dx = targetXs[i] - fromXs[i];
+    const double dy = targetYs[i] - fromYs[i];
+    const double distanceSquared = dx * dx + dy * dy;
+    const double scale = maxDistance / std::sqrt(distanceSquared);
+    const double movedX = fromXs[i] + scale * dx;
+    const double movedY = fromYs[i] + scale * dy;
+    const bool reached = distanceSquared <= maxDistanceSquared;
+    xs[i] = reached ? targetXs[i] : movedX;
+    ys[i] = reached ? targetYs[i] : movedY;
+  }
+  for (std::size_t i = m; i < n; ++i) {
+    xs[i] = targetXs[i];
+    ys[i] = targetYs[i];
+  }
+}
+
+inline void ValueArray<smisc::Point2D>::makeWritable(std::size_t size) {
+  if (!m_storage.unique())
+    m_storage = boost::make_shared<Storage>();
+  m_storage->xs.resize(size);
+  m_storage->ys.resize(size);
+}
+
+template <typename Archive>
+void ValueArray<smisc::Point2D>::serialize(Archive& archive,
+                                           const unsigned int version) {
+  Storage storage;
+  if (Archive::is_saving::value && m_storage)
+    storage = *m_storage;
+  archive& boost::serialization::make_nvp("xs", storage.xs);
+  archive& boost::serialization::make_nvp("ys", storage.ys);
+  if (Archive::is_loading::value) {
+    m_storage = storage.xs.empty()
+                    ? boost::shared_ptr<Storage>()
+                    : boost::make_shared<Storage>(std::move(storage));
+  }
+}
+
+template <typename T>
+bool operator==(const ValueArray<T>& lhs, const ValueArray<T>& rhs) {
+  if (lhs.size() != rhs.size())
+    return false;
+  for (std::size_t i = 0; i < lhs.size(); ++i) {
+    if (!(lhs.get(i) == rhs.get(i)))
+      return false;
+  }
+  return true;
+}
+
+inline bool operator==(const ValueArray<smisc::Point2D>& lhs,
+                       const ValueArray<smisc::Point2D>& rhs) {
+  return lhs.size() == rhs.size() &&
+         std::equal(lhs.xs(), lhs.xs() + lhs.size(), rhs.xs()) &&
+         std::equal(lhs.ys(), lhs.ys() + lhs.size(), rhs.ys());
+}
+
+template <typename T>
+bool operator!=(const ValueArray<T>& lhs, const ValueArray<T>& rhs) {
+  return !(lhs == rhs);
+}
+
+template <typename State>
+void BehaviorArrayUtil::addCheckpointState(
+    const boost::shared_ptr<State>& state) {
+  if (BehaviorCheckpoint* const checkpoint = BehaviorCheckpoint::current())
+    checkpoint->addState(state);
+}
+
+template <typename T>
+BehaviorArray<T> BehaviorArrayUtil::always(const ValueArray<T>& values) {
+  return BehaviorArray<T>::fromConstantValue(values);
+}
+
+template <typename T>
+BehaviorArray<T> BehaviorArrayUtil::fromBehaviors(
+    const std::vector<Behavior<T>>& behaviors) {
+  return BehaviorArray<T>::fromValuePullFunc(
+      [behaviors](const double time) -> boost::optional<ValueArray<T>> {
+        if (behaviors.empty())
+          return ValueArray<T>();
+        const T* const first = behaviors[0].pullPointer(time);
+        if (!first)
+          return boost::none;
+        ValueArray<T> result(behaviors.size(), *first);
+        for (std::size_t i = 1; i < behaviors.size(); ++i) {
+          const T* const value = behaviors[i].pullPointer(time);
+          if (!value)
+            return boost::none;
+          result.set(i, *value);
+        }
+        return result;
+      });
+}
+
+template <typename T>
+Behavior<T> BehaviorArrayUtil::element(const BehaviorArray<T>& array,
+                                       std::size_t index) {
+  return Behavior<T>::fromValuePullFunc(
+      [array, index](const double time) -> boost::optional<T> {
+        const ValueArray<T>* const values = array.pullPointer(time);
+        if (!values)
+          return boost::none;
+        return values->get(index);
+      });
+}
+
+template <typename Function, typename T>
+BehaviorArray<typename BehaviorArray_MapResult<Function, T>::type>
+BehaviorArrayUtil::map(Function function, const BehaviorArray<T>& array) {
+  typedef typename BehaviorArray_MapResult<Function, T>::type Result;
+  return BehaviorArray<Result>::fromValuePullFunc(
+      [function, array](const double time)
+          -> boost::optional<ValueArray<Result>> {
+        const ValueArray<T>* const values = array.pullPointer(time);
+        if (!values)
+          return boost::none;
+        if (values->size() == 0)
+          return ValueArray<Result>();
+        ValueArray<Result> result(values->size(), function(values->get(0)));
+        for (std::size_t i = 1; i < values->size(); ++i)
+          result.set(i, function(values->get(i)));
+        return result;
+      });
+}
+
+template <typename T>
+BehaviorArray<T> BehaviorArrayUtil::smooth(
+    const Behavior<smisc::Point1D>& maxVelocity,
+    const BehaviorArray<T>& target) {
+  // The current values and the time of the previous pull. We're using '-1.0'
+  // as a sentinel time to indicate that there was no previous pull.
+  const boost::shared_ptr<std::pair<ValueArray<T>, double>> state =
+      BehaviorGraphArena::makeShared<std::pair<ValueArray<T>, double>>(
+          ValueArray<T>(), -1.0);
+  const boost::shared_ptr<ValueArray<T>> spare =
+      BehaviorGraphArena::makeShared<ValueArray<T>>();
+  addCheckpointState(state);
+  return BehaviorArray<T>::fromValuePullFunc(
+      [state, spare, maxVelocity, target](const double time)
+          -> boost::optional<ValueArray<T>> {
+        const smisc::Point1D* const velocity = maxVelocity.pullPointer(time);
+        const ValueArray<T>* const targetValues = target.pullPointer(time);
+        if (!velocity || !targetValues)
+          return boost::none;
+
+        // When this is the first 'pull', we accept the target values as the
+        // starting values.
+        if (state->second == -1.0) {
+          state->first = *targetValues;
+        } else {
+          spare->setMovedTowards(state->first,
+                                 *targetValues,
+                                 *velocity * (time - state->second));
+          std::swap(state->first, *spare);
+        }
+        state->second = time;
+        return state->first;
+      });
+}
+
+template <typename T>
+BehaviorArray<T> BehaviorArrayUtil::integral(const BehaviorArray<T>& array) {
+  // The integrals and the time of the previous pull, which is '-1.0' before
+  // the first pull.
+  const boost::shared_ptr<std::pair<ValueArray<T>, double>> state =
+      BehaviorGraphArena::makeShared<std::pair<ValueArray<T>, double>>(
+          ValueArray<T>(), -1.0);
+  const boost::shared_ptr<ValueArray<T>> spare =
+      BehaviorGraphArena::makeShared<ValueArray<T>>();
+  addCheckpointState(state);
+  return BehaviorArray<T>::fromValuePullFunc(
+      [state, spare, array](const double time)
+          -> boost::optional<ValueArray<T>> {
+        const ValueArray<T>* const values = array.pullPointer(time);
+        if (!values)
+          return boost::none;
+        const double previousTime = state->second == -1.0 ? 0.0 : state->second;
+        spare->setScaledSum(state->first, time - previousTime, *values);
+        std::swap(state->first, *spare);
+        state->second = time;
+        return state->first;
+      });
+}
+
+template <typename T>
+BehaviorArray<T> BehaviorArrayUtil::sum(const BehaviorArray<T>& array) {
+  // The sums are empty before the first pull.
+  const boost::shared_ptr<ValueArray<T>> state =
+      BehaviorGraphArena::makeShared<ValueArray<T>>();
+  const boost::shared_ptr<ValueArray<T>> spare =
+      BehaviorGraphArena::makeShared<ValueArray<T>>();
+  addCheckpointState(state);
+  return BehaviorArray<T>::fromValuePullFunc(
+      [state, spare, array](const double time)
+          -> boost::optional<ValueArray<T>> {
+        const ValueArray<T>* const values = array.pullPointer(time);
+        if (!values)
+          return boost::none;
+        spare->setScaledSum(*state, 1.0, *values);
+        std::swap(*state, *spare);
+        return *state;
+      });
+}
+}
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef SFRP_BEHAVIORARRAY_T_HPP_
+#define SFRP_BEHAVIORARRAY_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void behaviorarrayTests(stest::TestCollector&);
+}
+#endif
@@ -0,0 +1,197 @@
+#ifndef SFRP_BEHAVIORCHECKPOINT_HPP_
+#define SFRP_BEHAVIORCHECKPOINT_HPP_
+
+//@PURPOSE: Provide checkpoints of the state of behavior graphs.
+//
+//@CLASSES:
+//  sfrp::BehaviorCheckpoint: registry of the state cells of a graph
+//  sfrp::BehaviorCheckpointScope: guard activating a registry on a thread
+//
+//@SEE_ALSO: sfrp_wormhole, smisc_anyserializer
+//
+//@DESCRIPTION: This component provides a class, 'BehaviorCheckpoint', that
+// saves the state of a running graph to a string and restores it into a
+// freshly built identical graph.
+//
+// While a 'BehaviorCheckpointScope' is active on a thread, the stateful nodes
+// created on that thread add their state cells to the registry of the scope,
+// in the order of their creation. These are the data cells of 'Wormhole'
+// objects, and therefore of 'EventUtil::step()' and
+// 'EventUtil::accumulate()', and the flag of
+// 'BehaviorTimeUtil::replaceInitialValue()'. Other stateful behaviors can add
+// their own cells with 'addState()'.
+//
+// 'save()' converts the value of every cell with the 'smisc::AnySerializer'
+// given to it and serializes the resulting list of type identifiers and
+// strings with Boost.Serialization. 'restore()' loads such a string into the
+// cells of another registry, matching the cells by their order. A graph built
+// by the same code within the scope of an empty registry has its cells in the
+// same order, so the restore continues the graph where the saved one was.
+//
+// Caches, such as the 'CachedPull' objects of behaviors, aren't part of a
+// checkpoint. A restored graph recomputes them on its first pull, which
+// should be at a time after the last pull of the saved graph.
+//
+// Some state can't be serialized. The state of 'JoinUtil::join()' is the
+// behavior it switched into, together with the cells of that behavior, which
+// were created during a pull rather than when the graph was built. Such state
+// is added with 'addUnsavableState()'. A checkpoint saved while any such
+// state is set can't be restored: 'restore()' returns 'false' rather than
+// continue a graph whose joins lost the behaviors they switched into.
+//
+// Cells refer weakly to their state, so a registry doesn't extend the lifetime
+// of its graph. The cells of destroyed states are saved empty and skipped by
+// restores.
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: Saving a score
+// - - - - - - - - - - - - -
+// Say 'makeGame' builds a game whose score is kept by 'EventUtil::step()'.
+// The score type must be known to the serializer.
+//..
+//  smisc::AnySerializer serializer;
+//  serializer.registerType<boost::optional<int>>(
+//      "OptionalInt",
+//      smisc::ClassSerializerBoostSerializableUtil::
+//          classSerializerFromSerializable<boost::optional<int>>());
+//
+//  sfrp::BehaviorCheckpoint checkpoint;
+//  sfrp::Behavior<Game> game;
+//  {
+//    sfrp::BehaviorCheckpointScope scope(checkpoint);
+//    game = makeGame(clicks);
+//  }
+//  // ... pull 'game' for a while ...
+//  const std::string saved = checkpoint.save(serializer);
+//..
+// Later, the same game is built again and resumed.
+//..
+//  sfrp::BehaviorCheckpoint restored;
+//  {
+//    sfrp::BehaviorCheckpointScope scope(restored);
+//    game = makeGame(clicks);
+//  }
+//  const bool ok = restored.restore(saved, serializer);
+//  assert(ok);
+//..
+
+#include <boost/any.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <cstddef>  // std::size_t
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace smisc {
+struct AnySerializer;
+}
+
+namespace sfrp {
+
+// This class implements a registry of the state cells of behavior graphs.
+struct BehaviorCheckpoint {
+  // Create a registry without cells.
+  BehaviorCheckpoint();
+
+  BehaviorCheckpoint(const BehaviorCheckpoint&) = delete;
+  BehaviorCheckpoint& operator=(const BehaviorCheckpoint&) = delete;
+
+  // Add a cell whose value is returned by the specified 'save' function and
+  // replaced by the specified 'load' function. 'save' returns an empty
+  // 'boost::any' if the state was destroyed. The behavior is undefined unless
+  // 'load' accepts the values returned by 'save'.
+  void addState(const boost::function<boost::any()>& save,
+                const boost::function<void(const boost::any&)>& load);
+
+  // Add a cell for the value pointed to by the specified 'state'.
+  template <typename T>
+  void addState(const boost::shared_ptr<T>& state);
+
+  // Add a cell for state that can't be saved and for which the specified
+  // 'isSet' function returns 'true' once it is set. Checkpoints saved while
+  // 'isSet()' returns 'true' can't be restored.
+  void addUnsavableState(const boost::function<bool()>& isSet);
+
+  // Return the number of cells of this registry.
+  std::size_t size() const;
+
+  // Return the values of the cells of this registry serialized with the
+  // specified 'serializer'. The behavior is undefined unless 'serializer' has
+  // a serializer for the type of every cell.
+  std::string save(const smisc::AnySerializer& serializer) const;
+
+  // Load the values of the specified 'checkpoint' into the cells of this
+  // registry using the specified 'serializer'. Return 'true' on success. If
+  // 'checkpoint' can't be parsed, its cells don't match the number and types
+  // of those of this registry, or it was saved while unsavable state was set,
+  // return 'false' without changing any cell.
+  bool restore(const std::string& checkpoint,
+               const smisc::AnySerializer& serializer) const;
+
+  // Return the registry of the innermost 'BehaviorCheckpointScope' of the
+  // calling thread or a null pointer if there is no such scope.
+  static BehaviorCheckpoint* current();
+
+ private:
+  friend struct BehaviorCheckpointScope;
+
+  // The value saved by the cells of unsavable state that is set.
+  struct Unsavable {};
+
+  // A state cell.
+  struct Cell {
+    boost::function<boost::any()> save;
+    boost::function<void(const boost::any&)> load;
+  };
+
+  // Return the current registry of the calling thread.
+  static BehaviorCheckpoint*& currentRegistry();
+
+  mutable std::mutex m_mutex;
+  std::vector<Cell> m_cells;
+};
+
+// This class implements a guard that makes a registry the current registry of
+// the calling thread for its lifetime.
+struct BehaviorCheckpointScope {
+  // Make the specified 'checkpoint' the current registry of the calling
+  // thread.
+  explicit BehaviorCheckpointScope(BehaviorCheckpoint& checkpoint);
+
+  // Restore the previous current registry of the calling thread.
+  ~BehaviorCheckpointScope();
+
+  BehaviorCheckpointScope(const BehaviorCheckpointScope&) = delete;
+  BehaviorCheckpointScope& operator=(const BehaviorCheckpointScope&) = delete;
+
+ private:
+  BehaviorCheckpoint* m_previous;
+};
+
+// ===========================================================================
+//                 INLINE DEFINITIONS
+// ===========================================================================
+
+template <typename T>
+void BehaviorCheckpoint::addState(const boost::shared_ptr<T>& state) {
+  const boost::weak_ptr<T> weakState = state;
+  addState([weakState]() {
+             const boost::shared_ptr<T> state = weakState.lock();
+             return state ? boost::any(*state) : boost::any();
+           },
+           [weakState](const boost::any& value) {
+             if (const boost::shared_ptr<T> state = weakState.lock())
+               *state = boost::any_cast<const T&>(value);
+           });
+}
+
+inline BehaviorCheckpoint* BehaviorCheckpoint::current() {
+  return currentRegistry();
+}
+}
+#endif
@@ -0,0 +1,11 @@
+#ifndef SFRP_BEHAVIORCHECKPOINT_T_HPP_
+#define SFRP_BEHAVIORCHECKPOINT_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void behaviorcheckpointTests(stest::TestCollector&);
+}
+#endif
@@ -0,0 +1,230 @@
+#ifndef SFRP_BEHAVIORDRIVER_HPP_
+#define SFRP_BEHAVIORDRIVER_HPP_
+
+//@PURPOSE: Provide a real-time loop that pulls a root behavior.
+//
+//@CLASSES:
+//  sfrp::BehaviorDriver_Histogram: power-of-two histogram of durations
+//  sfrp::BehaviorDriver_Stats: tick statistics of a driver
+//  sfrp::BehaviorDriver: clock owning loop pulling a root behavior
+//
+//@SEE_ALSO: sfrp_behavior, sfrp_incrementalengine, sfrp_triggerutil
+//
+//@DESCRIPTION: This component provides a single class, 'BehaviorDriver', that
+// implements the loop that pulls the root of a behavior graph in real time.
+// The driver owns the clock: the time of a tick is the number of seconds
+// since 'run()' was called, measured with a steady clock, so the first tick
+// is at time '0'. The loop ends when the root is no longer defined or when
+// 'stop()' is called.
+//
+// A driver has one of the following modes.
+//..
+//  e_FIXED_RATE            Tick at every multiple of the period. A missed
+//                          deadline is an overrun and the schedule skips to
+//                          the next deadline in the future.
+//  e_VARIABLE_RATE         Tick when woken, but at least once per period.
+//  e_AS_FAST_AS_POSSIBLE   Tick again as soon as the previous tick finished.
+//..
+// Between ticks the driver sleeps until its next deadline. 'wake()' ends the
+// sleep early and causes an immediate tick. Functions returned by
+// 'wakingFunction()' wake the driver after calling the function they wrap, so
+// wrapping the function of a trigger, see sfrp_triggerutil, makes occurrences
+// take effect immediately instead of at the next deadline without polling.
+//
+// Every tick is recorded into the statistics of the driver, see 'stats()':
+//
+//: o the latency of the tick, the time taken by the pull,
+//:
+//: o the jitter of the tick, the delay between its deadline and its start,
+//:   for ticks that had a deadline, and
+//:
+//: o the number of overruns, ticks that finished after the next deadline.
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: Rendering at 60Hz
+// - - - - - - - - - - - - - - -
+// Say 'drawingBehavior' is a 'sfrp::Behavior<Drawing>' that reacts to mouse
+// clicks through a trigger.
+//..
+//  sfrp::BehaviorDriver driver(sfrp::BehaviorDriver::e_FIXED_RATE, 1.0 / 60);
+//  boost::function<void(const Click&)> onClick =
+//      driver.wakingFunction(clickTrigger.second);
+//  driver.run(drawingBehavior,
+//             [](double time, const Drawing& drawing) { draw(drawing); });
+//..
+// 'run()' returns when 'drawingBehavior' is no longer defined. The loop
+// replaces the hand-written loop of Example 4 of sfrp_behavior. Afterwards
+// 'driver.stats()' tells how many frames missed their deadline.
+
+#include <boost/function.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::uint64_t
+#include <mutex>
+
+namespace sfrp {
+
+// This class implements a histogram of durations whose buckets double in
+// width. Bucket '0' counts durations under one microsecond and bucket 'i'
+// counts durations of at least '2^(i-1)' and less than '2^i' microseconds. The
+// last bucket also counts all longer durations.
+struct BehaviorDriver_Histogram {
+  enum { k_NUM_BUCKETS = 32 };
+
+  // Create an empty histogram.
+  BehaviorDriver_Histogram();
+
+  // Add the specified 'seconds' duration to this histogram.
+  void add(double seconds);
+
+  // Return the number of durations added to this histogram.
+  std::uint64_t count() const;
+
+  // Return the number of durations in the specified 'bucket'. The behavior is
+  // undefined unless 'bucket < k_NUM_BUCKETS'.
+  std::uint64_t bucketCount(std::size_t bucket) const;
+
+  // Return the longest duration added to this histogram in seconds, or '0'
+  // if it is empty.
+  double max() const;
+
+  // Return the mean of the durations added to this histogram in seconds, or
+  // '0' if it is empty.
+  double mean() const;
+
+ private:
+  std::uint64_t m_buckets[k_NUM_BUCKETS];
+  std::uint64_t m_count;
+  double m_sum;
+  double m_max;
+};
+
+// This class implements the statistics of the ticks of a driver.
+struct BehaviorDriver_Stats {
+  // Create statistics without ticks.
+  BehaviorDriver_Stats();
+
+  std::uint64_t numTicks;
+  std::uint64_t numWakeups;   // ticks caused by 'wake()'
+  std::uint64_t numOverruns;  // ticks that finished after the next deadline
+  BehaviorDriver_Histogram latency;
+  BehaviorDriver_Histogram jitter;
+};
+
+// This class implements a loop that pulls a root behavior in real time.
+struct BehaviorDriver {
+  // The ways in which a driver schedules its ticks.
+  enum Mode { e_FIXED_RATE, e_VARIABLE_RATE, e_AS_FAST_AS_POSSIBLE };
+
+  // Create a driver with the specified 'mode' and the specified 'period' in
+  // seconds. The period is ignored in 'e_AS_FAST_AS_POSSIBLE' mode. The
+  // behavior is undefined unless 'period > 0.0' in the other modes.
+  BehaviorDriver(Mode mode, double period);
+
+  BehaviorDriver(const BehaviorDriver&) = delete;
+  BehaviorDriver& operator=(const BehaviorDriver&) = delete;
+
+  // Pull the specified 'root' at every tick and return when it is no longer
+  // defined or 'stop()' is called. 'root' may be any object with a
+  // 'Behavior::pull()' like function, such as a 'Behavior' or an
+  // 'IncrementalEngine'.
+  template <typename Root>
+  void run(Root& root);
+
+  // Pull the specified 'root' at every tick, call the specified 'sink' with
+  // the time and value of each tick, and return when 'root' is no longer
+  // defined or 'stop()' is called. The time spent in 'sink' counts towards
+  // the latency of the tick.
+  template <typename Root, typename Sink>
+  void run(Root& root, Sink sink);
+
+  // Call the specified 'tickFunc' with the time of every tick and return
+  // when it returns 'false' or 'stop()' is called. Statistics are reset when
+  // this function is called.
+  void runTicks(const boost::function<bool(double)>& tickFunc);
+
+  // Cause an immediate tick if the driver is sleeping and otherwise a tick
+  // right after the current one. This function is thread safe.
+  void wake();
+
+  // Make 'run()' return after the current tick. If no run is in progress, the
+  // next run returns after its first tick. This function is thread safe.
+  void stop();
+
+  // Return a function that calls the specified 'function' and then wakes
+  // this driver. The behavior is undefined unless this driver outlives the
+  // result.
+  template <typename T>
+  boost::function<void(const T&)> wakingFunction(
+      boost::function<void(const T&)> function);
+
+  // Return the statistics of the current or last run. This function is
+  // thread safe.
+  BehaviorDriver_Stats stats() const;
+
+ private:
+  typedef std::chrono::steady_clock Clock;
+
+  // Wait until the specified 'deadline', 'wake()' or 'stop()', whichever
+  // comes first. Return 'true' if this driver was woken and 'false'
+  // otherwise.
+  bool sleepUntil(Clock::time_point deadline);
+
+  Mode m_mode;
+  Clock::duration m_period;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_wakeup;
+  bool m_woken;
+  bool m_stopped;
+  BehaviorDriver_Stats m_stats;
+};
+
+// ===========================================================================
+//                 INLINE DEFINITIONS
+// ===========================================================================
+
+inline std::uint64_t BehaviorDriver_Histogram::count() const {
+  return m_count;
+}
+
+inline std::uint64_t BehaviorDriver_Histogram::bucketCount(
+    std::size_t bucket) const {
+  return m_buckets[bucket];
+}
+
+inline double BehaviorDriver_Histogram::max() const { return m_max; }
+
+inline double BehaviorDriver_Histogram::mean() const {
+  return m_count ? m_sum / m_count : 0.0;
+}
+
+template <typename Root>
+void BehaviorDriver::run(Root& root) {
+  runTicks([&root](double time) { return bool(root.pull(time)); });
+}
+
+template <typename Root, typename Sink>
+void BehaviorDriver::run(Root& root, Sink sink) {
+  runTicks([&root, &sink](double time) {
+    const auto value = root.pull(time);
+    if (!value)
+      return false;
+    sink(time, *value);
+    return true;
+  });
+}
+
+template <typename T>
+boost::function<void(const T&)> BehaviorDriver::wakingFunction(
+    boost::function<void(const T&)> function) {
+  return [this, function](const T& t) {
+    function(t);
+    wake();
+  };
+}
+}
+#endif
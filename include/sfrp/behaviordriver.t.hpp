@@ -0,0 +1,11 @@
+#ifndef SFRP_BEHAVIORDRIVER_T_HPP_
+#define SFRP_BEHAVIORDRIVER_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void behaviordriverTests(stest::TestCollector&);
+}
+#endif
@@ -0,0 +1,324 @@
+#ifndef SFRP_BEHAVIORGRAPHARENA_HPP_
+#define SFRP_BEHAVIORGRAPHARENA_HPP_
+
+//@PURPOSE: Provide a scoped arena from which behavior graph nodes allocate.
+//
+//@CLASSES:
+//  sfrp::BehaviorGraphArena: memory arena for behavior nodes
+//  sfrp::BehaviorGraphArenaAllocator: standard allocator using an arena
+//  sfrp::BehaviorGraphArenaScope: guard that makes an arena current
+//
+//@SEE_ALSO: sfrp_behavior, sfrp_joinutil
+//
+//@DESCRIPTION: This component provides a memory arena, 'BehaviorGraphArena',
+// that the sfrp combinators use to allocate the nodes of a behavior graph.
+//
+// By default every node of a behavior graph, and the shared state of
+// wormholes and joins, is allocated separately on the heap. Building a large
+// graph then fragments the heap and scatters nodes that are pulled together
+// across unrelated cache lines. When a 'BehaviorGraphArenaScope' is active on
+// a thread, the combinators instead place their nodes one after another in
+// the blocks of the scope's arena.
+//
+// By default an arena is monotonic: individual nodes never give their memory
+// back. All the memory of an arena is released in one step once the arena
+// object and every node allocated from it have been destroyed. Nodes hold a
+// reference to the memory of their arena so it is safe for a behavior to
+// outlive the arena object it was built in. Monotonic arenas are therefore
+// best suited to sub-graphs that are built together and discarded together,
+// such as the behaviors produced by the argument of 'JoinUtil::join()'.
+//
+// An arena is not thread safe. A single arena must only be used by a single
+// thread at a time. Nodes that were allocated from an arena, however, may be
+// pulled and destroyed from any thread.
+//
+// Recycling Arenas
+// ----------------
+// An arena created with 'e_RECYCLING' keeps the memory of destroyed nodes in
+// free lists, one per size class of 16 bytes up to 512 bytes, and reuses it
+// for the next nodes of the same size class. The memory of larger and
+// over-aligned nodes is kept in free lists of their exact size and alignment
+// instead. A sub-graph that is repeatedly discarded and rebuilt with the same
+// shape, like the switched behaviors of 'JoinUtil::join()', then stops
+// allocating from the heap once the arena has grown to hold it. The free
+// lists are protected by a mutex so that nodes may still be destroyed from
+// any thread.
+//
+// Note that only the nodes themselves, and the pull functions of the
+// combinators that create them with 'makeFunction()', are placed in the
+// arena. Other pull functions whose state is too large to be stored inline
+// within a 'boost::function' still allocate that state separately.
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: Building a sub-graph in an arena
+// - - - - - - - - - - - - - - - - - - - - - -
+// The following function builds a small graph. All of its nodes are allocated
+// contiguously from a single arena.
+//..
+//  sfrp::Behavior<double> buildSubGraph(double offset) {
+//    sfrp::BehaviorGraphArena arena;
+//    sfrp::BehaviorGraphArenaScope scope(arena);
+//    return sfrp::BehaviorUtil::map([offset](double t) { return t + offset; },
+//                                   sfrp::BehaviorUtil::time());
+//  }
+//..
+// The memory of the arena is released when the returned behavior is
+// destroyed.
+
+#include <boost/function.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/shared_ptr.hpp>
+#include <sfrp/graphpointer.hpp>
+#include <cstddef>  // std::size_t
+#include <map>
+#include <memory>   // std::unique_ptr
+#include <mutex>
+#include <utility>  // std::forward, std::pair
+#include <vector>
+
+namespace sfrp {
+
+// This class implements the blocks of memory shared by an arena and the nodes
+// allocated from it.
+struct BehaviorGraphArena_Storage {
+  enum { k_SIZE_CLASS = 16, k_NUM_SIZE_CLASSES = 32 };
+
+  // Create a storage object that allocates blocks of the specified
+  // 'blockSize' bytes and, if the specified 'recycling' is 'true', reuses
+  // deallocated memory.
+  BehaviorGraphArena_Storage(std::size_t blockSize, bool recycling);
+
+  // Return a pointer to the specified 'size' bytes aligned to the specified
+  // 'alignment'. The behavior is undefined unless 'alignment' is a power of
+  // two.
+  void* allocate(std::size_t size, std::size_t alignment);
+
+  // Return the specified 'p', which was allocated with the specified 'size'
+  // and 'alignment', to the free lists of this storage if it is recycling.
+  void deallocate(void* p, std::size_t size, std::size_t alignment);
+
+  // Return the index of the free list of allocations of the specified 'size'
+  // and 'alignment' or 'k_NUM_SIZE_CLASSES' if they aren't recycled.
+  std::size_t sizeClass(std::size_t size, std::size_t alignment) const;
+
+  // Return a pointer to the specified 'size' bytes aligned to the specified
+  // 'alignment' from the blocks of this storage.
+  void* allocateFromBlocks(std::size_t size, std::size_t alignment);
+
+  std::size_t m_blockSize;
+  bool m_recycling;
+  std::vector<std::unique_ptr<char[]>> m_blocks;
+  char* m_next;
+  char* m_end;
+  std::mutex m_mutex;
+  void* m_freeLists[k_NUM_SIZE_CLASSES];
+
+  // The free memory of allocations outside of the size classes, by size and
+  // alignment.
+  std::map<std::pair<std::size_t, std::size_t>, std::vector<void*>>
+      m_largeFreeLists;
+};
+
+// This class implements a memory arena for behavior graph nodes that is either
+// monotonic, releasing its memory only once it and all of its nodes are
+// destroyed, or recycling, reusing the memory of destroyed nodes.
+struct BehaviorGraphArena {
+  // The reuse of the memory of destroyed nodes.
+  enum Recycling {
+    e_MONOTONIC,  // memory is released with the arena only
+    e_RECYCLING   // memory of destroyed nodes is reused
+  };
+
+  // Create an arena that allocates memory in blocks of the specified
+  // 'blockSize' bytes and reuses the memory of destroyed nodes according to
+  // the specified 'recycling'.
+  explicit BehaviorGraphArena(std::size_t blockSize = 4096,
+                              Recycling recycling = e_MONOTONIC);
+
+  BehaviorGraphArena(const BehaviorGraphArena&) = delete;
+  BehaviorGraphArena& operator=(const BehaviorGraphArena&) = delete;
+
+  // Return a pointer to the specified 'size' bytes aligned to the specified
+  // 'alignment'. The memory is released when this arena and all nodes
+  // allocated from it have been destroyed. The behavior is undefined unless
+  // 'alignment' is a power of two.
+  void* allocate(std::size_t size, std::size_t alignment);
+
+  // Give the specified 'p', which was returned by 'allocate()' with the
+  // specified 'size' and 'alignment', back to this arena. Do nothing unless
+  // this arena is recycling.
+  void deallocate(void* p, std::size_t size, std::size_t alignment);
+
+  // Return the number of blocks that have been allocated by this arena.
+  std::size_t numBlocks() const;
+
+  // Return the arena of the innermost 'BehaviorGraphArenaScope' of the
+  // current thread or '0' if there is none.
+  static BehaviorGraphArena* current();
+
+  // Return a shared pointer to a new 'T' object constructed with the
+  // specified 'args'. The object is allocated from the current arena if there
+  // is one and from the heap otherwise.
+  template <typename T, typename... Args>
+  static boost::shared_ptr<T> makeShared(Args&&... args);
+
+  // Return a graph pointer to a new 'T' object constructed with the specified
+  // 'args' (see sfrp_graphpointer). The object is allocated from the current
+  // arena if there is one and from the heap otherwise.
+  template <typename T, typename... Args>
+  static GraphPointer<T> makeGraphPointer(Args&&... args);
+
+  // Return a function object of the specified 'Signature' that wraps the
+  // specified 'functor'. If 'functor' doesn't fit within the function object,
+  // it is allocated from the current arena if there is one and from the heap
+  // otherwise.
+  template <typename Signature, typename Functor>
+  static boost::function<Signature> makeFunction(Functor functor);
+
+ private:
+  template <typename T>
+  friend struct BehaviorGraphArenaAllocator;
+
+  boost::shared_ptr<BehaviorGraphArena_Storage> m_storage;
+};
+
+// This class implements a standard allocator that allocates from a
+// 'BehaviorGraphArena'. Deallocation is a no-op unless the arena is
+// recycling. Copies of the allocator keep the memory of the arena alive.
+template <typename T>
+struct BehaviorGraphArenaAllocator {
+  typedef T value_type;
+
+  template <typename U>
+  struct rebind {
+    typedef BehaviorGraphArenaAllocator<U> other;
+  };
+
+  // Create an allocator that allocates from the specified 'arena'.
+  explicit BehaviorGraphArenaAllocator(const BehaviorGraphArena& arena);
+
+  // Create an allocator that allocates from the same arena as the specified
+  // 'other' allocator.
+  template <typename U>
+  BehaviorGraphArenaAllocator(const BehaviorGraphArenaAllocator<U>& other);
+
+  // Return memory for the specified 'n' 'T' objects.
+  T* allocate(std::size_t n);
+
+  // Give the memory of the specified 'n' 'T' objects at the specified 'p'
+  // back to the arena, which reuses it if it is recycling.
+  void deallocate(T* p, std::size_t n);
+
+ private:
+  template <typename U>
+  friend struct BehaviorGraphArenaAllocator;
+
+  template <typename A, typename B>
+  friend bool operator==(const BehaviorGraphArenaAllocator<A>& lhs,
+                         const BehaviorGraphArenaAllocator<B>& rhs);
+
+  boost::shared_ptr<BehaviorGraphArena_Storage> m_storage;
+};
+
+// Return 'true' if the specified 'lhs' and 'rhs' allocate from the same arena.
+template <typename A, typename B>
+bool operator==(const BehaviorGraphArenaAllocator<A>& lhs,
+                const BehaviorGraphArenaAllocator<B>& rhs);
+
+// Return 'true' if the specified 'lhs' and 'rhs' allocate from different
+// arenas.
+template <typename A, typename B>
+bool operator!=(const BehaviorGraphArenaAllocator<A>& lhs,
+                const BehaviorGraphArenaAllocator<B>& rhs);
+
+// This class implements a guard that makes an arena the current arena of the
+// calling thread for its lifetime.
+struct BehaviorGraphArenaScope {
+  // Make the specified 'arena' the current arena of the calling thread.
+  explicit BehaviorGraphArenaScope(BehaviorGraphArena& arena);
+
+  // Restore the arena that was current when this object was created.
+  ~BehaviorGraphArenaScope();
+
+  BehaviorGraphArenaScope(const BehaviorGraphArenaScope&) = delete;
+  BehaviorGraphArenaScope& operator=(const BehaviorGraphArenaScope&) = delete;
+
+ private:
+  BehaviorGraphArena* m_previous;
+};
+
+// ===========================================================================
+//                 INLINE DEFINITIONS
+// ===========================================================================
+
+template <typename T, typename... Args>
+boost::shared_ptr<T> BehaviorGraphArena::makeShared(Args&&... args) {
+  if (BehaviorGraphArena* const arena = current())
+    return boost::allocate_shared<T>(BehaviorGraphArenaAllocator<T>(*arena),
+                                     std::forward<Args>(args)...);
+  else
+    return boost::make_shared<T>(std::forward<Args>(args)...);
+}
+
+template <typename T, typename... Args>
+GraphPointer<T> BehaviorGraphArena::makeGraphPointer(Args&&... args) {
+#ifdef SFRP_SINGLE_THREADED
+  if (BehaviorGraphArena* const arena = current())
+    return boost::allocate_local_shared<T>(
+        BehaviorGraphArenaAllocator<T>(*arena), std::forward<Args>(args)...);
+  else
+    return boost::make_local_shared<T>(std::forward<Args>(args)...);
+#else
+  return makeShared<T>(std::forward<Args>(args)...);
+#endif
+}
+
+template <typename Signature, typename Functor>
+boost::function<Signature> BehaviorGraphArena::makeFunction(Functor functor) {
+  boost::function<Signature> result;
+  if (BehaviorGraphArena* const arena = current())
+    result.assign(std::move(functor),
+                  BehaviorGraphArenaAllocator<char>(*arena));
+  else
+    result = std::move(functor);
+  return result;
+}
+
+template <typename T>
+BehaviorGraphArenaAllocator<T>::BehaviorGraphArenaAllocator(
+    const BehaviorGraphArena& arena)
+    : m_storage(arena.m_storage) {}
+
+template <typename T>
+template <typename U>
+BehaviorGraphArenaAllocator<T>::BehaviorGraphArenaAllocator(
+    const BehaviorGraphArenaAllocator<U>& other)
+    : m_storage(other.m_storage) {}
+
+template <typename T>
+T* BehaviorGraphArenaAllocator<T>::allocate(std::size_t n) {
+  return static_cast<T*>(m_storage->allocate(n * sizeof(T), alignof(T)));
+}
+
+template <typename T>
+void BehaviorGraphArenaAllocator<T>::deallocate(T* p, std::size_t n) {
+  if (m_storage->m_recycling)
+    m_storage->deallocate(p, n * sizeof(T), alignof(T));
+}
+
+template <typename A, typename B>
+bool operator==(const BehaviorGraphArenaAllocator<A>& lhs,
+                const BehaviorGraphArenaAllocator<B>& rhs) {
+  return lhs.m_storage == rhs.m_storage;
+}
+
+template <typename A, typename B>
+bool operator!=(const BehaviorGraphArenaAllocator<A>& lhs,
+                const BehaviorGraphArenaAllocator<B>& rhs) {
+  return !(lhs == rhs);
+}
+}
+#endif
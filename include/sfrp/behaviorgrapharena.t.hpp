@@ -0,0 +1,11 @@
+#ifndef SFRP_BEHAVIORGRAPHARENA_T_HPP_
+#define SFRP_BEHAVIORGRAPHARENA_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void behaviorgrapharenaTests(stest::TestCollector&);
+}
+#endif
@@ -0,0 +1,203 @@
+#ifndef SFRP_BEHAVIORHASHCONS_HPP_
+#define SFRP_BEHAVIORHASHCONS_HPP_
+
+//@PURPOSE: Provide sharing of identical behavior map nodes.
+//
+//@CLASSES:
+//  sfrp::BehaviorHashCons: table of shared behavior nodes
+//  sfrp::BehaviorHashCons_Key: function and argument identity of a node
+//  sfrp::BehaviorHashCons_KeyHash: hash functor for 'BehaviorHashCons_Key'
+//  sfrp::BehaviorHashCons_FunctionIdentity: function identity metafunction
+//  sfrp::BehaviorHashConsScope: guard activating a table on a thread
+//
+//@SEE_ALSO: sfrp_behaviormap, sfrp_behaviornode
+//
+//@DESCRIPTION: This component provides a class, 'BehaviorHashCons', that
+// implements hash-consing of behavior graph nodes. While a
+// 'BehaviorHashConsScope' is active on a thread, 'BehaviorMap' looks up the
+// function and argument nodes of every mapping it creates in the table of the
+// scope. If an equal mapping was created before and its node is still alive,
+// that node is returned instead of a new one. Duplicated subexpressions of a
+// graph then share a single node which, thanks to its cache, is evaluated once
+// per time. Operators implemented with 'BehaviorMap', such as those of
+// sfrp_behavioroperators, are shared in the same way.
+//
+// Two mappings are equal when their functions have the same identity, their
+// arguments are the same nodes and they were created by 'BehaviorMap' objects
+// that are both distinct or both not, and that pull their arguments on the
+// same pool, if any. A shared node is therefore never reconfigured by the
+// mappings that find it. Function identity is defined by
+// 'BehaviorHashCons_FunctionIdentity'.
+//..
+//  Function pointers   The identity is the address of the function.
+//  Empty classes       The identity is the type, for example of a lambda
+//                      without captures or a standard function object.
+//  Other types         There is no identity and the mapping is never shared.
+//..
+// Mappings with arguments that aren't 'Behavior' objects, such as static
+// behaviors, are never shared.
+//
+// The table holds weak references to its nodes, so it doesn't extend their
+// lifetimes. 'purge()' removes the entries of destroyed nodes.
+//
+// Sharing assumes that the mapped functions are plain functions of their
+// arguments, as 'BehaviorMap' does, and that the shared nodes are pulled at
+// the same times by all of their dependents. Behaviors that are pulled at
+// different local times, for instance within the switched behaviors of
+// 'JoinUtil::join()', must not be created within the same scope as the
+// behaviors they are switched from.
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: Sharing a generated subexpression
+// - - - - - - - - - - - - - - - - - - - - - -
+// Say a code generator emits the same distance computation twice.
+//..
+//  sfrp::BehaviorHashCons table;
+//  sfrp::BehaviorHashConsScope scope(table);
+//  const auto distance = [](double x, double y) {
+//    return std::sqrt(x * x + y * y);
+//  };
+//  sfrp::Behavior<double> d1 = sfrp::BehaviorMap()(distance, x, y);
+//  sfrp::Behavior<double> d2 = sfrp::BehaviorMap()(distance, x, y);
+//  assert(d1.node() == d2.node());
+//..
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <cstddef>  // std::size_t
+#include <mutex>
+#include <type_traits>  // std::is_empty
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace sfrp {
+
+struct BehaviorNode;
+struct PullThreadPool;
+
+// This class implements the identity of a behavior map node, which is the
+// identity of its function, the addresses of its argument nodes and the
+// configuration of the 'BehaviorMap' that created it.
+struct BehaviorHashCons_Key {
+  // Create a key without a function or arguments of a sequential mapping
+  // that isn't distinct.
+  BehaviorHashCons_Key();
+
+  // Return 'true' if this key has the same function identity, argument nodes
+  // and configuration as the specified 'other' key and 'false' otherwise.
+  bool operator==(const BehaviorHashCons_Key& other) const;
+
+  const std::type_info* functionType;
+  void (*functionPointer)();
+  std::vector<const BehaviorNode*> argumentNodes;
+  bool distinct;
+  const PullThreadPool* pool;
+};
+
+// This class implements a hash functor for 'BehaviorHashCons_Key' objects.
+struct BehaviorHashCons_KeyHash {
+  std::size_t operator()(const BehaviorHashCons_Key& key) const;
+};
+
+// This class implements a metafunction that loads the identity of functions
+// of the specified 'Function' type into keys. Empty classes are identified by
+// their type.
+template <typename Function>
+struct BehaviorHashCons_FunctionIdentity {
+  // Load the identity of the specified 'function' into the specified 'key'.
+  // Return 'true' if 'Function' has an identity and 'false' otherwise.
+  static bool load(const Function& function, BehaviorHashCons_Key* key);
+};
+
+template <typename Result, typename... Args>
+struct BehaviorHashCons_FunctionIdentity<Result (*)(Args...)> {
+  static bool load(Result (*function)(Args...), BehaviorHashCons_Key* key);
+};
+
+// This class implements a table of behavior map nodes indexed by their
+// function and argument identity.
+struct BehaviorHashCons {
+  // Create an empty table.
+  BehaviorHashCons();
+
+  BehaviorHashCons(const BehaviorHashCons&) = delete;
+  BehaviorHashCons& operator=(const BehaviorHashCons&) = delete;
+
+  // Return the node stored with the specified 'key' if it is still alive and
+  // a null pointer otherwise.
+  boost::shared_ptr<BehaviorNode> find(const BehaviorHashCons_Key& key) const;
+
+  // Store the specified 'node' with the specified 'key', replacing any node
+  // previously stored with 'key'.
+  void insert(const BehaviorHashCons_Key& key,
+              const boost::shared_ptr<BehaviorNode>& node);
+
+  // Remove the entries of nodes that were destroyed.
+  void purge();
+
+  // Return the number of entries of this table, including those of destroyed
+  // nodes that weren't purged.
+  std::size_t size() const;
+
+  // Return the table of the innermost 'BehaviorHashConsScope' of the calling
+  // thread or a null pointer if there is no such scope.
+  static BehaviorHashCons* current();
+
+ private:
+  friend struct BehaviorHashConsScope;
+
+  // Return the current table of the calling thread.
+  static BehaviorHashCons*& currentTable();
+
+  mutable std::mutex m_mutex;
+  std::unordered_map<BehaviorHashCons_Key,
+                     boost::weak_ptr<BehaviorNode>,
+                     BehaviorHashCons_KeyHash> m_nodes;
+};
+
+// This class implements a guard that makes a table the current table of the
+// calling thread for its lifetime.
+struct BehaviorHashConsScope {
+  // Make the specified 'table' the current table of the calling thread.
+  explicit BehaviorHashConsScope(BehaviorHashCons& table);
+
+  // Restore the previous current table of the calling thread.
+  ~BehaviorHashConsScope();
+
+  BehaviorHashConsScope(const BehaviorHashConsScope&) = delete;
+  BehaviorHashConsScope& operator=(const BehaviorHashConsScope&) = delete;
+
+ private:
+  BehaviorHashCons* m_previous;
+};
+
+// ===========================================================================
+//                 INLINE DEFINITIONS
+// ===========================================================================
+
+template <typename Function>
+bool BehaviorHashCons_FunctionIdentity<Function>::load(
+    const Function& function,
+    BehaviorHashCons_Key* key) {
+  if (!std::is_empty<Function>::value)
+    return false;
+  key->functionType = &typeid(Function);
+  return true;
+}
+
+template <typename Result, typename... Args>
+bool BehaviorHashCons_FunctionIdentity<Result (*)(Args...)>::load(
+    Result (*function)(Args...),
+    BehaviorHashCons_Key* key) {
+  key->functionType = &typeid(function);
+  key->functionPointer = reinterpret_cast<void (*)()>(function);
+  return true;
+}
+
+inline BehaviorHashCons* BehaviorHashCons::current() { return currentTable(); }
+}
+#endif
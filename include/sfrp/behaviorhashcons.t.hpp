@@ -0,0 +1,11 @@
+#ifndef SFRP_BEHAVIORHASHCONS_T_HPP_
+#define SFRP_BEHAVIORHASHCONS_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void behaviorhashconsTests(stest::TestCollector&);
+}
+#endif
@@ -5,6 +5,7 @@
 //
 //@CLASSES:
 //  sfrp::BehaviorMap: apply function to behaviors functor
+//  sfrp::BehaviorMap_Distinct: apply function to behaviors, distinct results
 //
 //@DESCRIPTION: This component provides a single functor class, 'BehaviorMap',
 // that applies a plain function to behaviors. For instance, if we have a
@@ -101,15 +102,112 @@
 // The function argument to 'BehaviorMap()' need no be an anonymous function.
 // It can indeed be a function pointor or a functor with a 'const' 'operator()'
 // function.
+//
+// The function is assumed to be a plain function of its arguments, so the
+// result of 'BehaviorMap' is pure whenever all of its argument behaviors are
+// pure. A pure result is evaluated by evaluating its arguments, see
+// 'Behavior::evaluate()'. For the same reason, when all of the
+// arguments are 'Behavior' objects the result is a derived node that is only
+// re-evaluated by an 'IncrementalEngine' when one of its arguments changes.
+// When all of the arguments are constant 'Behavior' objects, such as those
+// created with 'BehaviorUtil::always()', the function is applied once when the
+// mapping is created and the result is a constant behavior. See
+// 'Behavior::isConstant()'. A mapping of a function without arguments is
+// neither pure nor derived and is applied at every pull.
+//
+// When every argument reports its changes, see
+// 'BehaviorNode::reportsChanges()', the result reuses its previous value at
+// pulls where none of the arguments changed and the function is not applied.
+// This is the case for arguments created with 'EventUtil::step()', constant
+// arguments and mappings of such arguments.
+//..
+//  sfrp::Behavior<Mesh> mesh = sfrp::BehaviorMap()(
+//      &buildTerrainMesh,
+//      sfrp::EventUtil::step(initialSettings, settingsEdits));
+//..
+// 'buildTerrainMesh' is applied once per occurrence of 'settingsEdits' rather
+// than at every pull of 'mesh'.
+//
+// Arguments that change at every pull but often have the same value, such as
+// a quantization of a continuous behavior, can be made to report their
+// changes with 'BehaviorUtil::distinct()'. Similarly, a 'BehaviorMap' returned
+// by 'distinct()' creates results that compare each of their values with the
+// previous one, so that their own dependents reuse their values whenever the
+// function yields an unchanged value.
+//..
+//  sfrp::Behavior<int> cell = sfrp::BehaviorMap().distinct()(
+//      [](double x) { return int(std::floor(x / cellSize)); },
+//      positionX);
+//  sfrp::Behavior<Mesh> neighborhood =
+//      sfrp::BehaviorMap()(&buildNeighborhoodMesh, cell);
+//..
+// 'buildNeighborhoodMesh' is applied only when 'cell' changes. Values are
+// compared with 'operator==', see sfrp_cachedincreasingpartialtimefunction,
+// and a distinct mapping to a type without one doesn't compile.
+//
+// Example 2: Pulling arguments in parallel
+// - - - - - - - - - - - - - - - - - - - -
+// When the arguments of a mapping are expensive and independent of one
+// another, a 'BehaviorMap' created with a 'PullThreadPool' pulls them
+// concurrently.
+//..
+//  sfrp::PullThreadPool pool;
+//  sfrp::Behavior<Scene> scene = sfrp::BehaviorMap(pool)(
+//      [](const Mesh& terrain, const Mesh& water) {
+//        return Scene(terrain, water);
+//      },
+//      terrainBehavior, waterBehavior);
+//..
+// Nodes shared by the arguments are still evaluated once per time. The
+// arguments must not interact through wormholes, and 'pullBatch()' of the
+// result pulls its arguments sequentially. See sfrp_mapvaluepullfunc.
+//
+// Example 3: Sharing duplicated mappings
+// - - - - - - - - - - - - - - - - - - -
+// Within a 'BehaviorHashConsScope', mappings of the same function over the
+// same argument behaviors share a single node. See sfrp_behaviorhashcons.
+//..
+//  sfrp::BehaviorHashCons table;
+//  sfrp::BehaviorHashConsScope scope(table);
+//  sfrp::Behavior<int> a = addBehaviors(x, y);
+//  sfrp::Behavior<int> b = addBehaviors(x, y);
+//  assert(a.node() == b.node());
+//..
 
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
 #include <sfrp/behavior.hpp>
+#include <sfrp/behaviorgrapharena.hpp>
+#include <sfrp/behaviorhashcons.hpp>
+#include <sfrp/cachedincreasingpartialtimefunction.hpp>
 #include <sfrp/mapvaluepullfunc.hpp>
+#include <sfrp/pullthreadpool.hpp>
+#include <algorithm>  // std::all_of
+#include <cstdint>    // std::uint64_t
+#include <vector>
 
 namespace sfrp {
 
+struct BehaviorMap_Distinct;
+
 // This class implements a functor that applies a function to the values within
 // one or more behaviors, resulting in a new behavior.
 struct BehaviorMap {
+  // Create a 'BehaviorMap' that creates behaviors that pull their arguments
+  // sequentially.
+  BehaviorMap();
+
+  // Create a 'BehaviorMap' that creates behaviors that pull their arguments
+  // concurrently on the specified 'pool'. The behavior is undefined unless
+  // 'pool' outlives the created behaviors.
+  explicit BehaviorMap(PullThreadPool& pool);
+
+  // Return a functor that creates the same behaviors as this one, except
+  // that they are distinct: they keep their previous value and value version
+  // whenever the function yields an equal value. See
+  // 'Behavior::setDistinct()'.
+  BehaviorMap_Distinct distinct() const;
+
   // Return the result type of applying this functor with the specified
   // 'FunctorApplicationExpression'.
   template <typename FunctorApplicationExpression>
@@ -118,7 +216,10 @@ struct BehaviorMap {
   // Return a behavior that, for any time 't', is defined to be the specified
   // 'function' applied to the specified 'argBehaviors' behaviors at time 't'.
   // If any of 'argBehaviors' is not defined at time 't', then neither is the
-  // result behavior.
+  // result behavior. If all of 'argBehaviors' are constant, 'function' is
+  // applied once and a constant behavior is returned. Within a
+  // 'BehaviorHashConsScope' the node of an equal, previous mapping may be
+  // returned.
   //
   // The behavior is undefined unless the specified 'Function' meets the
   // 'Deferred Callable Object' concept of Boost.Fusion.
@@ -126,6 +227,34 @@ struct BehaviorMap {
   typename result<BehaviorMap(Function, ArgBehaviors...)>::type operator()(
       Function function,
       ArgBehaviors... argBehaviors) const;
+
+ private:
+  PullThreadPool* m_pool;
+  bool m_distinct;
+};
+
+// This class implements a functor that applies a function to the values within
+// one or more behaviors, resulting in a new, distinct behavior. See
+// 'BehaviorMap::distinct()'.
+struct BehaviorMap_Distinct {
+  // Create a functor that creates the behaviors of the specified 'map'. The
+  // behavior is undefined unless 'map' was returned by 'distinct()'.
+  explicit BehaviorMap_Distinct(const BehaviorMap& map);
+
+  // Return the result type of applying this functor with the specified
+  // 'FunctorApplicationExpression'.
+  template <typename FunctorApplicationExpression>
+  struct result;
+
+  // Return the behavior that 'BehaviorMap' returns for the specified
+  // 'function' and 'argBehaviors', made distinct. The result value type must
+  // have an 'operator=='.
+  template <typename Function, typename... ArgBehaviors>
+  typename result<BehaviorMap_Distinct(Function, ArgBehaviors...)>::type
+  operator()(Function function, ArgBehaviors... argBehaviors) const;
+
+ private:
+  BehaviorMap m_map;
 };
 
 // ===========================================================================
@@ -140,13 +269,101 @@ struct BehaviorMap::result<BehaviorMap(Function, ArgBehaviors...)> {
   typedef sfrp::Behavior<BehaviorValue> type;
 };
 
+template <typename Function, typename... ArgBehaviors>
+struct BehaviorMap_Distinct::result<
+    BehaviorMap_Distinct(Function, ArgBehaviors...)>
+    : BehaviorMap::result<BehaviorMap(Function, ArgBehaviors...)> {};
+
+inline BehaviorMap_Distinct::BehaviorMap_Distinct(const BehaviorMap& map)
+    : m_map(map) {}
+
+template <typename Function, typename... ArgBehaviors>
+typename BehaviorMap_Distinct::result<
+    BehaviorMap_Distinct(Function, ArgBehaviors...)>::type
+BehaviorMap_Distinct::
+operator()(Function function, ArgBehaviors... argBehaviors) const {
+  typedef typename result<BehaviorMap_Distinct(Function, ArgBehaviors...)>::
+      BehaviorValue Value;
+  static_assert(
+      CachedIncreasingPartialTimeFunction_ValueComparison<Value>::comparable(),
+      "distinct behaviors need values with an 'operator=='");
+  return m_map(function, argBehaviors...);
+}
+
 template <typename Function, typename... ArgBehaviors>
 typename BehaviorMap::result<BehaviorMap(Function, ArgBehaviors...)>::type
 BehaviorMap::
 operator()(Function function, ArgBehaviors... argBehaviors) const {
   typedef result<BehaviorMap(Function, ArgBehaviors...)>::type Result;
-  return Result::fromValuePullFunc(
-      MapValuePullFunc<Function, ArgBehaviors...>(function, argBehaviors...));
+  typedef MapValuePullFunc<Function, ArgBehaviors...> PullFunc;
+  // The pull and evaluation functions and the reuse hint of the result share
+  // a single pull function object, so that its arguments and batch buffers
+  // aren't copied and are released once the result is no longer defined.
+  const boost::shared_ptr<PullFunc> pullFunc =
+      m_pool ? BehaviorGraphArena::makeShared<PullFunc>(
+                   *m_pool, function, argBehaviors...)
+             : BehaviorGraphArena::makeShared<PullFunc>(function,
+                                                        argBehaviors...);
+  if (pullFunc->isConstant()) {
+    // Constant arguments may be pulled at any time.
+    const typename PullFunc::result_type value = (*pullFunc)(0.0);
+    return value ? Result::fromConstantValue(*value) : Result();
+  }
+
+  std::vector<boost::shared_ptr<BehaviorNode>> argumentNodes;
+  const bool allArgumentsAreNodes = pullFunc->argumentNodes(&argumentNodes);
+
+  BehaviorHashCons* const hashCons = BehaviorHashCons::current();
+  BehaviorHashCons_Key key;
+  const bool isShareable =
+      hashCons && allArgumentsAreNodes &&
+      BehaviorHashCons_FunctionIdentity<Function>::load(function, &key);
+  if (isShareable) {
+    for (const boost::shared_ptr<BehaviorNode>& node : argumentNodes)
+      key.argumentNodes.push_back(node.get());
+    key.distinct = m_distinct;
+    key.pool = m_pool;
+    if (const boost::shared_ptr<BehaviorNode> node = hashCons->find(key))
+      return Result::fromNode(node);
+  }
+
+  typedef typename Result::type Value;
+  typedef std::size_t BatchSignature(const double*, std::size_t, Value*);
+  Result result = Result::fromValuePullFunc(
+      BehaviorGraphArena::makeFunction<boost::optional<Value>(double)>(
+          [pullFunc](double time) { return (*pullFunc)(time); }),
+      BehaviorGraphArena::makeFunction<BatchSignature>(
+          [pullFunc](const double* times, std::size_t n, Value* out) {
+            return pullFunc->pullBatch(times, n, out);
+          }),
+      pullFunc->isPure()
+          ? BehaviorGraphArena::makeFunction<BatchSignature>(
+                [pullFunc](const double* times, std::size_t n, Value* out) {
+                  return pullFunc->evaluate(times, n, out);
+                })
+          : boost::function<BatchSignature>());
+  if (m_distinct)
+    result.setDistinct();
+  if (allArgumentsAreNodes) {
+    result.nodeAddress()->setDerived(argumentNodes);
+    const bool allArgumentsReportChanges = std::all_of(
+        argumentNodes.begin(), argumentNodes.end(),
+        [](const boost::shared_ptr<BehaviorNode>& node) {
+          return !node || node->reportsChanges();
+        });
+    if (allArgumentsReportChanges) {
+      const boost::shared_ptr<std::vector<std::uint64_t>> versions =
+          BehaviorGraphArena::makeShared<std::vector<std::uint64_t>>();
+      result.node()->setReuseHint(
+          BehaviorGraphArena::makeFunction<bool(double)>(
+              [pullFunc, versions](double time) {
+                return pullFunc->argumentsUnchanged(time, versions.get());
+              }));
+    }
+  }
+  if (isShareable)
+    hashCons->insert(key, result.node());
+  return result;
 }
 }
 #endif
@@ -0,0 +1,386 @@
+#ifndef SFRP_BEHAVIORNODE_HPP_
+#define SFRP_BEHAVIORNODE_HPP_
+
+//@PURPOSE: Provide the change tracking state of behavior graph nodes.
+//
+//@CLASSES:
+//  sfrp::BehaviorNode: dependency and change tracking base of graph nodes
+//  sfrp::BehaviorNode_Extension: state of a node that few nodes need
+//  sfrp::BehaviorNodeConcurrencyScope: guard marking concurrent pulls
+//  sfrp::BehaviorNodeExclusiveScope: guard suspending concurrent pulls
+//
+//@SEE_ALSO: sfrp_cachedincreasingpartialtimefunction, sfrp_incrementalengine
+//
+//@DESCRIPTION: This component provides a single class, 'BehaviorNode', that is
+// the non-template base of every node of a behavior graph. It records how the
+// value of the node may change between pulls and which nodes depend upon it.
+// The information is used by 'IncrementalEngine' to avoid re-evaluating the
+// parts of a graph whose inputs did not change.
+//
+// Every node has one of the following change modes.
+//..
+//  e_VOLATILE  The value may change at any time. This is the default and is
+//              appropriate for opaque pull functions, for instance those that
+//              depend upon time or have side effects.
+//  e_CONSTANT  The value is the same for all time.
+//  e_DERIVED   The value is a function of the values of the node's children
+//              at the same time. It changes only when a child changes.
+//  e_POLLED    The value changes only when a change function, polled once
+//              before every incremental pull, returns 'true'.
+//..
+// A node is dirty when its previously pulled value may differ from its value
+// at the next pull. Marking a node dirty with 'markDirty()' also marks all of
+// the nodes that transitively depend upon it dirty. Nodes start dirty.
+//
+// A node only reuses its previous value while it is clean and incremental. A
+// node is incremental while at least one 'IncrementalEngine' is tracking it.
+// Constant nodes reuse their value whether or not they are incremental. Other
+// nodes are only marked clean while they are incremental, so that pulls of
+// graphs that no engine tracks don't check the children of their nodes.
+//
+// Value Versions
+// --------------
+// Every node has a value version, a number that changes whenever the value of
+// the node may have changed between pulls at different times. Normally the
+// version changes at every evaluation of the node. A node may be given hints
+// that make its version more precise:
+//
+//: o A change hint is a function, called after every evaluation that replaced
+//:   a previous value, that returns 'false' when the new value is known to be
+//:   the same as the previous one. The version is then left unchanged. For
+//:   instance, the result of 'EventUtil::step()' only reports a change when
+//:   its event occurs.
+//:
+//: o A reuse hint is a function, called before every evaluation at a new
+//:   time, that returns 'true' when the value at that time is known to be the
+//:   same as the previously pulled value. The node then reuses its previous
+//:   value without evaluating its pull function. For instance, 'BehaviorMap'
+//:   gives its result a reuse hint comparing the versions of its arguments
+//:   when all of its arguments report their changes.
+//:
+//: o A distinct node compares every new value with the previous one and
+//:   leaves its version unchanged when they are equal. See
+//:   'CachedIncreasingPartialTimeFunction::setDistinct()'.
+//
+// A node reports its changes, see 'reportsChanges()', when it is constant,
+// distinct or has either hint. Unlike the change tracking used by
+// 'IncrementalEngine', hints take effect at every pull. A node releases its
+// hints, and whatever they refer to, once its value is no longer defined.
+//
+// Nodes keep weak references to their children and plain pointers to their
+// dependents. A node removes itself from the dependents of its remaining
+// children when it is destroyed. In builds with 'SFRP_SINGLE_THREADED' (see
+// sfrp_graphpointer), nodes also keep plain pointers to their children, which
+// a child clears from its dependents when it is destroyed, so that the
+// children checked at every pull by 'markClean()' are read without updating
+// reference counts.
+//
+// Most nodes of a graph are never incremental, have no hints, aren't polled
+// and aren't pulled concurrently. The state used for those features is kept
+// in a 'BehaviorNode_Extension' that is allocated the first time one of them
+// is used, so that a node without them is only a few words in size.
+//
+// Concurrent Pulls
+// ----------------
+// Normally a graph is pulled by a single thread at a time and nodes don't
+// need synchronization. A thread that pulls nodes concurrently with other
+// threads, for instance in a task of a parallel behavior map, does so within
+// a 'BehaviorNodeConcurrencyScope'. Within such a scope 'concurrentPullLock()'
+// locks the mutex of the node so that concurrent same-time pulls of a shared
+// node evaluate it only once. Outside of such a scope no locking takes place
+// and, while no thread of the process is within such a scope, pulls don't
+// consult thread-local state either. A 'BehaviorNodeExclusiveScope' suspends
+// the concurrency scopes of its thread, for instance while the thread runs
+// a task that pulls a graph no other thread accesses.
+// Note that 'markDirty()' is not synchronized; behaviors that mark other
+// nodes dirty as a side effect, such as wormhole inputs, must not be pulled
+// concurrently.
+
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+#include <sfrp/behaviorprofiler.hpp>
+#include <atomic>
+#include <cstdint>  // std::uint64_t
+#include <mutex>
+#include <vector>
+
+namespace sfrp {
+
+// This class implements the state of a behavior graph node that is only
+// needed by incremental, hinted, polled or concurrently pulled nodes.
+struct BehaviorNode_Extension {
+  // Create the state of a node that is not incremental and has no hints or
+  // change function.
+  BehaviorNode_Extension();
+
+  std::mutex m_mutex;
+  unsigned m_incrementalCount;
+  boost::function<bool()> m_changedFunc;
+  boost::function<bool()> m_changeHintFunc;
+  boost::function<bool(double)> m_reuseHintFunc;
+};
+
+// This class implements the dependency and change tracking state of a behavior
+// graph node.
+struct BehaviorNode {
+
+  // The ways in which the value of a node may change.
+  enum ChangeMode { e_VOLATILE, e_CONSTANT, e_DERIVED, e_POLLED };
+
+  // Create a dirty, volatile node without children.
+  BehaviorNode();
+
+  BehaviorNode(const BehaviorNode&) = delete;
+  BehaviorNode& operator=(const BehaviorNode&) = delete;
+
+  // Remove this node from the dependents of its children.
+  virtual ~BehaviorNode();
+
+  // Return the change mode of this node.
+  ChangeMode changeMode() const;
+
+  // Set the change mode of this node to 'e_CONSTANT'.
+  void setConstant();
+
+  // Set the change mode of this node to 'e_DERIVED' with the specified
+  // 'children'. Null children are ignored. The behavior is undefined unless
+  // this function is called at most once and before this node is pulled.
+  void setDerived(const std::vector<boost::shared_ptr<BehaviorNode>>& children);
+
+  // Set the change mode of this node to 'e_POLLED' with the specified
+  // 'changedFunc'. 'changedFunc' must return 'true' if the value of this node
+  // may have changed since the last time 'changedFunc' was called.
+  void setPolled(boost::function<bool()> changedFunc);
+
+  // Set the change hint of this node to the specified 'changedFunc'.
+  // 'changedFunc' is called after every evaluation of this node that replaced
+  // a previously pulled value and must return 'true' unless the new value is
+  // the same as the previous value.
+  void setChangeHint(boost::function<bool()> changedFunc);
+
+  // Set the reuse hint of this node to the specified 'reuseFunc'. 'reuseFunc'
+  // is called with the time of every evaluation of this node at a new time,
+  // whether or not a value was previously pulled, and must return 'false'
+  // unless the value at that time is the same as the previously pulled value.
+  void setReuseHint(boost::function<bool(double)> reuseFunc);
+
+  // Return 'true' if the value version of this node changes only when its
+  // value may have changed, that is if this node is constant, distinct or has
+  // a change or reuse hint, and 'false' if it changes at every evaluation.
+  bool reportsChanges() const;
+
+  // Return the value version of this node. The version differs from that of
+  // a previous pull whenever the value may differ from the value of that pull.
+  std::uint64_t valueVersion() const;
+
+  // Return the children of this node.
+  const std::vector<boost::weak_ptr<BehaviorNode>>& children() const;
+
+  // Return the result of calling the change function of this node. The
+  // behavior is undefined unless 'changeMode() == e_POLLED'.
+  bool pollChanged();
+
+  // Pull the value of this node at the specified 'time', caching it as a
+  // same-time pull would, and return 'true' if it is defined. A node without
+  // a value returns 'false'. This allows nodes to be pulled without knowledge
+  // of their value type, see sfrp_behaviorschedule.
+  virtual bool pullAt(double time);
+
+  // Mark this node and all of the nodes that transitively depend upon it
+  // dirty.
+  void markDirty();
+
+  // Return 'true' if this node is dirty and 'false' otherwise.
+  bool isDirty() const;
+
+  // Increment the number of incremental engines tracking this node.
+  void beginIncremental();
+
+  // Decrement the number of incremental engines tracking this node.
+  void endIncremental();
+
+  // Return 'true' if at least one incremental engine is tracking this node.
+  bool isIncremental() const;
+
+  // Return the profiling record of this node, or 0 if profiling is disabled.
+  // See sfrp_behaviorprofiler.
+  BehaviorProfiler_Record* profileRecord() const;
+
+ protected:
+  // Return 'true' if a previously pulled value of this node may be reused at
+  // a later time.
+  bool canReuse() const;
+
+  // Return the result of calling the reuse hint of this node with the
+  // specified 'time', or 'false' if this node has no reuse hint.
+  bool reuseHinted(double time);
+
+  // Change the value version of this node after an evaluation unless the
+  // specified 'replacedValue' is 'true' and the change hint of this node
+  // reports that the value is unchanged.
+  void updateValueVersion(bool replacedValue);
+
+  // Remove the change and reuse hints of this node. Nodes call this once
+  // their value is no longer defined.
+  void releaseHints();
+
+  // Mark this node clean unless one of its children is dirty or this node is
+  // neither constant nor incremental. Dependents are unaffected.
+  void markClean();
+
+  // Record that this node compares its values and leaves its value version
+  // unchanged when a new value is equal to the previous one.
+  void setComparesValues();
+
+  // Return a lock of the mutex of this node that is locked if the calling
+  // thread is within a 'BehaviorNodeConcurrencyScope' and unlocked
+  // otherwise.
+  std::unique_lock<std::mutex> concurrentPullLock();
+
+ private:
+  friend struct BehaviorNodeConcurrencyScope;
+  friend struct BehaviorNodeExclusiveScope;
+
+  // Return the number of 'BehaviorNodeConcurrencyScope' objects of the
+  // calling thread.
+  static unsigned& concurrencyDepth();
+
+  // Return the extension of this node, or 0 if it has none.
+  BehaviorNode_Extension* findExtension() const;
+
+  // Return the extension of this node, creating it if it has none. Concurrent
+  // calls return the same extension.
+  BehaviorNode_Extension& extension();
+
+  // The number of 'BehaviorNodeConcurrencyScope' objects of all threads.
+  static std::atomic<unsigned> s_numConcurrencyScopes;
+
+  std::atomic<BehaviorNode_Extension*> m_extension;
+  std::vector<boost::weak_ptr<BehaviorNode>> m_children;
+#ifdef SFRP_SINGLE_THREADED
+  // The children of this node, where those that were destroyed are null.
+  std::vector<BehaviorNode*> m_childNodes;
+#endif
+  std::vector<BehaviorNode*> m_dependents;
+  std::uint64_t m_valueVersion;
+  ChangeMode m_changeMode;
+  std::atomic<bool> m_dirty;
+  bool m_comparesValues;
+#ifdef SFRP_PROFILE
+  boost::shared_ptr<BehaviorProfiler_Record> m_profileRecord;
+#endif
+};
+
+// This class implements a guard that marks the calling thread as pulling
+// behavior nodes concurrently with other threads for its lifetime.
+struct BehaviorNodeConcurrencyScope {
+  // Mark the calling thread as pulling concurrently.
+  BehaviorNodeConcurrencyScope();
+
+  // Restore the previous state of the calling thread.
+  ~BehaviorNodeConcurrencyScope();
+
+  BehaviorNodeConcurrencyScope(const BehaviorNodeConcurrencyScope&) = delete;
+  BehaviorNodeConcurrencyScope& operator=(
+      const BehaviorNodeConcurrencyScope&) = delete;
+
+  // Return 'true' if the calling thread is within a concurrency scope that
+  // isn't suspended by a 'BehaviorNodeExclusiveScope' and 'false' otherwise.
+  static bool isActive();
+};
+
+// This class implements a guard that marks the calling thread as pulling only
+// nodes that no other thread accesses for its lifetime, suspending the
+// 'BehaviorNodeConcurrencyScope' objects of the thread.
+struct BehaviorNodeExclusiveScope {
+  // Suspend the concurrency scopes of the calling thread.
+  BehaviorNodeExclusiveScope();
+
+  // Restore the concurrency scopes of the calling thread.
+  ~BehaviorNodeExclusiveScope();
+
+  BehaviorNodeExclusiveScope(const BehaviorNodeExclusiveScope&) = delete;
+  BehaviorNodeExclusiveScope& operator=(const BehaviorNodeExclusiveScope&) =
+      delete;
+
+ private:
+  unsigned m_suspendedDepth;
+};
+
+// ===========================================================================
+//                 INLINE DEFINITIONS
+// ===========================================================================
+
+inline BehaviorNode::ChangeMode BehaviorNode::changeMode() const {
+  return m_changeMode;
+}
+
+inline const std::vector<boost::weak_ptr<BehaviorNode>>&
+BehaviorNode::children() const {
+  return m_children;
+}
+
+inline bool BehaviorNode::isDirty() const {
+  return m_dirty.load(std::memory_order_relaxed);
+}
+
+inline bool BehaviorNode::reportsChanges() const {
+  const BehaviorNode_Extension* const extension = findExtension();
+  return m_changeMode == e_CONSTANT || m_comparesValues ||
+         (extension &&
+          (extension->m_changeHintFunc || extension->m_reuseHintFunc));
+}
+
+inline std::uint64_t BehaviorNode::valueVersion() const {
+  return m_valueVersion;
+}
+
+inline bool BehaviorNode::isIncremental() const {
+  const BehaviorNode_Extension* const extension = findExtension();
+  return extension && extension->m_incrementalCount > 0;
+}
+
+inline BehaviorProfiler_Record* BehaviorNode::profileRecord() const {
+#ifdef SFRP_PROFILE
+  return m_profileRecord.get();
+#else
+  return 0;
+#endif
+}
+
+inline std::unique_lock<std::mutex> BehaviorNode::concurrentPullLock() {
+  // The thread-local depth is only consulted while some thread is pulling
+  // concurrently.
+  if (s_numConcurrencyScopes.load(std::memory_order_relaxed) > 0 &&
+      concurrencyDepth() > 0)
+    return std::unique_lock<std::mutex>(extension().m_mutex);
+  else
+    return std::unique_lock<std::mutex>();
+}
+
+inline bool BehaviorNode::canReuse() const {
+  return !isDirty() && (m_changeMode == e_CONSTANT ||
+                        (m_changeMode != e_VOLATILE && isIncremental()));
+}
+
+inline void BehaviorNode::setComparesValues() { m_comparesValues = true; }
+
+inline bool BehaviorNode::reuseHinted(double time) {
+  const BehaviorNode_Extension* const extension = findExtension();
+  return extension && extension->m_reuseHintFunc &&
+         extension->m_reuseHintFunc(time);
+}
+
+inline void BehaviorNode::updateValueVersion(bool replacedValue) {
+  const BehaviorNode_Extension* const extension = findExtension();
+  if (!replacedValue || !extension || !extension->m_changeHintFunc ||
+      extension->m_changeHintFunc())
+    ++m_valueVersion;
+}
+
+inline BehaviorNode_Extension* BehaviorNode::findExtension() const {
+  return m_extension.load(std::memory_order_acquire);
+}
+}
+#endif
@@ -0,0 +1,11 @@
+#ifndef SFRP_BEHAVIORNODE_T_HPP_
+#define SFRP_BEHAVIORNODE_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void behaviornodeTests(stest::TestCollector&);
+}
+#endif
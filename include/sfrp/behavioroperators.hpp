@@ -5,6 +5,9 @@
 //
 //@CLASSES:
 //  sfrp::BehaviorOperators: namespace for operators that can't be overloaded
+//  sfrp::BehaviorOperators_LazyIfThenElse: pull function of lazy selections
+//
+//@SEE_ALSO: sfrp_behaviormap
 //
 //@DESCRIPTION: This component provides operator overloads, and one free
 // function 'ifThenElse', that can be applied to behaviors. All these functions
@@ -25,10 +28,50 @@
 //  sfrp::Behavior<double> c = a + b;
 //..
 // The other operator overloads and functions work in a similar way.
+//
+// Like 'BehaviorMap', the operators fold constant arguments. If both 'a' and
+// 'b' above are constant, so is 'c', and its value is computed once.
+//
+// Lazy Operators
+// --------------
+// 'ifThenElse', '&&' and '||' pull all of their arguments at every pull, so
+// the case that isn't selected is evaluated as well. 'lazyIfThenElse',
+// 'lazyAnd' and 'lazyOr' only pull the arguments whose values are needed:
+// the selected case, or the right-hand side of 'lazyAnd' and 'lazyOr' when
+// the left-hand side doesn't determine the result. They are defined wherever
+// their comparison and the needed argument are defined.
+//
+// An argument that isn't needed is suspended: it isn't pulled at all. When it
+// is needed again it is pulled at the current time, so it catches up in a
+// single step. The times it skipped are never pulled, exactly as if the
+// program had not been pulled at those times, and behaviors that accumulate
+// state, such as integrals or wormholes, advance over the whole suspended
+// interval at once. An argument that must observe every time, for instance
+// one that feeds a wormhole pulled by other behaviors, should be used with
+// the strict operators instead. Like every behavior, a lazy result is
+// undefined from the first time at which it is undefined on, even if an
+// argument that was undefined at that time is no longer selected later.
+//
+// The results of the lazy operators are volatile nodes without children (see
+// sfrp_behaviornode), since their arguments vary from pull to pull. Their
+// arguments are pulled by the result itself rather than by an
+// 'IncrementalEngine' or a 'BehaviorSchedule'.
+//
+// Example 2: Skipping an expensive case
+// - - - - - - - - - - - - - - - - - - -
+// Say 'isColliding' is rarely 'true' and 'contactForce' is expensive to
+// compute. 'contactForce' is pulled only at the times 'isColliding' is 'true'.
+//..
+//  sfrp::Behavior<double> force = sfrp::BehaviorOperators::lazyIfThenElse(
+//      isColliding, contactForce, sfrp::BehaviorUtil::always(0.0));
+//..
 
+#include <boost/optional.hpp>
 #include <sfrp/behavior.hpp>
 #include <sfrp/behaviormap.hpp>
 #include <scpp/operators.hpp>
+#include <cstddef>  // std::size_t
+#include <utility>  // std::move
 
 namespace sfrp {
 
@@ -78,11 +121,64 @@ struct BehaviorOperators {
   // 'true' and 'falseCase' whenver 'comparison' is 'false'.
   //
   // Note that we made this a free function because we cannot overload the '?:'
-  // operator in C++.
+  // operator in C++. Both cases are pulled at every pull, even if
+  // 'comparison' is constant, and the result is undefined once any argument
+  // is. Only if all the arguments are constant is the result folded into a
+  // constant behavior. See 'lazyIfThenElse' for a selection that pulls only
+  // the selected case.
   template <typename A>
   static Behavior<A> ifThenElse(const Behavior<bool>& comparison,
                                 const Behavior<A>& trueCase,
                                 const Behavior<A>& falseCase);
+
+  // Return a behavior that is the specified 'trueCase' whenever 'comparison'
+  // is 'true' and 'falseCase' whenever 'comparison' is 'false'. Only the
+  // selected case is pulled, at the times it is selected. If 'comparison' is
+  // constant, the selected case is returned and the other case is never
+  // pulled. The result is pure if all of the arguments are pure.
+  template <typename A>
+  static Behavior<A> lazyIfThenElse(const Behavior<bool>& comparison,
+                                    const Behavior<A>& trueCase,
+                                    const Behavior<A>& falseCase);
+
+  // Return a behavior that is the logical and of the specified 'lhs' and
+  // 'rhs'. 'rhs' is only pulled at the times 'lhs' is 'true'. The resulting
+  // behavior is defined wherever 'lhs' is 'false' or both 'lhs' and 'rhs'
+  // are defined.
+  static Behavior<bool> lazyAnd(const Behavior<bool>& lhs,
+                                const Behavior<bool>& rhs);
+
+  // Return a behavior that is the logical or of the specified 'lhs' and
+  // 'rhs'. 'rhs' is only pulled at the times 'lhs' is 'false'. The resulting
+  // behavior is defined wherever 'lhs' is 'true' or both 'lhs' and 'rhs' are
+  // defined.
+  static Behavior<bool> lazyOr(const Behavior<bool>& lhs,
+                               const Behavior<bool>& rhs);
+};
+
+// This class implements the pull function of the result of
+// 'BehaviorOperators::lazyIfThenElse()'.
+template <typename A>
+struct BehaviorOperators_LazyIfThenElse {
+  // Create a pull function of the case selected by the specified
+  // 'comparison' among the specified 'trueCase' and 'falseCase'.
+  BehaviorOperators_LazyIfThenElse(const Behavior<bool>& comparison,
+                                   const Behavior<A>& trueCase,
+                                   const Behavior<A>& falseCase);
+
+  // Return the value of the selected case at the specified 'time', or
+  // 'boost::none' if the comparison or the selected case is undefined.
+  boost::optional<A> operator()(double time) const;
+
+  // Load into the specified 'out' array the values at each of the specified
+  // 'n' 'times' until the first time at which the result is undefined.
+  // Return the number of values loaded.
+  std::size_t pullBatch(const double* times, std::size_t n, A* out) const;
+
+ private:
+  Behavior<bool> m_comparison;
+  Behavior<A> m_trueCase;
+  Behavior<A> m_falseCase;
 };
 
 // ===========================================================================
@@ -127,6 +223,69 @@ Behavior<A> BehaviorOperators::ifThenElse(const Behavior<bool>& comparison,
   return sfrp::BehaviorMap()(
       scpp::Operators::ifThenElse<A>, comparison, trueCase, falseCase);
 }
+
+template <typename A>
+Behavior<A> BehaviorOperators::lazyIfThenElse(const Behavior<bool>& comparison,
+                                              const Behavior<A>& trueCase,
+                                              const Behavior<A>& falseCase) {
+  if (comparison.isConstant()) {
+    const boost::optional<bool> value = comparison.constantValue();
+    return !value ? Behavior<A>() : *value ? trueCase : falseCase;
+  }
+  const BehaviorOperators_LazyIfThenElse<A> pullFunc(
+      comparison, trueCase, falseCase);
+  return Behavior<A>::fromValuePullFunc(
+      pullFunc,
+      [pullFunc](const double* times, std::size_t n, A* out) {
+        return pullFunc.pullBatch(times, n, out);
+      },
+      comparison.isPure() && trueCase.isPure() && falseCase.isPure());
+}
+
+inline Behavior<bool> BehaviorOperators::lazyAnd(const Behavior<bool>& lhs,
+                                                 const Behavior<bool>& rhs) {
+  return lazyIfThenElse(lhs, rhs, Behavior<bool>::fromConstantValue(false));
+}
+
+inline Behavior<bool> BehaviorOperators::lazyOr(const Behavior<bool>& lhs,
+                                                const Behavior<bool>& rhs) {
+  return lazyIfThenElse(lhs, Behavior<bool>::fromConstantValue(true), rhs);
+}
+
+template <typename A>
+BehaviorOperators_LazyIfThenElse<A>::BehaviorOperators_LazyIfThenElse(
+    const Behavior<bool>& comparison,
+    const Behavior<A>& trueCase,
+    const Behavior<A>& falseCase)
+    : m_comparison(comparison), m_trueCase(trueCase), m_falseCase(falseCase) {}
+
+template <typename A>
+boost::optional<A> BehaviorOperators_LazyIfThenElse<A>::operator()(
+    double time) const {
+  const bool* const comparison = m_comparison.pullPointer(time);
+  if (!comparison)
+    return boost::none;
+  const A* const value =
+      (*comparison ? m_trueCase : m_falseCase).pullPointer(time);
+  if (!value)
+    return boost::none;
+  return *value;
+}
+
+template <typename A>
+std::size_t BehaviorOperators_LazyIfThenElse<A>::pullBatch(const double* times,
+                                                           std::size_t n,
+                                                           A* out) const {
+  // The cases are pulled one time at a time since each pulls only the times
+  // at which it is selected.
+  for (std::size_t i = 0; i < n; ++i) {
+    boost::optional<A> result = (*this)(times[i]);
+    if (!result)
+      return i;
+    out[i] = std::move(*result);
+  }
+  return n;
+}
 }
 
 #endif
@@ -0,0 +1,271 @@
+#ifndef SFRP_BEHAVIORPROFILER_HPP_
+#define SFRP_BEHAVIORPROFILER_HPP_
+
+//@PURPOSE: Provide per-node pull statistics for behavior graphs.
+//
+//@CLASSES:
+//  sfrp::BehaviorProfiler: registry and report of node pull statistics
+//  sfrp::BehaviorProfiler_Record: pull statistics of a single node
+//  sfrp::BehaviorProfiler_PullScope: guard timing a single pull of a node
+//
+//@SEE_ALSO: sfrp_behaviornode, sfrp_cachedincreasingpartialtimefunction,
+//  sfrp_behaviordebugutil
+//
+//@DESCRIPTION: This component provides a class, 'BehaviorProfiler', that
+// collects statistics about the pulls of every node of every behavior graph
+// and reports them ranked by the time spent within each node.
+//
+// Profiling is enabled at compile time by defining the 'SFRP_PROFILE' macro.
+// Because the macro changes the layout of 'BehaviorNode', it must be defined
+// consistently for every translation unit of a program, including those of
+// this library. When the macro isn't defined nodes have no profiling record,
+// the profiling hooks of 'CachedIncreasingPartialTimeFunction' compile to
+// nothing, and the reports are empty.
+//
+// For each node the following statistics are recorded.
+//
+//: o 'pulls': the number of times at which the node was pulled. A batch pull
+//:   counts as one pull per time.
+//:
+//: o 'cacheHits': the number of pulls that returned the cached value of a
+//:   previous pull at the same time.
+//:
+//: o 'inclusiveSeconds': the wall time spent within pulls of the node,
+//:   including the time spent pulling other nodes.
+//:
+//: o 'exclusiveSeconds': the wall time spent within pulls of the node,
+//:   excluding the time spent pulling other nodes.
+//:
+//: o 'valueCopies': the number of values copied into and out of the cache of
+//:   the node.
+//
+// Nodes are identified in reports by a number that reflects their order of
+// creation, the type of their value, and an optional name given with
+// 'setName()'. The statistics of a node remain in reports after the node is
+// destroyed until the next call to 'reset()'.
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: Finding an expensive node
+// - - - - - - - - - - - - - - - - - -
+// Say that some frames of our application take too long to render. With
+// 'SFRP_PROFILE' defined, we name the nodes we suspect and print the report
+// after a number of frames.
+//..
+//  sfrp::BehaviorProfiler::setName(*terrain.node(), "terrain");
+//  sfrp::BehaviorProfiler::setName(*water.node(), "water");
+//  for (int frame = 0; frame < 600; ++frame)
+//    draw(*scene.pull(frame / 60.0));
+//  std::cout << sfrp::BehaviorProfiler::report() << std::endl;
+//..
+// The report lists the nodes with the largest exclusive time first. It is an
+// 'smisc::Doc', which this header only declares so that the headers of graph
+// nodes don't depend upon smisc_doc; printing it requires that header. The
+// same statistics are available as JSON for further processing.
+//..
+//  std::ofstream json("profile.json");
+//  sfrp::BehaviorProfiler::writeJson(json);
+//..
+
+#include <boost/shared_ptr.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::uint64_t
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <typeinfo>  // std::type_info
+
+namespace smisc {
+struct Doc;
+}
+
+namespace sfrp {
+
+struct BehaviorNode;
+
+// This class implements the pull statistics of a single behavior graph node.
+// All of the counters may be updated concurrently.
+struct BehaviorProfiler_Record {
+  // Create a record with the specified 'id' and all counters set to zero.
+  explicit BehaviorProfiler_Record(std::uint64_t id);
+
+  BehaviorProfiler_Record(const BehaviorProfiler_Record&) = delete;
+  BehaviorProfiler_Record& operator=(const BehaviorProfiler_Record&) = delete;
+
+  // Return the identifier of this record.
+  std::uint64_t id() const;
+
+  // Return the name of this record. The name is empty unless it was set.
+  std::string name() const;
+
+  // Set the name of this record to the specified 'name'.
+  void setName(const std::string& name);
+
+  // Return the demangled name of the value type of this record, or an empty
+  // string if it wasn't set.
+  std::string valueTypeName() const;
+
+  // Set the value type of this record to the specified 'valueType'.
+  void setValueType(const std::type_info& valueType);
+
+  // Set all counters of this record to zero.
+  void reset();
+
+  std::atomic<std::uint64_t> numPulls;
+  std::atomic<std::uint64_t> numCacheHits;
+  std::atomic<std::uint64_t> inclusiveNanoseconds;
+  std::atomic<std::uint64_t> exclusiveNanoseconds;
+  std::atomic<std::uint64_t> numValueCopies;
+
+ private:
+  const std::uint64_t m_id;
+  std::atomic<const std::type_info*> m_valueType;
+  mutable std::mutex m_nameMutex;
+  std::string m_name;
+};
+
+#ifdef SFRP_PROFILE
+
+// This class implements a guard that records the pulls and the time spent
+// within its lifetime into a record. The time spent within nested guards of
+// the same thread is excluded from the exclusive time of the record.
+struct BehaviorProfiler_PullScope {
+  // Start timing the specified 'numPulls' pulls of the node of the specified
+  // 'record'.
+  BehaviorProfiler_PullScope(BehaviorProfiler_Record* record,
+                             std::size_t numPulls = 1);
+
+  BehaviorProfiler_PullScope(const BehaviorProfiler_PullScope&) = delete;
+  BehaviorProfiler_PullScope& operator=(const BehaviorProfiler_PullScope&) =
+      delete;
+
+  // Add the pulls and the time spent to the record of this guard.
+  ~BehaviorProfiler_PullScope();
+
+ private:
+  // Return the innermost guard of the calling thread.
+  static BehaviorProfiler_PullScope*& current();
+
+  BehaviorProfiler_Record* m_record;
+  std::size_t m_numPulls;
+  BehaviorProfiler_PullScope* m_parent;
+  std::chrono::steady_clock::time_point m_start;
+  std::uint64_t m_childNanoseconds;
+};
+
+#else
+
+struct BehaviorProfiler_PullScope {
+  BehaviorProfiler_PullScope(BehaviorProfiler_Record*, std::size_t = 1) {}
+};
+
+#endif
+
+// This class provides a namespace for the registry of node pull statistics.
+struct BehaviorProfiler {
+  // Return 'true' if profiling was enabled at compile time and 'false'
+  // otherwise.
+  static bool isEnabled();
+
+  // Return a new record registered with this profiler.
+  static boost::shared_ptr<BehaviorProfiler_Record> createRecord();
+
+  // Set the name of the specified 'node' in reports to the specified 'name'.
+  // This function has no effect unless profiling is enabled.
+  static void setName(const BehaviorNode& node, const std::string& name);
+
+  // Record a pull of the node of the specified 'record' that returned a value
+  // cached at the same time.
+  static void countCacheHit(BehaviorProfiler_Record* record);
+
+  // Record the specified 'numCopies' value copies by the node of the
+  // specified 'record'.
+  static void countValueCopies(BehaviorProfiler_Record* record,
+                               std::size_t numCopies);
+
+  // Record the specified 'valueType' as the value type of the node of the
+  // specified 'record'.
+  static void setValueType(BehaviorProfiler_Record* record,
+                           const std::type_info& valueType);
+
+  // Return a table of the statistics of the registered nodes with the node
+  // with the most exclusive time first.
+  static smisc::Doc report();
+
+  // Write to the specified 'stream' a JSON object whose 'nodes' member is an
+  // array of the statistics of the registered nodes, in the order of
+  // 'report()'.
+  static void writeJson(std::ostream& stream);
+
+  // Set the counters of all records to zero and unregister the records of
+  // destroyed nodes.
+  static void reset();
+};
+
+// ===========================================================================
+//                 INLINE DEFINITIONS
+// ===========================================================================
+
+inline std::uint64_t BehaviorProfiler_Record::id() const { return m_id; }
+
+#ifdef SFRP_PROFILE
+
+inline BehaviorProfiler_PullScope::BehaviorProfiler_PullScope(
+    BehaviorProfiler_Record* record,
+    std::size_t numPulls)
+    : m_record(record),
+      m_numPulls(numPulls),
+      m_parent(current()),
+      m_start(std::chrono::steady_clock::now()),
+      m_childNanoseconds(0) {
+  current() = this;
+}
+
+inline BehaviorProfiler_PullScope::~BehaviorProfiler_PullScope() {
+  const std::uint64_t elapsed =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - m_start).count();
+  current() = m_parent;
+  if (m_parent)
+    m_parent->m_childNanoseconds += elapsed;
+  m_record->numPulls += m_numPulls;
+  m_record->inclusiveNanoseconds += elapsed;
+  m_record->exclusiveNanoseconds +=
+      elapsed > m_childNanoseconds ? elapsed - m_childNanoseconds : 0;
+}
+
+inline bool BehaviorProfiler::isEnabled() { return true; }
+
+inline void BehaviorProfiler::countCacheHit(BehaviorProfiler_Record* record) {
+  ++record->numCacheHits;
+}
+
+inline void BehaviorProfiler::countValueCopies(BehaviorProfiler_Record* record,
+                                               std::size_t numCopies) {
+  record->numValueCopies += numCopies;
+}
+
+inline void BehaviorProfiler::setValueType(BehaviorProfiler_Record* record,
+                                           const std::type_info& valueType) {
+  record->setValueType(valueType);
+}
+
+#else
+
+inline bool BehaviorProfiler::isEnabled() { return false; }
+
+inline void BehaviorProfiler::countCacheHit(BehaviorProfiler_Record*) {}
+
+inline void BehaviorProfiler::countValueCopies(BehaviorProfiler_Record*,
+                                               std::size_t) {}
+
+inline void BehaviorProfiler::setValueType(BehaviorProfiler_Record*,
+                                           const std::type_info&) {}
+
+#endif
+}
+#endif
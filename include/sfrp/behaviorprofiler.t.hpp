@@ -0,0 +1,11 @@
+#ifndef SFRP_BEHAVIORPROFILER_T_HPP_
+#define SFRP_BEHAVIORPROFILER_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void behaviorprofilerTests(stest::TestCollector&);
+}
+#endif
@@ -5,6 +5,8 @@
 //
 //@CLASSES:
 //  sfrp::BehaviorPuller: specific time behavior pull functor
+//  sfrp::BehaviorReferencePuller: specific time behavior reference pull functor
+//  sfrp::BehaviorReferencePuller_Result: reference pull result metafunction
 //
 //@DESCRIPTION: This component provides a single functor class,
 // 'BehaviorPuller', that can be used to pull behaviors at a particular time. It
@@ -21,6 +23,13 @@
 // unwanted dependency. Given this case, the 'BehaviorPuller' object has its
 // use.
 //
+// 'BehaviorReferencePuller' is a variant of 'BehaviorPuller' that returns
+// references to the cached values of 'Behavior' objects, see
+// 'Behavior::pullPointer()', instead of copies. Other behavior-like arguments,
+// such as static behaviors, are pulled by value. The references remain valid
+// until the pulled behavior is pulled at a different time, so the results of a
+// 'BehaviorReferencePuller' should be consumed immediately.
+//
 // Usage
 // -----
 // This section illustrates intended use of this component.
@@ -48,6 +57,13 @@
 //  // Will be 'make_optional(string("Four"))'
 //  boost::optional<std::string> alwaysFourResult = atOne( alwaysFour );
 //..
+// When the value is only inspected, a 'BehaviorReferencePuller' avoids the
+// copy.
+//..
+//  sfrp::BehaviorReferencePuller refAtOne(1.0);
+//  // Will refer to the cached "Four" of 'alwaysFour'
+//  boost::optional<const std::string&> alwaysFourRef = refAtOne( alwaysFour );
+//..
 
 #include <boost/optional.hpp>
 #include <sfrp/behavior.hpp>
@@ -78,6 +94,46 @@ struct BehaviorPuller {
   double m_time;
 };
 
+// This class implements a metafunction that returns the result type of
+// pulling the specified 'BehaviorType' with a 'BehaviorReferencePuller'.
+template <typename BehaviorType>
+struct BehaviorReferencePuller_Result {
+  typedef boost::optional<typename BehaviorType::type> type;
+};
+
+template <typename T>
+struct BehaviorReferencePuller_Result<Behavior<T>> {
+  typedef boost::optional<const T&> type;
+};
+
+// This class implements a partial application of the 'pullPointer()' method of
+// behaviors where the time is set beforehand.
+struct BehaviorReferencePuller {
+  // Create a new 'BehaviorReferencePuller' object that pulls behaviors at the
+  // specified 'time'.
+  BehaviorReferencePuller(double time);
+
+  // Return the result type of applying this functor with the specified
+  // 'FunctorApplicationExpression'.
+  template <typename FunctorApplicationExpression>
+  struct result;
+
+  // Return a reference to the value of the specified 'behavior' at the time of
+  // this 'BehaviorReferencePuller' if it is defined and 'boost::none'
+  // otherwise.
+  template <typename T>
+  boost::optional<const T&> operator()(const Behavior<T>& behavior) const;
+
+  // Return the result of calling the 'pull()' function of the specified
+  // 'behavior' with the time of this 'BehaviorReferencePuller'.
+  template <typename OtherBehavior>
+  boost::optional<typename OtherBehavior::type> operator()(
+      const OtherBehavior& behavior) const;
+
+ private:
+  double m_time;
+};
+
 // ===========================================================================
 //                 INLINE DEFINITIONS
 // ===========================================================================
@@ -95,5 +151,27 @@ BehaviorPuller::
 operator()(const Behavior& b) const {
   return b.pull(m_time);
 }
+
+template <typename BehaviorArg>
+struct BehaviorReferencePuller::result<BehaviorReferencePuller(BehaviorArg)> {
+  typedef typename BehaviorReferencePuller_Result<typename std::remove_const<
+      typename std::remove_reference<BehaviorArg>::type>::type>::type type;
+};
+
+template <typename T>
+boost::optional<const T&> BehaviorReferencePuller::operator()(
+    const Behavior<T>& behavior) const {
+  const T* const value = behavior.pullPointer(m_time);
+  if (value)
+    return boost::optional<const T&>(*value);
+  else
+    return boost::none;
+}
+
+template <typename OtherBehavior>
+boost::optional<typename OtherBehavior::type> BehaviorReferencePuller::
+operator()(const OtherBehavior& behavior) const {
+  return behavior.pull(m_time);
+}
 }
 #endif
@@ -0,0 +1,11 @@
+#ifndef SFRP_BEHAVIORSCHEDULE_T_HPP_
+#define SFRP_BEHAVIORSCHEDULE_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void behaviorscheduleTests(stest::TestCollector&);
+}
+#endif
@@ -36,11 +36,13 @@
 //  }
 //..
 
-#include <boost/make_shared.hpp>
 #include <boost/shared_ptr.hpp>
 #include <sfrp/behavior.hpp>
+#include <sfrp/behaviorcheckpoint.hpp>
+#include <sfrp/behaviorgrapharena.hpp>
 #include <sfrp/behaviorpairutil.hpp>
 #include <sfrp/behaviorutil.hpp>
+#include <sfrp/wormhole.hpp>
 #include <utility>  // std::pair
 
 namespace sfrp {
@@ -64,7 +66,8 @@ struct BehaviorTimeUtil {
 
   // Return a behavior equivelent to the specified 'behavior' except that is
   // value up until the first 'pull()' occurence is replaced with the specified
-  // 'initialValue'.
+  // 'initialValue'. Whether the first pull occurred is part of checkpoints
+  // (see sfrp_behaviorcheckpoint).
   template <typename T>
   static Behavior<T> replaceInitialValue(const Behavior<T>& behavior,
                                          const T& initialValue);
@@ -101,7 +104,9 @@ static Behavior<T> BehaviorTimeUtil::replaceInitialValue(
     const T& initialValue)
 {
   boost::shared_ptr<bool> initialValueAlreadyPulled =
-      boost::make_shared<bool>(false);
+      BehaviorGraphArena::makeShared<bool>(false);
+  if (BehaviorCheckpoint* const checkpoint = BehaviorCheckpoint::current())
+    checkpoint->addState(initialValueAlreadyPulled);
   return sfrp::Behavior<T>::fromValuePullFunc(
           [initialValueAlreadyPulled, behavior, initialValue](const double time)
               ->boost::optional<T> {
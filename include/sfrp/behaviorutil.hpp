@@ -38,6 +38,12 @@
 //  sfrp::Behavior<double> timeTimesTwo =
 //      sfrp::BehaviorUtil::pure([](double time) { return time * 2; });
 //..
+// The behaviors created by 'always', 'time' and 'pure' are all pure in the
+// sense of 'Behavior::isPure()', evaluate batch pulls in a single loop and
+// may be evaluated without being pulled, see 'Behavior::evaluate()'.
+// 'always' behaviors are constant nodes and 'curtail' and 'map' behaviors are
+// derived nodes in the sense of sfrp_behaviornode.
+//
 // Another example of 'pure' is a behavior that has value "hello" before time
 // '3' and value "world" afterwards.
 //..
@@ -96,9 +102,28 @@
 //                                   x);
 //  }
 //..
+//
+// Example 4: Distinct Values
+// - - - - - - - - - - - - -
+// A mapping is re-evaluated whenever one of its arguments may have changed.
+// Say 'level' is an expensive function of a behavior that is pulled at every
+// frame but only occasionally changes value, such as the rounded score of a
+// game.
+//..
+//  sfrp::Behavior<Texture> banner = sfrp::BehaviorUtil::map(
+//      &renderLevelBanner,
+//      sfrp::BehaviorUtil::distinct(sfrp::BehaviorUtil::map(
+//          [](double score) { return int(score / 1000.0); }, score)));
+//..
+// 'distinct()' compares every value of its argument with the previous one so
+// that 'renderLevelBanner' is applied once per level rather than once per
+// frame. See sfrp_behaviormap.
 
+#include <boost/function.hpp>
 #include <sfrp/behavior.hpp>
 #include <sfrp/behaviormap.hpp>
+#include <sfrp/cachedincreasingpartialtimefunction.hpp>
+#include <cstddef>  // std::size_t
 #include <type_traits>
 
 namespace sfrp {
@@ -106,7 +131,7 @@ namespace sfrp {
 // 'Behavior' objects.
 struct BehaviorUtil {
 
-  // Return a behavior that has the specified 'value' for all time.
+  // Return a constant behavior that has the specified 'value' for all time.
   template <typename T>
   static Behavior<T> always(const T& value);
 
@@ -126,11 +151,21 @@ struct BehaviorUtil {
   //
   // Note that 'curtial()' can be used to ensure that behaviors are pulled even
   // if they aren't used. This application is frequently useful with wormholes,
-  // for example.
+  // for example. A constant 'curtailingBehavior' is folded: 'valueBehavior' is
+  // returned if it is defined and an undefined behavior otherwise.
   template <typename T, typename U>
   static Behavior<T> curtail(const Behavior<T>& valueBehavior,
                              const Behavior<U>& curtailingBehavior);
 
+  // Return a behavior with values equivelent to the specified 'behavior' that
+  // reports its changes: its value version changes only when its value is
+  // different, according to 'operator==', from its value at the previous
+  // pull. Mappings of the result reuse their values while it is unchanged. A
+  // constant 'behavior' is returned as is. 'T' must have an 'operator=='. See
+  // 'Behavior::setDistinct()'.
+  template <typename T>
+  static Behavior<T> distinct(const Behavior<T>& behavior);
+
   // Return a behavior that, for any time 't', is defined to be the specified
   // 'function' applied to the specified 'argBehaviors' behaviors at time 't'.
   // If any of 'argBehaviors' is not defined at time 't', then neither is the
@@ -149,28 +184,68 @@ struct BehaviorUtil {
 
 template <typename T>
 Behavior<T> BehaviorUtil::always(const T& value) {
-  return Behavior<T>::fromValuePullFunc([value](double time) {
-    return boost::make_optional(value);
-  });
+  return Behavior<T>::fromConstantValue(value);
 }
 
 template <typename T, typename U>
 Behavior<T> BehaviorUtil::curtail(const Behavior<T>& valueBehavior,
                                   const Behavior<U>& curtailingBehavior) {
-  return Behavior<T>::fromValuePullFunc([valueBehavior, curtailingBehavior](
-      double time) {
-    boost::optional<T> value = valueBehavior.pull(time);
-    boost::optional<U> curtail = curtailingBehavior.pull(time);
-    return curtail ? value : boost::none;
-  });
+  if (curtailingBehavior.isConstant()) {
+    return curtailingBehavior.constantValue() ? valueBehavior : Behavior<T>();
+  }
+  Behavior<T> result = Behavior<T>::fromValuePullFunc(
+      [valueBehavior, curtailingBehavior](double time) {
+        boost::optional<T> value = valueBehavior.pull(time);
+        boost::optional<U> curtail = curtailingBehavior.pull(time);
+        return curtail ? value : boost::none;
+      });
+  result.nodeAddress()->setDerived(
+      {valueBehavior.node(), curtailingBehavior.node()});
+  return result;
+}
+
+template <typename T>
+Behavior<T> BehaviorUtil::distinct(const Behavior<T>& behavior) {
+  static_assert(CachedIncreasingPartialTimeFunction_ValueComparison<T>::
+                    comparable(),
+                "distinct behaviors need values with an 'operator=='");
+  if (behavior.isConstant())
+    return behavior;
+  typedef boost::function<std::size_t(const double*, std::size_t, T*)>
+      BatchFunc;
+  Behavior<T> result = Behavior<T>::fromValuePullFunc(
+      [behavior](double time) { return behavior.pull(time); },
+      [behavior](const double* times, std::size_t n, T* out) {
+        return behavior.pullBatch(times, n, out);
+      },
+      behavior.isPure()
+          ? BatchFunc([behavior](const double* times, std::size_t n, T* out) {
+              return behavior.evaluate(times, n, out);
+            })
+          : BatchFunc());
+  result.nodeAddress()->setDerived({behavior.node()});
+  result.setDistinct();
+  return result;
 }
 
 template <typename Function>
 static Behavior<typename std::result_of<Function(double)>::type>
 BehaviorUtil::pure(Function timeFunction) {
   typedef typename std::result_of<Function(double)>::type ResultBehaviorValue;
-  return Behavior<ResultBehaviorValue>::fromValuePullFunc([timeFunction](
-      double time) { return boost::make_optional(timeFunction(time)); });
+  // The time function has no state, so batch pulls and evaluations coincide.
+  const auto apply = [timeFunction](const double* times,
+                                    std::size_t n,
+                                    ResultBehaviorValue* out) {
+    for (std::size_t i = 0; i < n; ++i)
+      out[i] = timeFunction(times[i]);
+    return n;
+  };
+  return Behavior<ResultBehaviorValue>::fromValuePullFunc(
+      [timeFunction](double time) {
+        return boost::make_optional(timeFunction(time));
+      },
+      apply,
+      apply);
 }
 
 template <typename Function, typename... ArgBehaviors>
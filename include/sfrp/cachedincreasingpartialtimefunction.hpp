@@ -5,8 +5,9 @@
 //
 //@CLASSES:
 //  sfrp::CachedIncreasingPartialTimeFunction: same-time pulling time function
+//  sfrp::CachedIncreasingPartialTimeFunction_ValueComparison: value equality
 //
-//@SEE_ALSO: sfrp_increasingpartialtimefunction
+//@SEE_ALSO: sfrp_increasingpartialtimefunction, sfrp_behaviornode
 //
 //@DESCRIPTION: This component provides a single class,
 // 'CachedIncreasingPartialTimeFunction', which wraps a specially contstrained
@@ -28,6 +29,53 @@
 // reactive programming graph to call the 'pull()' function of a single time
 // function at a single time step.
 //
+// 'pullPointer()' is a variant of 'pull()' that returns the address of the
+// cached value instead of a copy of it. Values returned by the underlying
+// function are moved into the cache, so pulling a node with 'pullPointer()'
+// copies no values at all. The address remains valid until the next pull at a
+// different time.
+//
+// 'pullBatch()' evaluates many increasing times at once. If the first time of
+// the batch is the time of the previous pull, the cached value is reused. The
+// last value of the batch is cached for subsequent same-time pulls and the
+// value version and dirty state are updated as they would be by a pull at
+// that time.
+//
+// A time function may be declared pure at construction. A pure time function
+// is a function of its time argument alone and pulling it has no side
+// effects. Pure time functions may be evaluated in batches independently of
+// the rest of the graph. See 'sfrp_behavior' for more information.
+//
+// A pure time function may also be given an evaluation function at
+// construction. 'evaluate()' calls it with arbitrary increasing times without
+// pulling the time function, so the cached value, the value version and the
+// dirty state of the node, and of the nodes it depends upon, are left
+// unchanged. Pure time functions without an evaluation function, and time
+// functions that are no longer defined, evaluate no values.
+//
+// 'CachedIncreasingPartialTimeFunction' is a 'BehaviorNode'. When the node
+// may reuse its value, see 'BehaviorNode::canReuse()', a pull at a new time
+// returns the previously pulled value without calling the underlying
+// function. Likewise, a node whose reuse hint reports an unchanged value
+// reuses its previous value. Every evaluation updates the value version of the
+// node. See sfrp_behaviornode.
+//
+// A time function made distinct with 'setDistinct()' compares every value
+// returned by the underlying function with the cached value of the previous
+// pull. When they are equal, the cached value is kept and the value version
+// of the node is left unchanged, so that dependents that compare versions,
+// such as the results of 'BehaviorMap', reuse their own values. Values are
+// compared with 'operator==' when the value type has one. Values of other
+// types are never considered equal and making their time functions distinct
+// has no effect.
+//
+// Pulls are synchronized when the calling thread pulls concurrently with other
+// threads, see sfrp_behaviornode, so that a node shared by concurrently pulled
+// behaviors is evaluated once per time.
+//
+// When profiling is enabled, pulls record their statistics into the profiling
+// record of the node. See sfrp_behaviorprofiler.
+//
 // Generally speaking, this class is intended for use as a tool to build up
 // an implementation of the sfrp_behavior component.
 //
@@ -40,6 +88,14 @@
 
 #include <boost/function.hpp>
 #include <boost/optional.hpp>
+#include <cstddef>  // std::size_t
+#include <mutex>
+#include <type_traits>
+#include <typeinfo>  // typeid
+#include <utility>   // std::pair
+#include <vector>
+#include <sfrp/behaviornode.hpp>
+#include <sfrp/behaviorprofiler.hpp>
 #include <sfrp/cachedpull.hpp>
 #include <sfrp/increasingpartialtimefunction.hpp>
 
@@ -48,7 +104,7 @@ namespace sfrp {
 // This class implements a partial time function whose pull method allows for
 // multiple subsequent calls of the same value.
 template <typename Value>
-struct CachedIncreasingPartialTimeFunction {
+struct CachedIncreasingPartialTimeFunction : BehaviorNode {
 
   // Create a new 'CachedIncreasingPartialTimeFunction<Value>' object from the
   // specified 'valuePullFunc' function.  The behavior is undefined unless
@@ -58,6 +114,35 @@ struct CachedIncreasingPartialTimeFunction {
   CachedIncreasingPartialTimeFunction(
       boost::function<boost::optional<Value>(double)> valuePullFunc);
 
+  // Create a new 'CachedIncreasingPartialTimeFunction<Value>' object from the
+  // specified 'valuePullFunc' and 'valuePullBatchFunc' functions that is pure
+  // if the specified 'pure' is 'true'. The behavior is undefined unless
+  // 'valuePullFunc' and 'valuePullBatchFunc' satisfy the requirements of the
+  // corresponding 'IncreasingPartialTimeFunction' constructor and, if 'pure'
+  // is 'true', 'valuePullFunc' depends only upon its argument and has no side
+  // effects.
+  CachedIncreasingPartialTimeFunction(
+      boost::function<boost::optional<Value>(double)> valuePullFunc,
+      boost::function<std::size_t(const double*, std::size_t, Value*)>
+          valuePullBatchFunc,
+      bool pure);
+
+  // Create a new 'CachedIncreasingPartialTimeFunction<Value>' object from the
+  // specified 'valuePullFunc' and 'valuePullBatchFunc' functions that is pure
+  // and evaluated by the specified 'valueEvaluateFunc' if 'valueEvaluateFunc'
+  // isn't empty. The behavior is undefined unless 'valuePullFunc' and
+  // 'valuePullBatchFunc' satisfy the requirements of the corresponding
+  // 'IncreasingPartialTimeFunction' constructor and, if 'valueEvaluateFunc'
+  // isn't empty, 'valuePullFunc' depends only upon its argument and has no
+  // side effects, and 'valueEvaluateFunc' loads the values 'valuePullBatchFunc'
+  // would load for any strictly increasing times without changing any node.
+  CachedIncreasingPartialTimeFunction(
+      boost::function<boost::optional<Value>(double)> valuePullFunc,
+      boost::function<std::size_t(const double*, std::size_t, Value*)>
+          valuePullBatchFunc,
+      boost::function<std::size_t(const double*, std::size_t, Value*)>
+          valueEvaluateFunc);
+
   // Create a new 'CachedIncreasingPartialTimeFunction' object that has the
   // same value as the specified 'other' object.
   CachedIncreasingPartialTimeFunction(
@@ -78,6 +163,49 @@ struct CachedIncreasingPartialTimeFunction {
   // returns 'boost::none', it will return 'boost::none' thereafter.
   boost::optional<Value> pull(const double time);
 
+  // Return the address of the value of this partial time function at the
+  // specified 'time' if it is defined, otherwise return 0. The value remains
+  // valid until this function is pulled at a different time or destroyed. The
+  // behavior is undefined unless the preconditions of 'pull()' hold for
+  // 'time'.
+  const Value* pullPointer(const double time);
+
+  // Load into the specified 'out' array the values of this partial time
+  // function at each of the specified 'n' 'times' until the first time at
+  // which it is not defined. Return the number of values loaded. If the
+  // returned value is less than 'n', this function is no longer defined.
+  //
+  // The behavior is undefined unless 'times' is strictly increasing, the
+  // first time satisfies the preconditions of 'pull()', and 'out' has room
+  // for 'n' values.
+  std::size_t pullBatch(const double* times, std::size_t n, Value* out);
+
+  // Load into the specified 'out' array the values of this partial time
+  // function at each of the specified 'n' 'times', computed by its evaluation
+  // function, until the first time at which it is not defined. Return the
+  // number of values loaded, which is 0 if this time function has no
+  // evaluation function or is no longer defined. Unlike 'pullBatch()', this
+  // function may be called with times earlier than those of previous pulls
+  // and changes neither the cached value nor the value version. The behavior
+  // is undefined unless 'times' is strictly increasing and 'out' has room for
+  // 'n' values.
+  std::size_t evaluate(const double* times, std::size_t n, Value* out);
+
+  // Pull the value of this partial time function at the specified 'time' with
+  // 'pullPointer()' and return 'true' if it is defined. The behavior is
+  // undefined unless the preconditions of 'pull()' hold for 'time'.
+  bool pullAt(double time) override;
+
+  // Return 'true' if this time function was declared pure at construction and
+  // 'false' otherwise.
+  bool isPure() const;
+
+  // Make this time function compare every newly evaluated value with the
+  // value of the previous pull using 'operator==' and keep the previous value
+  // and value version when they are equal. This has no effect if 'Value' has
+  // no 'operator=='.
+  void setDistinct();
+
   // Give this 'CachedIncreasingPartialTimeFunction' object the same value as
   // the specified 'other' object.
   CachedIncreasingPartialTimeFunction& operator=(
@@ -92,6 +220,64 @@ struct CachedIncreasingPartialTimeFunction {
 
   IncreasingPartialTimeFunction<Value> m_increasingPartialTimeFunction;
   boost::optional<CachedPull<Value>> m_previousPullCache;
+  bool m_pure;
+
+  // The evaluation function of pure time functions, or empty.
+  boost::function<std::size_t(const double*, std::size_t, Value*)>
+      m_valueEvaluateFunc;
+
+  // The comparison of distinct time functions, or 0.
+  bool (*m_equalValues)(const Value&, const Value&);
+};
+
+// This class implements the selection of the comparison of distinct time
+// functions.
+template <typename Value>
+struct CachedIncreasingPartialTimeFunction_ValueComparison {
+  // The type of the comparison functions.
+  typedef bool (*Function)(const Value&, const Value&);
+
+  // Return the address of a function comparing values with 'operator==' if
+  // 'Value' has one and 0 otherwise.
+  static Function function();
+
+  // Return 'true' if 'Value' has an 'operator==' and 'false' otherwise.
+  static constexpr bool comparable();
+
+ private:
+  // Return 'true' if the specified 'lhs' and 'rhs' are equal according to
+  // 'operator==' and 'false' otherwise.
+  static bool equal(const Value& lhs, const Value& rhs);
+
+  // The overloads of 'isComparable' return 'std::true_type' if the pointed to
+  // type has an 'operator==' and 'std::false_type' otherwise. The
+  // 'operator==' of 'std::pair', 'boost::optional' and 'std::vector' is
+  // declared for all of their instances, so they are checked element by
+  // element.
+  template <typename U>
+  static std::false_type isComparable(const U* value, long);
+
+  template <typename U>
+  static auto isComparable(const U* value, int)
+      -> decltype(bool(*value == *value), std::true_type());
+
+  template <typename U, typename V>
+  static auto isComparable(const std::pair<U, V>* value, int)
+      -> std::integral_constant<
+          bool,
+          decltype(isComparable(&value->first, 0))::value &&
+              decltype(isComparable(&value->second, 0))::value>;
+
+  template <typename U>
+  static auto isComparable(const boost::optional<U>* value, int)
+      -> decltype(isComparable(static_cast<const U*>(0), 0));
+
+  template <typename U>
+  static auto isComparable(const std::vector<U>* value, int)
+      -> decltype(isComparable(static_cast<const U*>(0), 0));
+
+  static Function select(std::true_type);
+  static Function select(std::false_type);
 };
 
 // ===========================================================================
@@ -101,35 +287,218 @@ struct CachedIncreasingPartialTimeFunction {
 template <typename Value>
 CachedIncreasingPartialTimeFunction<Value>::CachedIncreasingPartialTimeFunction(
     boost::function<boost::optional<Value>(double)> valuePullFunc)
-    : m_increasingPartialTimeFunction(valuePullFunc), m_previousPullCache() {}
+    : m_increasingPartialTimeFunction(valuePullFunc),
+      m_previousPullCache(),
+      m_pure(false),
+      m_equalValues(0) {
+  BehaviorProfiler::setValueType(profileRecord(), typeid(Value));
+}
 
 template <typename Value>
 CachedIncreasingPartialTimeFunction<Value>::CachedIncreasingPartialTimeFunction(
-    CachedIncreasingPartialTimeFunction&& other) {
+    boost::function<boost::optional<Value>(double)> valuePullFunc,
+    boost::function<std::size_t(const double*, std::size_t, Value*)>
+        valuePullBatchFunc,
+    bool pure)
+    : m_increasingPartialTimeFunction(valuePullFunc, valuePullBatchFunc),
+      m_previousPullCache(),
+      m_pure(pure),
+      m_equalValues(0) {
+  BehaviorProfiler::setValueType(profileRecord(), typeid(Value));
+}
+
+template <typename Value>
+CachedIncreasingPartialTimeFunction<Value>::CachedIncreasingPartialTimeFunction(
+    boost::function<boost::optional<Value>(double)> valuePullFunc,
+    boost::function<std::size_t(const double*, std::size_t, Value*)>
+        valuePullBatchFunc,
+    boost::function<std::size_t(const double*, std::size_t, Value*)>
+        valueEvaluateFunc)
+    : m_increasingPartialTimeFunction(valuePullFunc, valuePullBatchFunc),
+      m_previousPullCache(),
+      m_pure(!valueEvaluateFunc.empty()),
+      m_valueEvaluateFunc(std::move(valueEvaluateFunc)),
+      m_equalValues(0) {
+  BehaviorProfiler::setValueType(profileRecord(), typeid(Value));
+}
+
+template <typename Value>
+CachedIncreasingPartialTimeFunction<Value>::CachedIncreasingPartialTimeFunction(
+    CachedIncreasingPartialTimeFunction&& other)
+    : m_pure(other.m_pure),
+      m_valueEvaluateFunc(std::move(other.m_valueEvaluateFunc)),
+      m_equalValues(other.m_equalValues) {
   m_increasingPartialTimeFunction =
       std::move(other.m_increasingPartialTimeFunction);
+  BehaviorProfiler::setValueType(profileRecord(), typeid(Value));
 }
 
 template <typename Value>
 boost::optional<Value> CachedIncreasingPartialTimeFunction<Value>::pull(
     const double time) {
+  const Value* const value = pullPointer(time);
+  if (!value)
+    return boost::none;
+  BehaviorProfiler::countValueCopies(profileRecord(), 1);
+  return *value;
+}
+
+template <typename Value>
+const Value* CachedIncreasingPartialTimeFunction<Value>::pullPointer(
+    const double time) {
+  const std::unique_lock<std::mutex> lock = concurrentPullLock();
+  const BehaviorProfiler_PullScope profileScope(profileRecord());
   if (m_previousPullCache && m_previousPullCache->time() == time) {
-    return m_previousPullCache->value();
+    BehaviorProfiler::countCacheHit(profileRecord());
+  } else if (m_previousPullCache && canReuse()) {
+    m_previousPullCache->setTime(time);
+  } else if (reuseHinted(time) && m_previousPullCache) {
+    // The reuse hint is consulted even without a previous value so that it
+    // may record the state of this time.
+    m_previousPullCache->setTime(time);
+    markClean();
   } else {
+    const bool replacedValue = bool(m_previousPullCache);
     boost::optional<Value> result = m_increasingPartialTimeFunction.pull(time);
-    if (!result)
-      m_previousPullCache = boost::none;
-    else
-      m_previousPullCache = CachedPull<Value>(time, *result);
-    return result;
+    if (result && replacedValue && m_equalValues &&
+        m_equalValues(m_previousPullCache->value(), *result)) {
+      m_previousPullCache->setTime(time);
+    } else {
+      if (!result)
+        m_previousPullCache = boost::none;
+      else
+        m_previousPullCache = CachedPull<Value>(time, std::move(*result));
+      updateValueVersion(replacedValue);
+      if (!result) {
+        m_valueEvaluateFunc.clear();
+        releaseHints();
+      }
+    }
+    markClean();
+  }
+  return m_previousPullCache ? &m_previousPullCache->value() : 0;
+}
+
+template <typename Value>
+std::size_t CachedIncreasingPartialTimeFunction<Value>::pullBatch(
+    const double* times,
+    std::size_t n,
+    Value* out) {
+  if (n == 0)
+    return 0;
+
+  const std::unique_lock<std::mutex> lock = concurrentPullLock();
+  const BehaviorProfiler_PullScope profileScope(profileRecord(), n);
+
+  // A batch starting at the time of the previous pull starts with the cached
+  // value.
+  std::size_t offset = 0;
+  if (m_previousPullCache && m_previousPullCache->time() == times[0]) {
+    BehaviorProfiler::countCacheHit(profileRecord());
+    BehaviorProfiler::countValueCopies(profileRecord(), 1);
+    out[0] = m_previousPullCache->value();
+    offset = 1;
   }
+  if (offset == n)
+    return n;
+
+  const bool replacedValue = bool(m_previousPullCache);
+  const std::size_t count =
+      offset + m_increasingPartialTimeFunction.pullBatch(
+                   times + offset, n - offset, out + offset);
+
+  // The change hint only describes the last evaluation, so it may be
+  // consulted only when the batch evaluated a single time.
+  const bool hintable = replacedValue && n - offset == 1;
+  if (count < n) {
+    m_previousPullCache = boost::none;
+    updateValueVersion(hintable);
+    m_valueEvaluateFunc.clear();
+    releaseHints();
+  } else if (replacedValue && m_equalValues &&
+             m_equalValues(m_previousPullCache->value(), out[n - 1])) {
+    m_previousPullCache->setTime(times[n - 1]);
+  } else {
+    BehaviorProfiler::countValueCopies(profileRecord(), 1);
+    m_previousPullCache = CachedPull<Value>(times[n - 1], out[n - 1]);
+    updateValueVersion(hintable);
+  }
+  markClean();
+  return count;
 }
+
+template <typename Value>
+std::size_t CachedIncreasingPartialTimeFunction<Value>::evaluate(
+    const double* times,
+    std::size_t n,
+    Value* out) {
+  const std::unique_lock<std::mutex> lock = concurrentPullLock();
+  return n == 0 || m_valueEvaluateFunc.empty()
+             ? 0
+             : m_valueEvaluateFunc(times, n, out);
+}
+
+template <typename Value>
+bool CachedIncreasingPartialTimeFunction<Value>::pullAt(double time) {
+  return pullPointer(time) != 0;
+}
+
+template <typename Value>
+bool CachedIncreasingPartialTimeFunction<Value>::isPure() const {
+  return m_pure;
+}
+
+template <typename Value>
+void CachedIncreasingPartialTimeFunction<Value>::setDistinct() {
+  m_equalValues =
+      CachedIncreasingPartialTimeFunction_ValueComparison<Value>::function();
+  if (m_equalValues)
+    setComparesValues();
+}
+
 template <typename Value>
 CachedIncreasingPartialTimeFunction<Value>&
 CachedIncreasingPartialTimeFunction<Value>::
 operator=(CachedIncreasingPartialTimeFunction&& other) {
   m_increasingPartialTimeFunction =
       std::move(other.m_increasingPartialTimeFunction);
+  m_pure = other.m_pure;
+  m_valueEvaluateFunc = std::move(other.m_valueEvaluateFunc);
+  m_equalValues = other.m_equalValues;
+  return *this;
+}
+
+template <typename Value>
+typename CachedIncreasingPartialTimeFunction_ValueComparison<Value>::Function
+CachedIncreasingPartialTimeFunction_ValueComparison<Value>::function() {
+  return select(decltype(isComparable(static_cast<const Value*>(0), 0))());
+}
+
+template <typename Value>
+constexpr bool
+CachedIncreasingPartialTimeFunction_ValueComparison<Value>::comparable() {
+  return decltype(isComparable(static_cast<const Value*>(0), 0))::value;
+}
+
+template <typename Value>
+bool CachedIncreasingPartialTimeFunction_ValueComparison<Value>::equal(
+    const Value& lhs,
+    const Value& rhs) {
+  return lhs == rhs;
+}
+
+template <typename Value>
+typename CachedIncreasingPartialTimeFunction_ValueComparison<Value>::Function
+CachedIncreasingPartialTimeFunction_ValueComparison<Value>::select(
+    std::true_type) {
+  return &equal;
+}
+
+template <typename Value>
+typename CachedIncreasingPartialTimeFunction_ValueComparison<Value>::Function
+CachedIncreasingPartialTimeFunction_ValueComparison<Value>::select(
+    std::false_type) {
+  return 0;
 }
 }
 #endif
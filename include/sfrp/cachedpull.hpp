@@ -61,6 +61,10 @@ struct CachedPull {
   // Return the 'value' associated with this 'CachedPull' object.
   const Value& value() const;
 
+  // Set the 'time' associated with this 'CachedPull' object to the specified
+  // 'time'. The value is unchanged.
+  void setTime(double time);
+
   // Give this 'CachedPull' object the same value as the specified 'other'
   // 'CachedPull' object.
   CachedPull& operator=(CachedPull&& other);
@@ -92,10 +96,16 @@ const Value& CachedPull<Value>::value() const {
   return m_value;
 }
 
+template <typename Value>
+void CachedPull<Value>::setTime(double time) {
+  m_time = time;
+}
+
 template <typename Value>
 CachedPull<Value>& CachedPull<Value>::operator=(CachedPull&& other) {
   m_time = other.m_time;
   m_value = std::move(other.m_value);
+  return *this;
 }
 }
 #endif
@@ -0,0 +1,301 @@
+#ifndef SFRP_EVENTRECORDER_HPP_
+#define SFRP_EVENTRECORDER_HPP_
+
+//@PURPOSE: Provide recording and deterministic replay of event occurrences.
+//
+//@CLASSES:
+//  sfrp::EventRecorder_Codec: binary encoding of occurrence values
+//  sfrp::EventRecorder: background writer of an occurrence log
+//  sfrp::EventReplayer: reader feeding an occurrence log back into a graph
+//
+//@SEE_ALSO: sfrp_triggerutil, sfrp_behaviordriver
+//
+//@DESCRIPTION: This component provides a class, 'EventRecorder', that
+// records the occurrences of events, such as those of triggers created with
+// 'TriggerUtil', to a compact binary log, and a class, 'EventReplayer', that
+// feeds such a log back into a graph.
+//
+// 'EventRecorder::record()' returns an event equivelent to its argument that
+// appends every occurrence, together with the time of the pull that delivered
+// it and a channel number identifying the event, to the log. Pulls only copy
+// the encoded occurrence into a buffer; a background thread writes the buffer
+// to the output stream.
+//
+// 'EventReplayer::event()' returns an event that has the occurrences of a
+// channel of a log at the times they were recorded. 'EventReplayer::run()'
+// pulls a root behavior at every time of the log, one after the other without
+// waiting, so a graph built upon replayed events goes through the same
+// occurrences as the recorded one as fast as it can evaluate them. Note that
+// only the times with occurrences are replayed; graphs whose values depend
+// upon the times of the pulls between occurrences, such as integrals, should
+// also record a periodic event.
+//
+// Values are encoded with 'EventRecorder_Codec', which copies the bytes of
+// trivially copyable types and of 'std::string'. Other types need a
+// specialization. Logs use the byte order of the machine that wrote them.
+//
+// Log Format
+// ----------
+// A log starts with the 8 bytes "SFRPLOG1", followed by one record per
+// occurrence.
+//..
+//  std::uint32_t channel
+//  double        time
+//  std::uint32_t size
+//  char          bytes[size]
+//..
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: Recording and replaying clicks
+// - - - - - - - - - - - - - - - - - - - - -
+// Say 'makeGame' builds a game from an event of clicks. In production, the
+// clicks come from a trigger and are recorded.
+//..
+//  std::ofstream file("clicks.log", std::ios::binary);
+//  sfrp::EventRecorder recorder(file);
+//  auto clicks = sfrp::TriggerUtil::triggerInf<Point>();
+//  sfrp::Behavior<Game> game = makeGame(recorder.record(0, clicks.first));
+//..
+// Later, the same game is rebuilt from the log and replayed at full speed.
+//..
+//  std::ifstream file("clicks.log", std::ios::binary);
+//  sfrp::EventReplayer replayer(file);
+//  sfrp::Behavior<Game> game = makeGame(replayer.event<Point>(0));
+//  replayer.run(game);
+//..
+
+#include <boost/function.hpp>
+#include <boost/optional.hpp>
+#include <sfrp/behavior.hpp>
+#include <condition_variable>
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::uint32_t
+#include <cstring>  // std::memcpy
+#include <deque>
+#include <istream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <type_traits>  // std::is_trivially_copyable
+#include <vector>
+
+namespace sfrp {
+
+// This class implements the binary encoding of values of the specified 'T'
+// type, which must be trivially copyable. Specialize it for other types.
+template <typename T>
+struct EventRecorder_Codec {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "EventRecorder_Codec must be specialized for this type");
+
+  // Append the encoding of the specified 'value' to the specified 'out'.
+  static void encode(const T& value, std::vector<char>* out);
+
+  // Return the value encoded in the specified 'size' bytes at the specified
+  // 'data'.
+  static T decode(const char* data, std::size_t size);
+};
+
+template <>
+struct EventRecorder_Codec<std::string> {
+  static void encode(const std::string& value, std::vector<char>* out);
+  static std::string decode(const char* data, std::size_t size);
+};
+
+// This class implements a recorder of event occurrences that writes them to a
+// stream on a background thread.
+struct EventRecorder {
+  // Create a recorder that writes its log to the specified 'stream'. The
+  // behavior is undefined unless 'stream' outlives this recorder and is not
+  // otherwise used while this recorder exists.
+  explicit EventRecorder(std::ostream& stream);
+
+  EventRecorder(const EventRecorder&) = delete;
+  EventRecorder& operator=(const EventRecorder&) = delete;
+
+  // Write all of the recorded occurrences and join the writer thread.
+  ~EventRecorder();
+
+  // Return an event equivelent to the specified 'event' that records its
+  // occurrences on the specified 'channel'. The behavior is undefined unless
+  // this recorder outlives the result.
+  template <typename T>
+  Behavior<boost::optional<T>> record(
+      std::uint32_t channel,
+      const Behavior<boost::optional<T>>& event);
+
+  // Return when all of the occurrences recorded before this call have been
+  // written to the stream and the stream was flushed. Occurrences recorded
+  // during the call don't delay it.
+  void flush();
+
+  // Return the number of occurrences recorded so far.
+  std::size_t numRecorded() const;
+
+ private:
+  // Append a record of the specified 'channel', 'time' and encoded 'bytes'
+  // to the buffer of this recorder.
+  void append(std::uint32_t channel,
+              double time,
+              const std::vector<char>& bytes);
+
+  // Write the buffer to the stream until this recorder is destroyed.
+  void write();
+
+  std::ostream& m_stream;
+  mutable std::mutex m_mutex;
+  std::condition_variable m_appended;
+  std::condition_variable m_written;
+  std::vector<char> m_buffer;
+  std::size_t m_numRecorded;
+  std::uint64_t m_numAppended;  // bytes of the log, including the buffer
+  std::uint64_t m_numWritten;   // bytes of the log written to the stream
+  bool m_stopped;
+  std::thread m_writer;
+};
+
+// This class implements a reader of the logs of 'EventRecorder' that feeds
+// them into a graph.
+struct EventReplayer {
+  // Create a replayer of the log in the specified 'stream'. Throw
+  // 'std::runtime_error' if 'stream' doesn't start with the header of a log.
+  // The behavior is undefined unless 'stream' outlives this replayer and
+  // holds a log written by an 'EventRecorder'.
+  explicit EventReplayer(std::istream& stream);
+
+  EventReplayer(const EventReplayer&) = delete;
+  EventReplayer& operator=(const EventReplayer&) = delete;
+
+  // Return an event that has the occurrences recorded on the specified
+  // 'channel' at their recorded times. An occurrence is delivered late if
+  // the event wasn't pulled at its time. The behavior is undefined unless
+  // the occurrences of 'channel' were recorded from an event of type
+  // 'boost::optional<T>', this function is called at most once for
+  // 'channel', and this replayer outlives the result.
+  template <typename T>
+  Behavior<boost::optional<T>> event(std::uint32_t channel);
+
+  // Return the time of the next occurrence of the log that wasn't reached by
+  // 'advance()', or infinity if there is none.
+  double nextTime();
+
+  // Read the records of the log up to the specified 'time' so that they are
+  // delivered by the pulls of the replayed events. Records of channels
+  // without a replayed event are dropped.
+  void advance(double time);
+
+  // Pull the specified 'root' at each of the remaining times of the log, in
+  // order and without waiting, until it is no longer defined. Return the
+  // number of pulls at which 'root' was defined. 'root' may be any object
+  // with a 'Behavior::pull()' like function.
+  template <typename Root>
+  std::size_t run(Root& root);
+
+ private:
+  // An occurrence read from the log.
+  struct Record {
+    double time;
+    std::vector<char> bytes;
+  };
+
+  // Read the next record of the log into the look-ahead of this replayer if
+  // it is empty. Return 'false' if the log has no more records.
+  bool peek();
+
+  // Remove from the records of the specified 'channel' the first one at or
+  // before the specified 'time' and load it into the specified 'record'.
+  // Return 'false' if there is no such record.
+  bool take(std::uint32_t channel, double time, Record* record);
+
+  std::istream& m_stream;
+  boost::optional<std::pair<std::uint32_t, Record>> m_next;
+  std::map<std::uint32_t, std::deque<Record>> m_channels;
+};
+
+// ===========================================================================
+//                 INLINE DEFINITIONS
+// ===========================================================================
+
+template <typename T>
+void EventRecorder_Codec<T>::encode(const T& value, std::vector<char>* out) {
+  const char* const bytes = reinterpret_cast<const char*>(&value);
+  out->insert(out->end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+T EventRecorder_Codec<T>::decode(const char* data, std::size_t size) {
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+inline void EventRecorder_Codec<std::string>::encode(const std::string& value,
+                                                     std::vector<char>* out) {
+  out->insert(out->end(), value.begin(), value.end());
+}
+
+inline std::string EventRecorder_Codec<std::string>::decode(
+    const char* data,
+    std::size_t size) {
+  return std::string(data, size);
+}
+
+template <typename T>
+Behavior<boost::optional<T>> EventRecorder::record(
+    std::uint32_t channel,
+    const Behavior<boost::optional<T>>& event) {
+  Behavior<boost::optional<T>> result =
+      Behavior<boost::optional<T>>::fromValuePullFunc(
+          [this, channel, event](double time) {
+            const boost::optional<T>* const occurrence =
+                event.pullPointer(time);
+            if (occurrence && *occurrence) {
+              std::vector<char> bytes;
+              EventRecorder_Codec<T>::encode(**occurrence, &bytes);
+              append(channel, time, bytes);
+            }
+            if (!occurrence)
+              return boost::optional<boost::optional<T>>();
+            return boost::make_optional(*occurrence);
+          });
+  result.nodeAddress()->setDerived({event.node()});
+  return result;
+}
+
+template <typename T>
+Behavior<boost::optional<T>> EventReplayer::event(std::uint32_t channel) {
+  m_channels[channel];
+  return Behavior<boost::optional<T>>::fromValuePullFunc(
+      [this, channel](double time) {
+        advance(time);
+        Record record;
+        if (!take(channel, time, &record))
+          return boost::make_optional(boost::optional<T>());
+        return boost::make_optional(boost::make_optional(
+            EventRecorder_Codec<T>::decode(record.bytes.data(),
+                                           record.bytes.size())));
+      });
+}
+
+template <typename Root>
+std::size_t EventReplayer::run(Root& root) {
+  std::size_t numPulls = 0;
+  for (double time = nextTime();
+       time < std::numeric_limits<double>::infinity();
+       time = nextTime()) {
+    if (!root.pull(time))
+      break;
+    ++numPulls;
+    // Occurrences of events that weren't pulled at 'time' are delivered late.
+    advance(time);
+  }
+  return numPulls;
+}
+}
+#endif
@@ -0,0 +1,11 @@
+#ifndef SFRP_EVENTRECORDER_T_HPP_
+#define SFRP_EVENTRECORDER_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void eventrecorderTests(stest::TestCollector&);
+}
+#endif
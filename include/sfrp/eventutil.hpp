@@ -161,8 +161,10 @@
 // when two occurences happen at the same time.
 
 #include <boost/optional.hpp>
+#include <boost/shared_ptr.hpp>
 #include <sboost/optionalutil.hpp>
 #include <sfrp/behavior.hpp>
+#include <sfrp/behaviorgrapharena.hpp>
 #include <sfrp/behaviormap.hpp>
 #include <sfrp/behavioroperators.hpp>
 #include <sfrp/behaviorutil.hpp>
@@ -178,18 +180,27 @@ struct EventUtil {
 
   // Return a behavior that has an initial value of the specified 'initialValue'
   // which changes to the a new value at every occurence of the specified
-  // 'event'.
+  // 'event'. The result reports a change of its value only at occurrences of
+  // 'event', see 'BehaviorNode::reportsChanges()', so that mappings of it are
+  // only evaluated when it changes.
   template <typename T>
   static Behavior<T> step(const T& t0,
                           const Behavior<boost::optional<T>>& event);
 
-  // Return an event that never occurs.
+  // Return an event that never occurs. The result is constant, see
+  // 'isNever()'.
   template <typename T>
   static Behavior<boost::optional<T>> never();
 
+  // Return 'true' if the specified 'event' is constant and never occurs, for
+  // instance if it was created with 'never()', and 'false' otherwise.
+  template <typename T>
+  static bool isNever(const Behavior<boost::optional<T>>& event);
+
   // Return an event whose occurances are the union of the occurances of the
   // specified 'leftEvent' and 'rightEvent'. Preference is given to 'leftEvent'
-  // if there is an occurance at the same time.
+  // if there is an occurance at the same time. If one of the events never
+  // occurs, see 'isNever()', the other is returned.
   template <typename A>
   static Behavior<boost::optional<A>> merge(
       const Behavior<boost::optional<A>>& leftEvent,
@@ -197,7 +208,8 @@ struct EventUtil {
 
   // Return an event whose occurances are the union of the occurances of the
   // specified 'leftEvent' and 'rightEvent'. If both events occur at the same
-  // time, the specified 'function' is used to collect the results.
+  // time, the specified 'function' is used to collect the results. If one of
+  // the events never occurs, see 'isNever()', the other is returned.
   template <typename Function, typename A>
   static Behavior<boost::optional<A>> mergeWith(
       Function function,
@@ -237,7 +249,9 @@ struct EventUtil {
 
   // Return an event with the same occurances of the specified 'event' except
   // when the specified 'boolBehavior' is false at those times, in which case
-  // the occurance is omitted.
+  // the occurance is omitted. If 'event' never occurs, see 'isNever()', it is
+  // returned. If 'boolBehavior' is constant, 'event' is returned if it is
+  // 'true' and an event that never occurs otherwise.
   template <typename A>
   static Behavior<boost::optional<A>> when(
       const Behavior<bool>& behavior,
@@ -258,17 +272,38 @@ template <typename T>
 Behavior<T> EventUtil::step(const T& t0,
                             const Behavior<boost::optional<T>>& event) {
   sfrp::Wormhole<T> wormhole(t0);
-  return wormhole.setInputBehavior(sfrp::BehaviorMap()(
-      &sboost::OptionalUtil::getValueOr<T>, event, wormhole.outputBehavior()));
+  const boost::shared_ptr<bool> occurred =
+      BehaviorGraphArena::makeShared<bool>(true);
+  Behavior<T> result = wormhole.setInputBehavior(sfrp::BehaviorMap()(
+      [occurred](const boost::optional<T>& occurrence, const T& previous) {
+        *occurred = bool(occurrence);
+        return sboost::OptionalUtil::getValueOr<T>(occurrence, previous);
+      },
+      event,
+      wormhole.outputBehavior()));
+  result.node()->setChangeHint([occurred]() { return *occurred; });
+  return result;
 }
 template <typename T>
 static Behavior<boost::optional<T>> EventUtil::never() {
   return sfrp::BehaviorUtil::always(boost::optional<T>());
 }
+template <typename T>
+bool EventUtil::isNever(const Behavior<boost::optional<T>>& event) {
+  if (!event.isConstant())
+    return false;
+  const boost::optional<boost::optional<T>> value = event.constantValue();
+  return value && !*value;
+}
+
 template <typename A>
 Behavior<boost::optional<A>> EventUtil::merge(
     const Behavior<boost::optional<A>>& leftEvent,
     const Behavior<boost::optional<A>>& rightEvent) {
+  if (isNever(leftEvent))
+    return rightEvent;
+  if (isNever(rightEvent))
+    return leftEvent;
   return sfrp::BehaviorMap()(
       sboost::OptionalUtil::alternative<A>, leftEvent, rightEvent);
 }
@@ -278,6 +313,10 @@ Behavior<boost::optional<A>> EventUtil::mergeWith(
     Function function,
     const Behavior<boost::optional<A>>& leftEvent,
     const Behavior<boost::optional<A>>& rightEvent) {
+  if (isNever(leftEvent))
+    return rightEvent;
+  if (isNever(rightEvent))
+    return leftEvent;
   return sfrp::BehaviorMap()([function](boost::optional<A> lhs,
                                         boost::optional<A> rhs) {
                                return lhs && rhs ? function(*lhs, *rhs)
@@ -344,6 +383,14 @@ template <typename A>
 static Behavior<boost::optional<A>> EventUtil::when(
     const Behavior<bool>& b,
     const Behavior<boost::optional<A>>& a) {
+  if (isNever(a))
+    return a;
+  if (b.isConstant()) {
+    const boost::optional<bool> value = b.constantValue();
+    if (!value)
+      return Behavior<boost::optional<A>>();
+    return *value ? a : sfrp::BehaviorUtil::always(boost::optional<A>());
+  }
   return sfrp::BehaviorOperators::ifThenElse(
       b, a, sfrp::BehaviorUtil::always(boost::optional<A>()));
 }
@@ -0,0 +1,61 @@
+#ifndef SFRP_GRAPHPOINTER_HPP_
+#define SFRP_GRAPHPOINTER_HPP_
+
+//@PURPOSE: Provide the reference counted pointer type of behavior graphs.
+//
+//@CLASSES:
+//  sfrp::GraphPointer: reference counted pointer to behavior graph state
+//
+//@SEE_ALSO: sfrp_behavior, sfrp_wormhole, sfrp_behaviorgrapharena
+//
+//@DESCRIPTION: This component provides an alias template, 'GraphPointer<T>',
+// for the pointers with which 'Behavior' objects refer to their nodes and
+// 'Wormhole' objects refer to their data. Behaviors are copied constantly, for
+// instance whenever a combinator captures its arguments in a pull function,
+// and every copy updates the reference count of a node.
+//
+// By default 'GraphPointer<T>' is 'boost::shared_ptr<T>', whose reference
+// counts are updated with atomic instructions so that graphs may be shared by
+// threads. When the 'SFRP_SINGLE_THREADED' macro is defined,
+// 'GraphPointer<T>' is 'boost::local_shared_ptr<T>' instead. Copies of a
+// 'boost::local_shared_ptr' update a plain, non-atomic count. Only the
+// conversions to and from 'boost::shared_ptr', for instance by
+// 'Behavior::node()', update the atomic count.
+//
+// Because the macro changes the layout of 'Behavior' and 'Wormhole' objects,
+// it must be defined consistently for every translation unit of a program,
+// including those of this library. A program built with the macro must
+// confine each graph to a single thread: a graph may be built on one thread
+// and then pulled on another, but no two threads may copy or destroy the
+// behaviors of the same graph concurrently. In particular, the parallel
+// argument pulls of 'BehaviorMap' may not be used, while the independent
+// instances of 'MonteCarloRunner' may.
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: Building a single-threaded program
+// - - - - - - - - - - - - - - - - - - - - - - -
+// A user interface whose graphs are built and pulled on its event thread is
+// built with 'CONFIG+=sfrp_single_threaded' with qmake, or with
+// '-Dsfrp_single_threaded=1' with gyp, which define 'SFRP_SINGLE_THREADED'
+// for this library and its dependents.
+
+#include <boost/shared_ptr.hpp>
+
+#ifdef SFRP_SINGLE_THREADED
+#include <boost/smart_ptr/make_local_shared.hpp>
+#endif
+
+namespace sfrp {
+
+#ifdef SFRP_SINGLE_THREADED
+template <typename T>
+using GraphPointer = boost::local_shared_ptr<T>;
+#else
+template <typename T>
+using GraphPointer = boost::shared_ptr<T>;
+#endif
+}
+#endif
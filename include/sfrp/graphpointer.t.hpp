@@ -0,0 +1,11 @@
+#ifndef SFRP_GRAPHPOINTER_T_HPP_
+#define SFRP_GRAPHPOINTER_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void graphpointerTests(stest::TestCollector&);
+}
+#endif
@@ -22,6 +22,11 @@
 // 'boost::none' is read from the underlying function, all that underlying
 // function's resources are freed up.
 //
+// An optional batch function may also be supplied. It is used by
+// 'pullBatch()' to compute the values of many increasing times in a single
+// call. When no batch function is supplied, 'pullBatch()' calls the
+// underlying function once for each time.
+//
 // Generally speaking, this class is intended for use as a tool to build up
 // an implementation of the sfrp_behavior component.
 //
@@ -52,6 +57,7 @@
 
 #include <boost/function.hpp>
 #include <boost/optional.hpp>
+#include <cstddef>  // std::size_t
 
 namespace sfrp {
 
@@ -66,6 +72,20 @@ struct IncreasingPartialTimeFunction {
   IncreasingPartialTimeFunction(
       boost::function<boost::optional<Value>(double)> valuePullFunc);
 
+  // Create a new 'IncreasingPartialTimeFunction<Value>' object from the
+  // specified 'valuePullFunc' and 'valuePullBatchFunc' functions.
+  // 'valuePullBatchFunc' is called with an array of times, the length of that
+  // array, and an output array of the same length. It returns the number of
+  // leading times at which the function is defined after storing the values
+  // for those times in the output array. The behavior is undefined unless
+  // 'valuePullFunc' satisfies the requirements of the single argument
+  // constructor and a call of 'valuePullBatchFunc' is equivelent to calling
+  // 'valuePullFunc' with each of its times in order.
+  IncreasingPartialTimeFunction(
+      boost::function<boost::optional<Value>(double)> valuePullFunc,
+      boost::function<std::size_t(const double*, std::size_t, Value*)>
+          valuePullBatchFunc);
+
   // Create a new 'IncreasingPartialTimeFunction' object that has the same
   // value as the specified 'other' object.
   IncreasingPartialTimeFunction(IncreasingPartialTimeFunction&& other);
@@ -85,6 +105,18 @@ struct IncreasingPartialTimeFunction {
   // 'boost::none', it will return 'boost::none' thereafter.
   boost::optional<Value> pull(const double time);
 
+  // Load into the specified 'out' array the values of this partial time
+  // function at each of the specified 'n' 'times' until the first time at
+  // which it is not defined. Return the number of values loaded. If the
+  // returned value is less than 'n', all subsequent calls to 'pull()' and
+  // 'pullBatch()' will indicate that this function is no longer defined and
+  // the underlying function objects are garbage collected.
+  //
+  // The behavior is undefined unless 'times' is strictly increasing, the
+  // first time satisfies the preconditions of 'pull()', and 'out' has room
+  // for 'n' values.
+  std::size_t pullBatch(const double* times, std::size_t n, Value* out);
+
   // Give this 'IncreasingPartialTimeFunction' object the same value as the
   // specified 'other' object.
   IncreasingPartialTimeFunction& operator=(
@@ -97,6 +129,8 @@ struct IncreasingPartialTimeFunction {
       const IncreasingPartialTimeFunction&);
 
   boost::function<boost::optional<Value>(double)> m_valuePullFunc;
+  boost::function<std::size_t(const double*, std::size_t, Value*)>
+      m_valuePullBatchFunc;
 };
 
 // ===========================================================================
@@ -108,10 +142,18 @@ IncreasingPartialTimeFunction<Value>::IncreasingPartialTimeFunction(
     boost::function<boost::optional<Value>(double)> valuePullFunc)
     : m_valuePullFunc(valuePullFunc) {}
 
+template <typename Value>
+IncreasingPartialTimeFunction<Value>::IncreasingPartialTimeFunction(
+    boost::function<boost::optional<Value>(double)> valuePullFunc,
+    boost::function<std::size_t(const double*, std::size_t, Value*)>
+        valuePullBatchFunc)
+    : m_valuePullFunc(valuePullFunc), m_valuePullBatchFunc(valuePullBatchFunc) {}
+
 template <typename Value>
 IncreasingPartialTimeFunction<Value>::IncreasingPartialTimeFunction(
     IncreasingPartialTimeFunction&& other) {
   m_valuePullFunc = std::move(other.m_valuePullFunc);
+  m_valuePullBatchFunc = std::move(other.m_valuePullBatchFunc);
 }
 
 template <typename Value>
@@ -121,16 +163,45 @@ boost::optional<Value> IncreasingPartialTimeFunction<Value>::pull(
     boost::optional<Value> result = m_valuePullFunc(time);
     if (!result) {
       m_valuePullFunc.clear();
+      m_valuePullBatchFunc.clear();
     }
     return result;
   } else {
     return boost::none;
   }
 }
+
+template <typename Value>
+std::size_t IncreasingPartialTimeFunction<Value>::pullBatch(
+    const double* times,
+    std::size_t n,
+    Value* out) {
+  if (m_valuePullFunc.empty())
+    return 0;
+
+  std::size_t count = 0;
+  if (!m_valuePullBatchFunc.empty()) {
+    count = m_valuePullBatchFunc(times, n, out);
+  } else {
+    for (; count < n; ++count) {
+      boost::optional<Value> result = m_valuePullFunc(times[count]);
+      if (!result)
+        break;
+      out[count] = std::move(*result);
+    }
+  }
+  if (count < n) {
+    m_valuePullFunc.clear();
+    m_valuePullBatchFunc.clear();
+  }
+  return count;
+}
 template <typename Value>
 IncreasingPartialTimeFunction<Value>& IncreasingPartialTimeFunction<Value>::operator=(
     IncreasingPartialTimeFunction&& other) {
   m_valuePullFunc = std::move(other.m_valuePullFunc);
+  m_valuePullBatchFunc = std::move(other.m_valuePullBatchFunc);
+  return *this;
 }
 }
 #endif
@@ -0,0 +1,11 @@
+#ifndef SFRP_INCREMENTALENGINE_T_HPP_
+#define SFRP_INCREMENTALENGINE_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void incrementalengineTests(stest::TestCollector&);
+}
+#endif
@@ -3,22 +3,29 @@
 
 #include <boost/optional.hpp>
 #include <sfrp/behavior.hpp>
-#include <utility>  // std::pair
+#include <sfrp/behaviorgrapharena.hpp>
 
 namespace sfrp {
 template <typename A>
 class JoinPullFunc {
+ public:
   typedef boost::optional<boost::optional<A>> result_type;
 
- public:
   JoinPullFunc(const sfrp::Behavior<boost::optional<sfrp::Behavior<A>>>&
                    joinableBehavior);
 
   result_type pullVal(const double time);
 
+  // Return 'true' if a pull switched into a behavior that is still defined.
+  bool isSwitched() const;
+
  private:
-  boost::optional<std::pair<double,  // dTime
-                            sfrp::Behavior<A>>> m_state;
+  // The behaviors created by pulls of 'm_joinableBehavior' are allocated from
+  // 'm_arena' so that the memory of the behavior switched from is reused by
+  // the next one. 'm_behavior' is empty when no behavior is switched into.
+  sfrp::BehaviorGraphArena m_arena;
+  double m_startTime;
+  sfrp::Behavior<A> m_behavior;
   sfrp::Behavior<boost::optional<sfrp::Behavior<A>>> m_joinableBehavior;
 };
 
@@ -29,48 +36,36 @@ class JoinPullFunc {
 template <typename A>
 JoinPullFunc<A>::JoinPullFunc(
     const sfrp::Behavior<boost::optional<sfrp::Behavior<A>>>& joinableBehavior)
-    : m_joinableBehavior(joinableBehavior), m_state(boost::none) {}
+    : m_arena(4096, sfrp::BehaviorGraphArena::e_RECYCLING),
+      m_startTime(0.0),
+      m_behavior(),
+      m_joinableBehavior(joinableBehavior) {}
+
+template <typename A>
+bool JoinPullFunc<A>::isSwitched() const {
+  return m_behavior.nodeAddress() != 0;
+}
 
 template <typename A>
 typename JoinPullFunc<A>::result_type JoinPullFunc<A>::pullVal(
     const double time) {
-  const boost::optional<boost::optional<sfrp::Behavior<A>>> opOpBehaviorA =
-      m_joinableBehavior.pull(time);
-  if (opOpBehaviorA) {
-    const boost::optional<sfrp::Behavior<A>>& opBehaviorA = *opOpBehaviorA;
-    if (opBehaviorA) {
-      m_state = boost::make_optional(std::make_pair(time, *opBehaviorA));
-      const boost::optional<A> opA = m_state->second.pull(0);
-      if (!opA)
-        m_state = boost::none;
-      return boost::make_optional(opA);
-    } else {
-      if (m_state) {
-        const boost::optional<A> opA =
-            m_state->second.pull(time - m_state->first);
-        if (opA)
-          return boost::make_optional(opA);
-        else {
-          m_state = boost::none;
-          return result_type(boost::optional<A>());
-        }
-      } else {
-        return result_type(boost::optional<A>());
-      }
-    }
-  } else {
-    if (m_state) {
-      const boost::optional<A> opA =
-          m_state->second.pull(time - m_state->first);
-      if (opA)
-        return boost::make_optional(opA);
-      else {
-        m_state = boost::none;
-        return boost::none;
-      }
-    } else
-      return boost::none;
+  const boost::optional<sfrp::Behavior<A>>* opBehaviorA;
+  {
+    sfrp::BehaviorGraphArenaScope scope(m_arena);
+    opBehaviorA = m_joinableBehavior.pullPointer(time);
   }
+  if (opBehaviorA && *opBehaviorA) {
+    m_startTime = time;
+    m_behavior = **opBehaviorA;
+  }
+
+  // 'm_behavior' becomes empty once it is no longer defined.
+  if (const A* const a = m_behavior.pullPointer(time - m_startTime))
+    return result_type(boost::optional<A>(*a));
+  else if (opBehaviorA)
+    return result_type(boost::optional<A>());
+  else
+    return boost::none;
 }
 }
 #endif
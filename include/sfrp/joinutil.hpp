@@ -1,11 +1,12 @@
 #ifndef SFRP_JOINUTIL_HPP_
 #define SFRP_JOINUTIL_HPP_
 
-#include <boost/bind.hpp>
-#include <boost/make_shared.hpp>
 #include <boost/optional.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
 #include <sfrp/behavior.hpp>
+#include <sfrp/behaviorcheckpoint.hpp>
+#include <sfrp/behaviorgrapharena.hpp>
 #include <sfrp/joinpullfunc.hpp>
 
 namespace sfrp {
@@ -16,6 +17,13 @@ struct JoinUtil {
   // the value must be in 0 state.  That is, calling pull with a time of 0
   // should
   // be valid.
+  // A join created while a 'BehaviorCheckpointScope' is active adds the
+  // behavior it switched into as unsavable state, so that checkpoints saved
+  // after the first switch can't be restored (see sfrp_behaviorcheckpoint).
+  // The behaviors created by pulls of 'behavior' are allocated from a
+  // recycling arena of the result, so switching between behaviors of the
+  // same shape reuses the memory of the behavior switched from (see
+  // sfrp_behaviorgrapharena).
   //..
   //  pmJoin : Behavior (Maybe (Behavior a)) → Behavior (Maybe a)
   //..
@@ -28,14 +36,28 @@ struct JoinUtil {
 //                 INLINE DEFINITIONS
 // ===========================================================================
 
+template <typename A>
+struct JoinUtil_PullFunc {
+  typedef typename JoinPullFunc<A>::result_type result_type;
+
+  result_type operator()(double time) const { return pullFunc->pullVal(time); }
+
+  boost::shared_ptr<JoinPullFunc<A>> pullFunc;
+};
+
 template <typename A>
 static sfrp::Behavior<boost::optional<A>> JoinUtil::join(
     const sfrp::Behavior<boost::optional<sfrp::Behavior<A>>>& behavior) {
-  const boost::shared_ptr<JoinPullFunc<A>> joinPullFuncPtr =
-      boost::make_shared<JoinPullFunc<A>>(behavior);
-
-  return sfrp::Behavior<boost::optional<A>>::fromValuePullFunc(
-      boost::bind(&JoinPullFunc<A>::pullVal, joinPullFuncPtr, _1));
+  const JoinUtil_PullFunc<A> pullFunc = {
+      BehaviorGraphArena::makeShared<JoinPullFunc<A>>(behavior)};
+  if (BehaviorCheckpoint* const checkpoint = BehaviorCheckpoint::current()) {
+    const boost::weak_ptr<JoinPullFunc<A>> weakPullFunc = pullFunc.pullFunc;
+    checkpoint->addUnsavableState([weakPullFunc]() {
+      const boost::shared_ptr<JoinPullFunc<A>> pullFunc = weakPullFunc.lock();
+      return pullFunc && pullFunc->isSwitched();
+    });
+  }
+  return sfrp::Behavior<boost::optional<A>>::fromValuePullFunc(pullFunc);
 }
 }
 #endif
@@ -6,9 +6,18 @@
 //@CLASSES:
 //  sfrp::MapValuePullFunc_ArgumentStorage: behavior storage metafunction
 //  sfrp::MapValuePullFunc_Result: MapValuePullFunc result type metafunction
+//  sfrp::MapValuePullFunc_IsBatchable: batch buffer support metafunction
+//  sfrp::MapValuePullFunc_BatchBuffer: reusable batch pull buffer
+//  sfrp::MapValuePullFunc_BatchPuller: behavior batch pull helper
+//  sfrp::MapValuePullFunc_BatchElement: batch buffer element access functor
+//  sfrp::MapValuePullFunc_IsPure: behavior purity functor
+//  sfrp::MapValuePullFunc_IsConstant: behavior constancy functor
+//  sfrp::MapValuePullFunc_NodeCollector: behavior graph node collection functor
+//  sfrp::MapValuePullFunc_VersionPuller: behavior value version pull functor
+//  sfrp::MapValuePullFunc_ParallelPuller: concurrent behavior pull helper
 //  sfrp::MapValuePullFunc: behavior function application functor
 //
-//@SEE_ALSO: sfrp_behaviormap
+//@SEE_ALSO: sfrp_behaviormap, sfrp_pullthreadpool
 //
 //@DESCRIPTION: This component includes several classes that relate to
 // implementation of a functor ('MapValuePullFunc') that, when executed, pulls
@@ -16,6 +25,53 @@
 // these classes to be used as helper functions in a behavior mapping
 // implementation.
 //
+// 'MapValuePullFunc' also provides a 'pullBatch()' function. When all of the
+// argument behaviors are pure, each argument is batch pulled into a buffer
+// once and the function is then applied to the buffers in a single loop. The
+// buffers belong to the 'MapValuePullFunc' object and are reused by later
+// batches. Otherwise, or when the value type of an argument isn't default
+// constructible, the argument behaviors are pulled one time at a time so that
+// the order of pulls, and hence the result, is identical to repeated calls of
+// 'operator()'.
+//
+// 'evaluate()' is the counterpart of 'pullBatch()' for pure arguments that
+// evaluates the argument behaviors, see 'Behavior::evaluate()', into buffers
+// of its own instead of pulling them. It may therefore be called with times
+// preceding those of previous pulls, for instance while the function is
+// applied to the values of a pull. Arguments that aren't 'Behavior' objects,
+// and arguments whose value types aren't default constructible, can't be
+// evaluated.
+//
+// 'isConstant()' is 'true' when all of the arguments are constant 'Behavior'
+// objects, see 'Behavior::isConstant()'. The function may then be applied
+// once, at any time, to compute the value for all time.
+//
+// A function without arguments can only produce different values by
+// depending upon state other than its arguments. A 'MapValuePullFunc' without
+// arguments is therefore never constant or pure, and has no argument nodes
+// through which its changes could be tracked.
+//
+// The graph nodes of the argument behaviors are available through
+// 'argumentNodes()' so that the result of a mapping may be tracked as a
+// derived node. See sfrp_behaviornode.
+//
+// 'argumentsUnchanged()' pulls the argument behaviors and compares their value
+// versions with those of a previous call. When every argument reports its
+// changes, the result of a mapping may reuse its previous value while the
+// arguments are unchanged without applying the function. See sfrp_behaviormap.
+//
+// A 'MapValuePullFunc' created with a 'PullThreadPool' pulls its argument
+// behaviors concurrently on that pool. Shared nodes of the argument graphs are
+// then evaluated at most once per time, see sfrp_behaviornode. Argument
+// behaviors that interact through wormholes must not be pulled concurrently.
+// 'pullBatch()' always pulls the argument behaviors sequentially.
+//
+// Argument 'Behavior' objects are pulled with a 'BehaviorReferencePuller' so
+// the function is applied to references to their cached values and no copies
+// of argument values are made when the function takes its arguments by
+// 'const' reference. Since all arguments are pulled at the same time, a pull of
+// one argument never invalidates the reference to the value of another.
+//
 // Usage
 // -----
 // This section illustrates intended use of this component.
@@ -56,18 +112,37 @@
 //  // 'result' is set to 'optional<string>("3")'
 //  boost::optional<std::string> result = mapValuePullFunc(0.0);
 //..
+// Several times can be evaluated at once with 'pullBatch()'.
+//..
+//  const double times[] = {1.0, 2.0, 3.0};
+//  std::string results[3];
+//  // 'count' is set to '3'
+//  std::size_t count = mapValuePullFunc.pullBatch(times, 3, results);
+//..
 
+#include <boost/function.hpp>
 #include <boost/fusion/include/all.hpp>
+#include <boost/fusion/include/at_c.hpp>
 #include <boost/fusion/include/as_vector.hpp>
+#include <boost/fusion/include/for_each.hpp>
 #include <boost/fusion/include/invoke.hpp>
 #include <boost/fusion/include/mpl.hpp>
 #include <boost/fusion/include/transform.hpp>
+#include <boost/fusion/include/vector.hpp>
 #include <boost/mpl/transform.hpp>
 #include <boost/mpl/vector.hpp>
+#include <boost/shared_ptr.hpp>
 #include <sboost/optionalutil.hpp>  // OptionalUtil_HasValue
 #include <sfrp/behavior.hpp>
+#include <sfrp/behaviornode.hpp>
 #include <sfrp/behaviorpuller.hpp>
+#include <sfrp/pullthreadpool.hpp>
+#include <cstddef>      // std::size_t
+#include <cstdint>      // std::uint64_t
+#include <memory>       // std::unique_ptr
 #include <type_traits>  // std::remove_const, std::remove_reference
+#include <utility>      // std::pair
+#include <vector>
 
 namespace sfrp {
 
@@ -112,6 +187,242 @@ struct MapValuePullFunc_Result {
           sboost::OptionalUtil_GetValue>::type>::type> type;
 };
 
+// This class implements a metafunction that is 'true' if the value types of
+// all of the specified 'ArgumentBehaviors' are default constructible, so that
+// the behaviors may be batch pulled into buffers, and 'false' otherwise.
+template <typename... ArgumentBehaviors>
+struct MapValuePullFunc_IsBatchable;
+
+template <>
+struct MapValuePullFunc_IsBatchable<> : std::true_type {};
+
+template <typename ArgumentBehavior, typename... ArgumentBehaviors>
+struct MapValuePullFunc_IsBatchable<ArgumentBehavior, ArgumentBehaviors...>
+    : std::integral_constant<
+          bool,
+          std::is_default_constructible<typename std::remove_const<
+              typename std::remove_reference<ArgumentBehavior>::type>::type::
+                                            type>::value &&
+              MapValuePullFunc_IsBatchable<ArgumentBehaviors...>::value> {};
+
+// This class implements a buffer of values that grows to hold the largest
+// batch pulled into it. Copies of a buffer are empty.
+template <typename T>
+struct MapValuePullFunc_BatchBuffer {
+  typedef T value_type;
+
+  // Create an empty buffer.
+  MapValuePullFunc_BatchBuffer();
+
+  // Create an empty buffer. The values of the specified 'other' buffer aren't
+  // copied.
+  MapValuePullFunc_BatchBuffer(const MapValuePullFunc_BatchBuffer& other);
+
+  // Leave this buffer unchanged and return a reference to it.
+  MapValuePullFunc_BatchBuffer& operator=(
+      const MapValuePullFunc_BatchBuffer& other);
+
+  // Return the address of room for the specified 'n' values in this buffer,
+  // growing it if it is smaller. The values previously held are unspecified.
+  T* reserve(std::size_t n);
+
+  // Return the value at the specified 'index' of this buffer. The behavior is
+  // undefined unless 'index' is less than the size of the last reservation.
+  const T& operator[](std::size_t index) const;
+
+ private:
+  std::unique_ptr<T[]> m_values;
+  std::size_t m_capacity;
+};
+
+// This class implements a helper that batch pulls the behaviors from the
+// specified 'Index' up to the specified 'Size' of a fusion sequence of
+// behaviors into the corresponding elements of a fusion sequence of buffers.
+template <int Index, int Size>
+struct MapValuePullFunc_BatchPuller {
+  // Load into each of the specified 'buffers' the values of the corresponding
+  // behavior of the specified 'arguments' at the specified 'n' 'times' and
+  // lower the specified 'count' to the number of values at which that
+  // behavior is defined.
+  template <typename Arguments, typename Buffers>
+  static void pullBatch(const Arguments& arguments,
+                        Buffers* buffers,
+                        const double* times,
+                        std::size_t n,
+                        std::size_t* count);
+
+  // Load into each of the specified 'buffers' the evaluations, see
+  // 'Behavior::evaluate()', of the corresponding behavior of the specified
+  // 'arguments' at the specified 'n' 'times' and lower the specified 'count'
+  // to the number of values evaluated for that behavior.
+  template <typename Arguments, typename Buffers>
+  static void evaluate(const Arguments& arguments,
+                       Buffers* buffers,
+                       const double* times,
+                       std::size_t n,
+                       std::size_t* count);
+
+ private:
+  // Load into the specified 'out' array the evaluations of the specified
+  // 'behavior' at the specified 'n' 'times' and return the number of values
+  // loaded.
+  template <typename T>
+  static std::size_t evaluateArgument(const Behavior<T>& behavior,
+                                      const double* times,
+                                      std::size_t n,
+                                      T* out);
+
+  // Return 0 since the specified 'argument' can't be evaluated.
+  template <typename Argument, typename T>
+  static std::size_t evaluateArgument(const Argument& argument,
+                                      const double* times,
+                                      std::size_t n,
+                                      T* out);
+};
+
+template <int Size>
+struct MapValuePullFunc_BatchPuller<Size, Size> {
+  template <typename Arguments, typename Buffers>
+  static void pullBatch(const Arguments& arguments,
+                        Buffers* buffers,
+                        const double* times,
+                        std::size_t n,
+                        std::size_t* count) {}
+
+  template <typename Arguments, typename Buffers>
+  static void evaluate(const Arguments& arguments,
+                       Buffers* buffers,
+                       const double* times,
+                       std::size_t n,
+                       std::size_t* count) {}
+};
+
+// This class implements a functor that returns the element at a particular
+// index of a buffer loaded by 'MapValuePullFunc_BatchPuller'.
+struct MapValuePullFunc_BatchElement {
+  // Create a new 'MapValuePullFunc_BatchElement' object that accesses the
+  // specified 'index'.
+  explicit MapValuePullFunc_BatchElement(std::size_t index);
+
+  // Return the result type of applying this functor with the specified
+  // 'FunctorApplicationExpression'.
+  template <typename FunctorApplicationExpression>
+  struct result;
+
+  // Return the element of the specified 'buffer' at the index of this object.
+  // The behavior is undefined unless the index is less than the number of
+  // values loaded into 'buffer'.
+  template <typename T>
+  const T& operator()(const MapValuePullFunc_BatchBuffer<T>& buffer) const;
+
+ private:
+  std::size_t m_index;
+};
+
+// This class implements a predicate that is 'true' for pure behaviors.
+struct MapValuePullFunc_IsPure {
+  typedef bool result_type;
+
+  // Return 'true' if the specified 'behavior' is pure and 'false' otherwise.
+  template <typename Behavior>
+  bool operator()(const Behavior& behavior) const;
+};
+
+// This class implements a predicate that is 'true' for constant 'Behavior'
+// objects. Other arguments, such as static behaviors, are never considered
+// constant.
+struct MapValuePullFunc_IsConstant {
+  typedef bool result_type;
+
+  // Return 'true' if the specified 'behavior' is constant and 'false'
+  // otherwise.
+  template <typename T>
+  bool operator()(const Behavior<T>& behavior) const;
+
+  // Return 'false'.
+  template <typename Argument>
+  bool operator()(const Argument& argument) const;
+};
+
+// This class implements a functor that collects the graph nodes of behaviors.
+// Arguments that aren't 'Behavior' objects, such as static behaviors, have no
+// node and are recorded as unknown.
+struct MapValuePullFunc_NodeCollector {
+  // Create a new 'MapValuePullFunc_NodeCollector' object that appends nodes to
+  // the specified 'nodes' and sets the specified 'allKnown' to 'false' when an
+  // argument without a node is encountered.
+  MapValuePullFunc_NodeCollector(
+      std::vector<boost::shared_ptr<BehaviorNode>>* nodes,
+      bool* allKnown);
+
+  // Append the node of the specified 'behavior'.
+  template <typename T>
+  void operator()(const Behavior<T>& behavior) const;
+
+  // Record that the specified 'argument' has no known node.
+  template <typename Argument>
+  void operator()(const Argument& argument) const;
+
+ private:
+  std::vector<boost::shared_ptr<BehaviorNode>>* m_nodes;
+  bool* m_allKnown;
+};
+
+// This class implements a functor that pulls behaviors and compares their
+// value versions with a vector of previously recorded versions, replacing the
+// recorded versions with the current ones. Arguments that aren't 'Behavior'
+// objects have no version and always compare as changed.
+struct MapValuePullFunc_VersionPuller {
+  // Create a new 'MapValuePullFunc_VersionPuller' object that pulls behaviors
+  // at the specified 'time', updates the specified 'versions' and sets the
+  // specified 'unchanged' to 'false' when a version differs or a behavior is
+  // no longer defined.
+  MapValuePullFunc_VersionPuller(double time,
+                                 std::vector<std::uint64_t>* versions,
+                                 bool* unchanged);
+
+  // Pull the specified 'behavior' and compare its value version with the
+  // next recorded version.
+  template <typename T>
+  void operator()(const Behavior<T>& behavior) const;
+
+  // Record that the specified 'argument' may have changed.
+  template <typename Argument>
+  void operator()(const Argument& argument) const;
+
+ private:
+  double m_time;
+  std::vector<std::uint64_t>* m_versions;
+  bool* m_unchanged;
+  mutable std::size_t m_index;
+};
+
+// This class implements a helper that creates the tasks that concurrently pull
+// the behaviors from the specified 'Index' up to the specified 'Size' of a
+// fusion sequence of behaviors.
+template <int Index, int Size>
+struct MapValuePullFunc_ParallelPuller {
+  // Append to the specified 'tasks' one task for each of the behaviors of the
+  // specified 'arguments' that loads into the corresponding element of the
+  // specified 'results' the pull of that behavior at the specified 'time'.
+  // The behavior is undefined unless 'arguments' and 'results' outlive the
+  // tasks.
+  template <typename Arguments, typename Results>
+  static void appendTasks(const Arguments& arguments,
+                          Results* results,
+                          double time,
+                          std::vector<boost::function<void()>>* tasks);
+};
+
+template <int Size>
+struct MapValuePullFunc_ParallelPuller<Size, Size> {
+  template <typename Arguments, typename Results>
+  static void appendTasks(const Arguments& arguments,
+                          Results* results,
+                          double time,
+                          std::vector<boost::function<void()>>* tasks) {}
+};
+
 // This class implements a functor that, when called with a time argument, pulls
 // a list of behaviors and applies a function to the results of those pulls.
 template <typename Function, typename... ArgumentBehaviors>
@@ -124,6 +435,15 @@ struct MapValuePullFunc {
   // qualified Behaviors.
   MapValuePullFunc(Function function, ArgumentBehaviors... argumentBehaviors);
 
+  // Create a new 'MapValuePullFunc' object with the specified 'function' and
+  // 'argumentBehaviors' that pulls its argument behaviors concurrently on the
+  // specified 'pool'. The behavior is undefined unless 'pool' outlives this
+  // object and its copies and the argument behaviors may be pulled
+  // concurrently.
+  MapValuePullFunc(PullThreadPool& pool,
+                   Function function,
+                   ArgumentBehaviors... argumentBehaviors);
+
   // The result type of the 'operator()' function.
   typedef typename MapValuePullFunc_Result<Function, ArgumentBehaviors...>::type
       result_type;
@@ -133,28 +453,301 @@ struct MapValuePullFunc {
   // those pulls. Otherwise, return 'boost::none'.
   result_type operator()(const double time) const;
 
+  // Load into the specified 'out' array the results of calling this object
+  // with each of the specified 'n' 'times' until the first result that is
+  // 'boost::none'. Return the number of values loaded. The behavior is
+  // undefined unless 'times' is strictly increasing, the first time satisfies
+  // the preconditions of 'Behavior::pull()' for all argument behaviors, and
+  // 'out' has room for 'n' values.
+  std::size_t pullBatch(const double* times,
+                        std::size_t n,
+                        typename result_type::value_type* out) const;
+
+  // Load into the specified 'out' array the results of applying the function
+  // to the evaluations of the argument behaviors, see 'Behavior::evaluate()',
+  // at each of the specified 'n' 'times' until the first time at which an
+  // argument isn't evaluated. Return the number of values loaded. No argument
+  // behavior is pulled. The behavior is undefined unless 'times' is strictly
+  // increasing and 'out' has room for 'n' values.
+  std::size_t evaluate(const double* times,
+                       std::size_t n,
+                       typename result_type::value_type* out) const;
+
+  // Return 'true' if there is at least one argument behavior and all of the
+  // argument behaviors are pure, and 'false' otherwise.
+  bool isPure() const;
+
+  // Return 'true' if there is at least one argument behavior and all of the
+  // argument behaviors are constant 'Behavior' objects, and 'false'
+  // otherwise.
+  bool isConstant() const;
+
+  // Load into the specified 'nodes' the graph nodes of the argument behaviors.
+  // Return 'true' if there is at least one argument and every argument is a
+  // 'Behavior', and 'false' otherwise.
+  bool argumentNodes(std::vector<boost::shared_ptr<BehaviorNode>>* nodes) const;
+
+  // Pull the argument behaviors at the specified 'time' and return 'true' if
+  // they are all defined and their value versions equal the specified
+  // 'versions', and 'false' otherwise. Load the current versions into
+  // 'versions' in either case. The behavior is undefined unless the
+  // preconditions of 'Behavior::pull()' hold for 'time'.
+  bool argumentsUnchanged(double time,
+                          std::vector<std::uint64_t>* versions) const;
+
  private:
+  typedef typename MapValuePullFunc_ArgumentStorage<ArgumentBehaviors...>::type
+      ArgumentStorage;
+
+  typedef typename boost::fusion::result_of::as_vector<
+      typename boost::fusion::result_of::transform<
+          const ArgumentStorage,
+          BehaviorReferencePuller>::type>::type PullResults;
+
+  typedef boost::fusion::vector<
+      MapValuePullFunc_BatchBuffer<typename std::remove_const<
+          typename std::remove_reference<ArgumentBehaviors>::type>::type::
+                                       type>...> BatchBuffers;
+
+  // Return the results of pulling the argument behaviors at the specified
+  // 'time' on the pool of this object.
+  PullResults pullParallel(const double time) const;
+
+  // Load into the specified 'out' array the results of calling this object
+  // with each of the specified 'n' 'times' until the first result that is
+  // 'boost::none' and return the number of values loaded. The first overload
+  // batch pulls the arguments into the buffers of this object, the second
+  // pulls them one time at a time.
+  std::size_t pullBuffered(const double* times,
+                           std::size_t n,
+                           typename result_type::value_type* out,
+                           std::true_type) const;
+  std::size_t pullBuffered(const double* times,
+                           std::size_t n,
+                           typename result_type::value_type* out,
+                           std::false_type) const;
+
+  // Load into the specified 'out' array the results of calling this object
+  // with the evaluations of the argument behaviors at each of the specified
+  // 'n' 'times' until the first time at which an argument isn't evaluated and
+  // return the number of values loaded. The first overload evaluates the
+  // arguments into buffers of its own, the second, used when the arguments
+  // can't be buffered, loads no values.
+  std::size_t evaluateBuffered(const double* times,
+                               std::size_t n,
+                               typename result_type::value_type* out,
+                               std::true_type) const;
+  std::size_t evaluateBuffered(const double* times,
+                               std::size_t n,
+                               typename result_type::value_type* out,
+                               std::false_type) const;
+
   Function m_function;
-  typename MapValuePullFunc_ArgumentStorage<ArgumentBehaviors...>::type
-      m_argumentBehaviors;
+  ArgumentStorage m_argumentBehaviors;
+  PullThreadPool* m_pool;
+  mutable BatchBuffers m_batchBuffers;
 };
 
 // ===========================================================================
 //                 INLINE DEFINITIONS
 // ===========================================================================
 
+template <typename T>
+MapValuePullFunc_BatchBuffer<T>::MapValuePullFunc_BatchBuffer()
+    : m_values(), m_capacity(0) {}
+
+template <typename T>
+MapValuePullFunc_BatchBuffer<T>::MapValuePullFunc_BatchBuffer(
+    const MapValuePullFunc_BatchBuffer& other)
+    : m_values(), m_capacity(0) {}
+
+template <typename T>
+MapValuePullFunc_BatchBuffer<T>& MapValuePullFunc_BatchBuffer<T>::operator=(
+    const MapValuePullFunc_BatchBuffer& other) {
+  return *this;
+}
+
+template <typename T>
+T* MapValuePullFunc_BatchBuffer<T>::reserve(std::size_t n) {
+  if (n > m_capacity) {
+    m_values.reset(new T[n]);
+    m_capacity = n;
+  }
+  return m_values.get();
+}
+
+template <typename T>
+const T& MapValuePullFunc_BatchBuffer<T>::operator[](std::size_t index) const {
+  return m_values[index];
+}
+
+template <int Index, int Size>
+template <typename Arguments, typename Buffers>
+void MapValuePullFunc_BatchPuller<Index, Size>::pullBatch(
+    const Arguments& arguments,
+    Buffers* buffers,
+    const double* times,
+    std::size_t n,
+    std::size_t* count) {
+  const std::size_t defined = boost::fusion::at_c<Index>(arguments).pullBatch(
+      times, n, boost::fusion::at_c<Index>(*buffers).reserve(n));
+  if (defined < *count)
+    *count = defined;
+  MapValuePullFunc_BatchPuller<Index + 1, Size>::pullBatch(
+      arguments, buffers, times, n, count);
+}
+
+template <int Index, int Size>
+template <typename Arguments, typename Buffers>
+void MapValuePullFunc_BatchPuller<Index, Size>::evaluate(
+    const Arguments& arguments,
+    Buffers* buffers,
+    const double* times,
+    std::size_t n,
+    std::size_t* count) {
+  const std::size_t defined =
+      evaluateArgument(boost::fusion::at_c<Index>(arguments),
+                       times,
+                       n,
+                       boost::fusion::at_c<Index>(*buffers).reserve(n));
+  if (defined < *count)
+    *count = defined;
+  MapValuePullFunc_BatchPuller<Index + 1, Size>::evaluate(
+      arguments, buffers, times, n, count);
+}
+
+template <int Index, int Size>
+template <typename T>
+std::size_t MapValuePullFunc_BatchPuller<Index, Size>::evaluateArgument(
+    const Behavior<T>& behavior,
+    const double* times,
+    std::size_t n,
+    T* out) {
+  return behavior.evaluate(times, n, out);
+}
+
+template <int Index, int Size>
+template <typename Argument, typename T>
+std::size_t MapValuePullFunc_BatchPuller<Index, Size>::evaluateArgument(
+    const Argument& argument,
+    const double* times,
+    std::size_t n,
+    T* out) {
+  return 0;
+}
+
+template <typename BufferArg>
+struct MapValuePullFunc_BatchElement::result<
+    MapValuePullFunc_BatchElement(BufferArg)> {
+  typedef typename std::remove_const<
+      typename std::remove_reference<BufferArg>::type>::type::value_type
+      Element;
+  typedef const Element& type;
+};
+
+template <typename T>
+const T& MapValuePullFunc_BatchElement::operator()(
+    const MapValuePullFunc_BatchBuffer<T>& buffer) const {
+  return buffer[m_index];
+}
+
+template <typename Behavior>
+bool MapValuePullFunc_IsPure::operator()(const Behavior& behavior) const {
+  return behavior.isPure();
+}
+
+template <typename T>
+bool MapValuePullFunc_IsConstant::operator()(
+    const Behavior<T>& behavior) const {
+  return behavior.isConstant();
+}
+
+template <typename Argument>
+bool MapValuePullFunc_IsConstant::operator()(const Argument& argument) const {
+  return false;
+}
+
+template <typename T>
+void MapValuePullFunc_NodeCollector::operator()(
+    const Behavior<T>& behavior) const {
+  m_nodes->push_back(behavior.node());
+}
+
+template <typename Argument>
+void MapValuePullFunc_NodeCollector::operator()(
+    const Argument& argument) const {
+  *m_allKnown = false;
+}
+
+inline MapValuePullFunc_VersionPuller::MapValuePullFunc_VersionPuller(
+    double time,
+    std::vector<std::uint64_t>* versions,
+    bool* unchanged)
+    : m_time(time), m_versions(versions), m_unchanged(unchanged), m_index(0) {}
+
+template <typename T>
+void MapValuePullFunc_VersionPuller::operator()(
+    const Behavior<T>& behavior) const {
+  if (!behavior.pullPointer(m_time))
+    *m_unchanged = false;
+  const std::uint64_t version = behavior.valueVersion();
+  if (m_index == m_versions->size()) {
+    *m_unchanged = false;
+    m_versions->push_back(version);
+  } else if ((*m_versions)[m_index] != version) {
+    *m_unchanged = false;
+    (*m_versions)[m_index] = version;
+  }
+  ++m_index;
+}
+
+template <typename Argument>
+void MapValuePullFunc_VersionPuller::operator()(
+    const Argument& argument) const {
+  *m_unchanged = false;
+}
+
+template <int Index, int Size>
+template <typename Arguments, typename Results>
+void MapValuePullFunc_ParallelPuller<Index, Size>::appendTasks(
+    const Arguments& arguments,
+    Results* results,
+    double time,
+    std::vector<boost::function<void()>>* tasks) {
+  tasks->push_back([&arguments, results, time]() {
+    const BehaviorNodeConcurrencyScope concurrencyScope;
+    boost::fusion::at_c<Index>(*results) =
+        BehaviorReferencePuller(time)(boost::fusion::at_c<Index>(arguments));
+  });
+  MapValuePullFunc_ParallelPuller<Index + 1, Size>::appendTasks(
+      arguments, results, time, tasks);
+}
+
+template <typename Function, typename... ArgumentBehaviors>
+MapValuePullFunc<Function, ArgumentBehaviors...>::MapValuePullFunc(
+    Function function,
+    ArgumentBehaviors... argumentBehaviors)
+    : m_function(function),
+      m_argumentBehaviors(argumentBehaviors...),
+      m_pool(0) {}
+
 template <typename Function, typename... ArgumentBehaviors>
 MapValuePullFunc<Function, ArgumentBehaviors...>::MapValuePullFunc(
+    PullThreadPool& pool,
     Function function,
     ArgumentBehaviors... argumentBehaviors)
-    : m_function(function), m_argumentBehaviors(argumentBehaviors...) {}
+    : m_function(function),
+      m_argumentBehaviors(argumentBehaviors...),
+      m_pool(&pool) {}
 
 template <typename Function, typename... ArgumentBehaviors>
 typename MapValuePullFunc<Function, ArgumentBehaviors...>::result_type
 MapValuePullFunc<Function, ArgumentBehaviors...>::
 operator()(const double time) const {
-  const auto pullResults = boost::fusion::as_vector(
-      boost::fusion::transform(m_argumentBehaviors, BehaviorPuller(time)));
+  const auto pullResults =
+      m_pool ? pullParallel(time)
+             : boost::fusion::as_vector(boost::fusion::transform(
+                   m_argumentBehaviors, BehaviorReferencePuller(time)));
 
   const bool allPullsHaveValue =
       boost::fusion::all(pullResults, sboost::OptionalUtil_HasValue());
@@ -168,5 +761,139 @@ operator()(const double time) const {
     return boost::none;
   }
 }
+
+template <typename Function, typename... ArgumentBehaviors>
+std::size_t MapValuePullFunc<Function, ArgumentBehaviors...>::pullBatch(
+    const double* times,
+    std::size_t n,
+    typename result_type::value_type* out) const {
+  // Arguments that aren't pure may depend upon each other through wormholes
+  // so they must be pulled in time order.
+  if (!isPure())
+    return pullBuffered(times, n, out, std::false_type());
+  return pullBuffered(times,
+                      n,
+                      out,
+                      MapValuePullFunc_IsBatchable<ArgumentBehaviors...>());
+}
+
+template <typename Function, typename... ArgumentBehaviors>
+std::size_t MapValuePullFunc<Function, ArgumentBehaviors...>::pullBuffered(
+    const double* times,
+    std::size_t n,
+    typename result_type::value_type* out,
+    std::true_type) const {
+  std::size_t count = n;
+  MapValuePullFunc_BatchPuller<0, sizeof...(ArgumentBehaviors)>::pullBatch(
+      m_argumentBehaviors, &m_batchBuffers, times, n, &count);
+
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = boost::fusion::invoke(
+        m_function,
+        boost::fusion::transform(m_batchBuffers,
+                                 MapValuePullFunc_BatchElement(i)));
+  }
+  return count;
+}
+
+template <typename Function, typename... ArgumentBehaviors>
+std::size_t MapValuePullFunc<Function, ArgumentBehaviors...>::pullBuffered(
+    const double* times,
+    std::size_t n,
+    typename result_type::value_type* out,
+    std::false_type) const {
+  for (std::size_t i = 0; i < n; ++i) {
+    result_type result = (*this)(times[i]);
+    if (!result)
+      return i;
+    out[i] = std::move(*result);
+  }
+  return n;
+}
+
+template <typename Function, typename... ArgumentBehaviors>
+std::size_t MapValuePullFunc<Function, ArgumentBehaviors...>::evaluate(
+    const double* times,
+    std::size_t n,
+    typename result_type::value_type* out) const {
+  return evaluateBuffered(
+      times, n, out, MapValuePullFunc_IsBatchable<ArgumentBehaviors...>());
+}
+
+template <typename Function, typename... ArgumentBehaviors>
+std::size_t MapValuePullFunc<Function, ArgumentBehaviors...>::evaluateBuffered(
+    const double* times,
+    std::size_t n,
+    typename result_type::value_type* out,
+    std::true_type) const {
+  // Evaluations leave this object unchanged, so they get buffers of their
+  // own.
+  BatchBuffers buffers;
+  std::size_t count = sizeof...(ArgumentBehaviors) > 0 ? n : 0;
+  MapValuePullFunc_BatchPuller<0, sizeof...(ArgumentBehaviors)>::evaluate(
+      m_argumentBehaviors, &buffers, times, n, &count);
+
+  for (std::size_t i = 0; i < count; ++i) {
+    out[i] = boost::fusion::invoke(
+        m_function,
+        boost::fusion::transform(buffers, MapValuePullFunc_BatchElement(i)));
+  }
+  return count;
+}
+
+template <typename Function, typename... ArgumentBehaviors>
+std::size_t MapValuePullFunc<Function, ArgumentBehaviors...>::evaluateBuffered(
+    const double* times,
+    std::size_t n,
+    typename result_type::value_type* out,
+    std::false_type) const {
+  return 0;
+}
+
+template <typename Function, typename... ArgumentBehaviors>
+bool MapValuePullFunc<Function, ArgumentBehaviors...>::isPure() const {
+  return sizeof...(ArgumentBehaviors) > 0 &&
+         boost::fusion::all(m_argumentBehaviors, MapValuePullFunc_IsPure());
+}
+
+template <typename Function, typename... ArgumentBehaviors>
+bool MapValuePullFunc<Function, ArgumentBehaviors...>::isConstant() const {
+  return sizeof...(ArgumentBehaviors) > 0 &&
+         boost::fusion::all(m_argumentBehaviors,
+                            MapValuePullFunc_IsConstant());
+}
+
+template <typename Function, typename... ArgumentBehaviors>
+typename MapValuePullFunc<Function, ArgumentBehaviors...>::PullResults
+MapValuePullFunc<Function, ArgumentBehaviors...>::pullParallel(
+    const double time) const {
+  PullResults pullResults;
+  std::vector<boost::function<void()>> tasks;
+  tasks.reserve(sizeof...(ArgumentBehaviors));
+  MapValuePullFunc_ParallelPuller<0, sizeof...(ArgumentBehaviors)>::appendTasks(
+      m_argumentBehaviors, &pullResults, time, &tasks);
+  m_pool->run(tasks);
+  return pullResults;
+}
+
+template <typename Function, typename... ArgumentBehaviors>
+bool MapValuePullFunc<Function, ArgumentBehaviors...>::argumentNodes(
+    std::vector<boost::shared_ptr<BehaviorNode>>* nodes) const {
+  bool allKnown = true;
+  boost::fusion::for_each(m_argumentBehaviors,
+                          MapValuePullFunc_NodeCollector(nodes, &allKnown));
+  return sizeof...(ArgumentBehaviors) > 0 && allKnown;
+}
+
+template <typename Function, typename... ArgumentBehaviors>
+bool MapValuePullFunc<Function, ArgumentBehaviors...>::argumentsUnchanged(
+    double time,
+    std::vector<std::uint64_t>* versions) const {
+  bool unchanged = true;
+  boost::fusion::for_each(
+      m_argumentBehaviors,
+      MapValuePullFunc_VersionPuller(time, versions, &unchanged));
+  return unchanged;
+}
 }
 #endif
@@ -0,0 +1,235 @@
+#ifndef SFRP_MONTECARLORUNNER_HPP_
+#define SFRP_MONTECARLORUNNER_HPP_
+
+//@PURPOSE: Provide a parallel runner of many independent behavior graphs.
+//
+//@CLASSES:
+//  sfrp::MonteCarloRunner: runner of independent graph instances on a pool
+//  sfrp::MonteCarloRunner_NodeOwners: registry of the nodes of instances
+//
+//@SEE_ALSO: sfrp_pullthreadpool, sfrp_behaviorgrapharena, sfrp_graphpointer
+//
+//@DESCRIPTION: This component provides a single class, 'MonteCarloRunner',
+// that builds many instances of a behavior graph with a factory, pulls each of
+// them to completion on a pool of threads and collects their final values.
+// This is typically used to run thousands of simulations of the same scenario
+// with different inputs.
+//
+// An instance is pulled at times '0', 'timeStep', '2 * timeStep', and so on,
+// until it is no longer defined or the next time would exceed an end time.
+// Its result is its value at the last time at which it was defined, or
+// 'boost::none' if it wasn't defined at time '0'.
+//
+// Every thread running instances, including the thread calling 'run()',
+// repeatedly claims the next instance that hasn't been started and runs it
+// from start to finish, so the threads that run short instances go on to run
+// more of them. Each thread builds its instances within the scope of its own
+// recycling 'BehaviorGraphArena', which reuses the memory of the finished
+// instances for the next ones.
+//
+// Thread Confinement
+// ------------------
+// An instance is built, pulled and destroyed by a single thread, so the nodes
+// of an instance are never accessed by two threads. Instances are therefore
+// built and pulled as single-threaded graphs: they run outside of any
+// 'BehaviorNodeConcurrencyScope', so their nodes are never locked, and in
+// builds with 'SFRP_SINGLE_THREADED' their reference counts aren't atomic
+// (see sfrp_graphpointer).
+//
+// The runner can't ensure this for nodes that the factory doesn't create
+// itself: a factory must not return or capture behaviors that exist outside
+// of the instance it builds, since those would be shared by instances running
+// on different threads. In builds with assertions, the runner walks the graph
+// of every instance it builds, through the children of derived nodes (see
+// sfrp_behaviornode), and asserts that none of its nodes belongs to another
+// running instance. Similarly, 'run()' must not be called within a
+// 'BehaviorHashConsScope' or a 'BehaviorCheckpointScope', whose tables would
+// otherwise be shared by the instances built on the calling thread and those
+// built by other threads.
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: Estimating the mean score of a game
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Say 'makeGame' builds a game with the players' moves generated from a given
+// random seed. The game is undefined once it is over and its value is the
+// score so far.
+//..
+//  sfrp::MonteCarloRunner runner;
+//  const std::vector<boost::optional<double>> scores = runner.run<double>(
+//      10000,
+//      [](std::size_t index) { return makeGame(/* seed */ index); },
+//      1.0 / 60.0,
+//      600.0);
+//..
+
+#include <boost/function.hpp>
+#include <boost/optional.hpp>
+#include <sfrp/behavior.hpp>
+#include <sfrp/behaviorcheckpoint.hpp>
+#include <sfrp/behaviorgrapharena.hpp>
+#include <sfrp/behaviorhashcons.hpp>
+#include <sfrp/behaviornode.hpp>
+#include <sfrp/behaviorschedule.hpp>
+#include <sfrp/pullthreadpool.hpp>
+#include <atomic>
+#include <cassert>
+#include <cstddef>  // std::size_t
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace sfrp {
+
+// This class implements a registry of the nodes of the running instances of a
+// 'MonteCarloRunner', with which the runner checks that instances share no
+// nodes.
+struct MonteCarloRunner_NodeOwners {
+  // Create a registry without nodes.
+  MonteCarloRunner_NodeOwners();
+
+  MonteCarloRunner_NodeOwners(const MonteCarloRunner_NodeOwners&) = delete;
+  MonteCarloRunner_NodeOwners& operator=(const MonteCarloRunner_NodeOwners&) =
+      delete;
+
+  // Record that the specified 'nodes' belong to the instance with the
+  // specified 'index'. Return 'false' if any of them belongs to another
+  // instance.
+  bool claim(std::size_t index, const std::vector<const BehaviorNode*>& nodes);
+
+  // Forget those of the specified 'nodes' that belong to the instance with
+  // the specified 'index'.
+  void release(std::size_t index,
+               const std::vector<const BehaviorNode*>& nodes);
+
+ private:
+  std::mutex m_mutex;
+  std::unordered_map<const BehaviorNode*, std::size_t> m_owners;
+};
+
+// This class implements a runner of independent behavior graph instances.
+struct MonteCarloRunner {
+  // Create a runner that runs instances on the calling thread and the
+  // specified 'numThreads' helper threads. Each thread allocates the nodes of
+  // its instances from arena blocks of the specified 'arenaBlockSize' bytes.
+  explicit MonteCarloRunner(
+      unsigned numThreads = std::thread::hardware_concurrency(),
+      std::size_t arenaBlockSize = 4096);
+
+  MonteCarloRunner(const MonteCarloRunner&) = delete;
+  MonteCarloRunner& operator=(const MonteCarloRunner&) = delete;
+
+  // Return the final values of the specified 'numInstances' instances built
+  // by calling the specified 'factory' with their index. Each instance is
+  // pulled every specified 'timeStep' until it is undefined or until the next
+  // time would exceed the specified 'endTime'. If 'factory' throws an
+  // exception, the first such exception is rethrown once all threads have
+  // stopped. The behavior is undefined unless 'factory' returns a
+  // 'Behavior<T>' when called with a 'std::size_t', may be called
+  // concurrently, and builds instances that share no nodes, 'timeStep > 0.0',
+  // 'endTime >= 0.0' or it is infinite and every instance is eventually
+  // undefined, and no 'BehaviorHashConsScope' or 'BehaviorCheckpointScope'
+  // is active on the calling thread.
+  template <typename T, typename Factory>
+  std::vector<boost::optional<T>> run(
+      std::size_t numInstances,
+      const Factory& factory,
+      double timeStep,
+      double endTime = std::numeric_limits<double>::infinity());
+
+  // Return the number of helper threads of this runner.
+  std::size_t numThreads() const;
+
+  // Return the nodes reachable from the specified 'root' node through the
+  // children of derived nodes.
+  static std::vector<const BehaviorNode*> reachableNodes(
+      const boost::shared_ptr<BehaviorNode>& root);
+
+ private:
+  // Return the value of the specified 'behavior' at the last of the times
+  // 'i * timeStep' not exceeding the specified 'endTime' at which it is
+  // defined.
+  template <typename T>
+  static boost::optional<T> pullToCompletion(const Behavior<T>& behavior,
+                                             double timeStep,
+                                             double endTime);
+
+  PullThreadPool m_pool;
+  std::size_t m_arenaBlockSize;
+};
+
+// ===========================================================================
+//                 INLINE DEFINITIONS
+// ===========================================================================
+
+template <typename T, typename Factory>
+std::vector<boost::optional<T>> MonteCarloRunner::run(
+    std::size_t numInstances,
+    const Factory& factory,
+    double timeStep,
+    double endTime) {
+  assert(timeStep > 0.0);
+  assert(!BehaviorHashCons::current());
+  assert(!BehaviorCheckpoint::current());
+
+  std::vector<boost::optional<T>> results(numInstances);
+  std::atomic<std::size_t> next(0);
+  MonteCarloRunner_NodeOwners owners;
+  const std::size_t arenaBlockSize = m_arenaBlockSize;
+
+  // There is one task per thread. Each task claims instances until there are
+  // none left. The pool runs tasks outside of any concurrency scope (see
+  // sfrp_pullthreadpool).
+  std::vector<boost::function<void()>> tasks(
+      m_pool.numThreads() + 1,
+      [&results, &next, &owners, &factory, timeStep, endTime,
+       arenaBlockSize]() {
+        BehaviorGraphArena arena(arenaBlockSize,
+                                 BehaviorGraphArena::e_RECYCLING);
+        const BehaviorGraphArenaScope scope(arena);
+        for (std::size_t index = next++; index < results.size();
+             index = next++) {
+          const Behavior<T> instance = factory(index);
+#ifndef NDEBUG
+          // The nodes of an instance are allocated from the arena of its
+          // thread, so their addresses aren't reused by other threads before
+          // they are released.
+          const std::vector<const BehaviorNode*> nodes =
+              reachableNodes(instance.node());
+          assert(owners.claim(index, nodes) &&
+                 "instances of a MonteCarloRunner must not share nodes");
+#endif
+          results[index] = pullToCompletion(instance, timeStep, endTime);
+#ifndef NDEBUG
+          owners.release(index, nodes);
+#endif
+        }
+      });
+  m_pool.run(tasks);
+  return results;
+}
+
+template <typename T>
+boost::optional<T> MonteCarloRunner::pullToCompletion(
+    const Behavior<T>& behavior,
+    double timeStep,
+    double endTime) {
+  boost::optional<T> result;
+  for (std::size_t step = 0;; ++step) {
+    // The time is computed from the step so that rounding errors don't
+    // accumulate over long runs.
+    const double time = step * timeStep;
+    if (time > endTime)
+      return result;
+    const T* const value = behavior.pullPointer(time);
+    if (!value)
+      return result;
+    result = *value;
+  }
+}
+}
+#endif
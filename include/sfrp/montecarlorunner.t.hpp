@@ -0,0 +1,11 @@
+#ifndef SFRP_MONTECARLORUNNER_T_HPP_
+#define SFRP_MONTECARLORUNNER_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void montecarlorunnerTests(stest::TestCollector&);
+}
+#endif
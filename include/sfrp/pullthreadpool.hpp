@@ -0,0 +1,122 @@
+#ifndef SFRP_PULLTHREADPOOL_HPP_
+#define SFRP_PULLTHREADPOOL_HPP_
+
+//@PURPOSE: Provide a thread pool for pulling behaviors concurrently.
+//
+//@CLASSES:
+//  sfrp::PullThreadPool: pool of threads that help run batches of pull tasks
+//  sfrp::PullThreadPool_Batch: batch of tasks submitted to a pool
+//
+//@SEE_ALSO: sfrp_behaviormap, sfrp_mapvaluepullfunc, sfrp_behaviornode
+//
+//@DESCRIPTION: This component provides a single class, 'PullThreadPool', that
+// runs batches of tasks, such as the pulls of the arguments of a behavior map,
+// concurrently.
+//
+// A thread calling 'run()' publishes its batch to the pool and immediately
+// starts running the tasks of the batch itself. Idle pool threads steal the
+// tasks of published batches that haven't been started yet. When the calling
+// thread runs out of unstarted tasks, it waits for the stolen tasks to finish.
+//
+// Because the calling thread always runs its own unstarted tasks, nested
+// calls to 'run()', for instance from a parallel map whose argument is itself
+// a parallel map, make progress even when all of the pool threads are busy.
+//
+// Tasks run within a 'BehaviorNodeExclusiveScope', so a task doesn't lock the
+// nodes it pulls merely because the thread running it, or the thread that
+// published it, is within a 'BehaviorNodeConcurrencyScope'. Tasks that pull
+// nodes shared with other tasks, such as the argument pulls of a parallel
+// map, create their own concurrency scope (see sfrp_behaviornode).
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: Running independent tasks
+// - - - - - - - - - - - - - - - - - - -
+//..
+//  sfrp::PullThreadPool pool(4);
+//  int a = 0, b = 0;
+//  std::vector<boost::function<void()>> tasks;
+//  tasks.push_back([&a]() { a = expensiveA(); });
+//  tasks.push_back([&b]() { b = expensiveB(); });
+//  pool.run(tasks);
+//..
+
+#include <boost/function.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>  // std::size_t
+#include <deque>
+#include <exception>  // std::exception_ptr
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sfrp {
+
+// This class implements a batch of tasks that are claimed one at a time by the
+// submitting thread and the threads of a pool.
+struct PullThreadPool_Batch {
+  // Create a batch of the specified 'tasks'.
+  explicit PullThreadPool_Batch(
+      const std::vector<boost::function<void()>>& tasks);
+
+  // Claim an unstarted task of this batch and load its index into the
+  // specified 'index'. Return 'false' if there were no unstarted tasks and
+  // 'true' otherwise.
+  bool claim(std::size_t* index);
+
+  // Run the claimed task at the specified 'index'.
+  void run(std::size_t index);
+
+  // Claim and run an unstarted task of this batch. Return 'false' if there
+  // were no unstarted tasks and 'true' otherwise.
+  bool runOne();
+
+  // Wait until all of the tasks of this batch have finished. If a task threw
+  // an exception, rethrow the first such exception.
+  void wait();
+
+ private:
+  const std::vector<boost::function<void()>>& m_tasks;
+  std::atomic<std::size_t> m_next;
+  std::size_t m_numFinished;
+  std::exception_ptr m_exception;
+  std::mutex m_mutex;
+  std::condition_variable m_finished;
+};
+
+// This class implements a pool of threads that help run batches of tasks.
+struct PullThreadPool {
+  // Create a pool with the specified 'numThreads' helper threads.
+  explicit PullThreadPool(
+      unsigned numThreads = std::thread::hardware_concurrency());
+
+  PullThreadPool(const PullThreadPool&) = delete;
+  PullThreadPool& operator=(const PullThreadPool&) = delete;
+
+  // Stop and join the threads of this pool. The behavior is undefined if a
+  // call to 'run()' is in progress.
+  ~PullThreadPool();
+
+  // Run the specified 'tasks', possibly concurrently, and return when all of
+  // them have finished. If a task throws an exception, the first such
+  // exception is rethrown after all tasks have finished.
+  void run(const std::vector<boost::function<void()>>& tasks);
+
+  // Return the number of helper threads of this pool.
+  std::size_t numThreads() const;
+
+ private:
+  // Run tasks of published batches until this pool is stopped.
+  void work();
+
+  std::mutex m_mutex;
+  std::condition_variable m_published;
+  std::deque<PullThreadPool_Batch*> m_batches;
+  bool m_stopped;
+  std::vector<std::thread> m_threads;
+};
+}
+#endif
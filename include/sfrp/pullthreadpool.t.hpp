@@ -0,0 +1,11 @@
+#ifndef SFRP_PULLTHREADPOOL_T_HPP_
+#define SFRP_PULLTHREADPOOL_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void pullthreadpoolTests(stest::TestCollector&);
+}
+#endif
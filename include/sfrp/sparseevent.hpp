@@ -0,0 +1,230 @@
+#ifndef SFRP_SPARSEEVENT_HPP_
+#define SFRP_SPARSEEVENT_HPP_
+
+//@PURPOSE: Provide an event that is only evaluated when it may occur.
+//
+//@CLASSES:
+//  sfrp::SparseEvent: event with known occurrence times
+//  sfrp::SparseEvent_PullFunc: pull function skipping quiet times
+//
+//@SEE_ALSO: sfrp_sparseeventutil, sfrp_eventutil, sfrp_triggerutil
+//
+//@DESCRIPTION: This component provides a class template, 'SparseEvent', that
+// represents an event together with knowledge of when it may occur. Ordinary
+// events are behaviors of type 'Behavior<boost::optional<T>>' and must be
+// pulled at every time to learn that nothing happened. A 'SparseEvent' also
+// knows
+//
+//: o the earliest time after any time at which it may occur, given by its
+//:   next occurrence function, and
+//:
+//: o whether an occurrence may be pending regardless of the time, given by its
+//:   pending function, for instance because a trigger was fired.
+//
+// Pulls of a 'SparseEvent' at times before its next possible occurrence,
+// while no occurrence is pending, return "no occurrence" without pulling the
+// underlying event. Chains of sparse event combinators, see
+// sfrp_sparseeventutil, are therefore skipped entirely between occurrences.
+// Note that the end of the underlying event is only noticed at the first pull
+// that isn't skipped.
+//
+// A 'SparseEvent' without a next occurrence function only occurs while an
+// occurrence is pending. Its node is then a polled node, see
+// sfrp_behaviornode, so an 'IncrementalEngine' skips it and its dependents as
+// well. A 'SparseEvent' without either function is only pulled once, and a
+// default constructed 'SparseEvent' never occurs.
+//
+// 'nextOccurrence()' is also useful to drivers that want to sleep until the
+// next time anything may happen.
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: An hourly event
+// - - - - - - - - - - - - -
+// Say 'hourChimes' is an event that occurs at the first pull of every hour.
+// We let combinators know when it may occur.
+//..
+//  sfrp::SparseEvent<int> hourly(hourChimes, [](double time) {
+//    return (std::floor(time / 3600.0) + 1.0) * 3600.0;
+//  });
+//..
+// Pulls within an hour of the previous chime don't pull 'hourChimes'.
+//..
+//  hourly.pull(3600.0);  // pulls 'hourChimes'
+//  hourly.pull(3601.0);  // 'make_optional(boost::optional<int>())'
+//  assert(hourly.nextOccurrence(3601.0) == 7200.0);
+//..
+
+#include <boost/function.hpp>
+#include <boost/optional.hpp>
+#include <boost/shared_ptr.hpp>
+#include <sfrp/behavior.hpp>
+#include <sfrp/behaviorgrapharena.hpp>
+#include <limits>
+
+namespace sfrp {
+
+// This class implements the pull function of a sparse event that pulls the
+// underlying event only at times it may occur.
+template <typename T>
+struct SparseEvent_PullFunc {
+  // Create a pull function for the specified 'event' with the specified
+  // 'nextOccurrenceFunc' and 'pendingFunc'. See 'SparseEvent'.
+  SparseEvent_PullFunc(
+      const Behavior<boost::optional<T>>& event,
+      const boost::function<double(double)>& nextOccurrenceFunc,
+      const boost::function<bool()>& pendingFunc);
+
+  // Return the occurrence of the event at the specified 'time', or no
+  // occurrence if the event can't occur at 'time'.
+  boost::optional<boost::optional<T>> operator()(const double time) const;
+
+ private:
+  Behavior<boost::optional<T>> m_event;
+  boost::function<double(double)> m_nextOccurrenceFunc;
+  boost::function<bool()> m_pendingFunc;
+  boost::shared_ptr<double> m_quietUntil;
+};
+
+// This class implements an event that knows the times at which it may occur.
+template <typename T>
+struct SparseEvent {
+  // The codomain of the event as a partial time function.
+  typedef boost::optional<T> type;
+
+  // Create an event that never occurs.
+  SparseEvent();
+
+  // Create an event with the occurrences of the specified 'event'. The
+  // specified 'nextOccurrenceFunc', unless empty, returns for any time 't'
+  // the earliest time after 't' at which 'event' may occur. The optionally
+  // specified 'pendingFunc', unless empty, returns 'true' if 'event' may occur
+  // at the next pull regardless of the time. The behavior is undefined unless
+  // 'event' doesn't occur at other times.
+  SparseEvent(const Behavior<boost::optional<T>>& event,
+              boost::function<double(double)> nextOccurrenceFunc,
+              boost::function<bool()> pendingFunc = boost::function<bool()>());
+
+  // Return the value of this event at the specified 'time' as a partial time
+  // function. The behavior is undefined unless the preconditions of
+  // 'Behavior::pull()' hold for 'time'.
+  boost::optional<type> pull(const double time) const;
+
+  // Return the earliest time after the specified 'time' at which this event
+  // may occur, not counting pending occurrences, or infinity if there is no
+  // such time.
+  double nextOccurrence(const double time) const;
+
+  // Return 'true' if this event may occur at the next pull regardless of the
+  // time and 'false' otherwise.
+  bool isPending() const;
+
+  // Return the next occurrence function of this event.
+  const boost::function<double(double)>& nextOccurrenceFunc() const;
+
+  // Return the pending function of this event.
+  const boost::function<bool()>& pendingFunc() const;
+
+  // Return an event-like behavior equivelent to this event. Pulls of the
+  // result skip the same times as pulls of this event.
+  const Behavior<type>& toBehavior() const;
+
+  // Return the result of 'toBehavior()'.
+  operator Behavior<type>() const;
+
+ private:
+  boost::function<double(double)> m_nextOccurrenceFunc;
+  boost::function<bool()> m_pendingFunc;
+  Behavior<type> m_behavior;
+};
+
+// ===========================================================================
+//                 INLINE DEFINITIONS
+// ===========================================================================
+
+template <typename T>
+SparseEvent_PullFunc<T>::SparseEvent_PullFunc(
+    const Behavior<boost::optional<T>>& event,
+    const boost::function<double(double)>& nextOccurrenceFunc,
+    const boost::function<bool()>& pendingFunc)
+    : m_event(event),
+      m_nextOccurrenceFunc(nextOccurrenceFunc),
+      m_pendingFunc(pendingFunc),
+      m_quietUntil(BehaviorGraphArena::makeShared<double>(
+          -std::numeric_limits<double>::infinity())) {}
+
+template <typename T>
+boost::optional<boost::optional<T>> SparseEvent_PullFunc<T>::operator()(
+    const double time) const {
+  if (time < *m_quietUntil && !(m_pendingFunc && m_pendingFunc()))
+    return boost::make_optional(boost::optional<T>());
+
+  boost::optional<boost::optional<T>> result = m_event.pull(time);
+  if (result) {
+    *m_quietUntil = m_nextOccurrenceFunc
+                        ? m_nextOccurrenceFunc(time)
+                        : std::numeric_limits<double>::infinity();
+  }
+  return result;
+}
+
+template <typename T>
+SparseEvent<T>::SparseEvent()
+    : m_nextOccurrenceFunc(),
+      m_pendingFunc(),
+      m_behavior(Behavior<type>::fromConstantValue(type())) {}
+
+template <typename T>
+SparseEvent<T>::SparseEvent(const Behavior<boost::optional<T>>& event,
+                            boost::function<double(double)> nextOccurrenceFunc,
+                            boost::function<bool()> pendingFunc)
+    : m_nextOccurrenceFunc(std::move(nextOccurrenceFunc)),
+      m_pendingFunc(std::move(pendingFunc)),
+      m_behavior(Behavior<type>::fromValuePullFunc(SparseEvent_PullFunc<T>(
+          event, m_nextOccurrenceFunc, m_pendingFunc))) {
+  if (!m_nextOccurrenceFunc && m_pendingFunc)
+    m_behavior.node()->setPolled(m_pendingFunc);
+}
+
+template <typename T>
+boost::optional<typename SparseEvent<T>::type> SparseEvent<T>::pull(
+    const double time) const {
+  return m_behavior.pull(time);
+}
+
+template <typename T>
+double SparseEvent<T>::nextOccurrence(const double time) const {
+  return m_nextOccurrenceFunc ? m_nextOccurrenceFunc(time)
+                              : std::numeric_limits<double>::infinity();
+}
+
+template <typename T>
+bool SparseEvent<T>::isPending() const {
+  return m_pendingFunc && m_pendingFunc();
+}
+
+template <typename T>
+const boost::function<double(double)>& SparseEvent<T>::nextOccurrenceFunc()
+    const {
+  return m_nextOccurrenceFunc;
+}
+
+template <typename T>
+const boost::function<bool()>& SparseEvent<T>::pendingFunc() const {
+  return m_pendingFunc;
+}
+
+template <typename T>
+const Behavior<typename SparseEvent<T>::type>& SparseEvent<T>::toBehavior()
+    const {
+  return m_behavior;
+}
+
+template <typename T>
+SparseEvent<T>::operator Behavior<typename SparseEvent<T>::type>() const {
+  return m_behavior;
+}
+}
+#endif
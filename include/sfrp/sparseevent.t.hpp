@@ -0,0 +1,11 @@
+#ifndef SFRP_SPARSEEVENT_T_HPP_
+#define SFRP_SPARSEEVENT_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void sparseeventTests(stest::TestCollector&);
+}
+#endif
@@ -0,0 +1,199 @@
+#ifndef SFRP_SPARSEEVENTUTIL_HPP_
+#define SFRP_SPARSEEVENTUTIL_HPP_
+
+//@PURPOSE: Provide utility operations for 'SparseEvent' objects.
+//
+//@CLASSES:
+//  sfrp::SparseEventUtil: namespace for sparse event operations
+//
+//@SEE_ALSO: sfrp_sparseevent, sfrp_eventutil
+//
+//@DESCRIPTION: This component provides a single namespace class,
+// 'SparseEventUtil', which has sparse versions of the event operations of
+// 'EventUtil', 'EventMap' and 'TriggerUtil'. The occurrences of the results
+// are the same as those of the ordinary operations, but the results also know
+// when they may occur so that they, and the events they are built from, are
+// skipped between occurrences. See sfrp_sparseevent.
+//
+// The next possible occurrence of a merge is the earliest of those of its
+// arguments and an occurrence of a merge is pending when one is pending in
+// either argument. The other operations have the occurrence times of their
+// event argument.
+//
+// Note that 'snapshot()' pulls its behavior argument only at the times its
+// event argument may occur.
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: Rarely firing inputs
+// - - - - - - - - - - - - - - - -
+// Say a game reacts to clicks, which come from a trigger, and to an autosave
+// every five minutes.
+//..
+//  auto clicks = sfrp::SparseEventUtil::trigger<Point>();
+//  sfrp::SparseEvent<Command> commands = sfrp::SparseEventUtil::merge(
+//      sfrp::SparseEventUtil::map(&commandAt, clicks.first),
+//      sfrp::SparseEventUtil::periodic(300.0, Command::e_SAVE));
+//..
+// Pulling 'commands' at every frame evaluates the click mapping only after
+// 'clicks.second' was called and the merge only then or every five minutes.
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/optional.hpp>
+#include <sfrp/behavior.hpp>
+#include <sfrp/behaviorgrapharena.hpp>
+#include <sfrp/eventmap.hpp>
+#include <sfrp/eventutil.hpp>
+#include <sfrp/sparseevent.hpp>
+#include <sfrp/triggerimpl.hpp>
+#include <algorithm>  // std::min
+#include <cmath>      // std::floor
+#include <limits>
+#include <type_traits>  // std::result_of
+#include <utility>      // std::pair
+
+namespace sfrp {
+
+// This class implements a namespace for operations on 'SparseEvent' objects.
+struct SparseEventUtil {
+  // Return an event that never occurs.
+  template <typename T>
+  static SparseEvent<T> never();
+
+  // Return an event that occurs with the specified 'value' at the first pull
+  // of every interval of the specified 'period' length, starting at time '0'.
+  // The behavior is undefined unless 'period > 0.0'.
+  template <typename T>
+  static SparseEvent<T> periodic(double period, const T& value);
+
+  // Return a never-ending event that occurs whenever the returned function is
+  // called, and that is skipped otherwise. The function is thread safe. See
+  // 'TriggerUtil::triggerInf()'.
+  template <typename T>
+  static std::pair<SparseEvent<T>, boost::function<void(const T&)>> trigger();
+
+  // Return an event whose occurrences are the union of the occurrences of the
+  // specified 'leftEvent' and 'rightEvent'. Preference is given to
+  // 'leftEvent' if there is an occurrence at the same time.
+  template <typename T>
+  static SparseEvent<T> merge(const SparseEvent<T>& leftEvent,
+                              const SparseEvent<T>& rightEvent);
+
+  // Return an event whose occurrences are those of the specified 'event'
+  // where the specified 'function' returns 'true'.
+  template <typename Function, typename T>
+  static SparseEvent<T> filter(Function function, const SparseEvent<T>& event);
+
+  // Return an event whose occurrences are the specified 'function' applied to
+  // the occurrences of the specified 'event'.
+  template <typename Function, typename T>
+  static SparseEvent<typename std::result_of<Function(T)>::type> map(
+      Function function,
+      const SparseEvent<T>& event);
+
+  // Return an event with the same occurrences of the specified 'event' except
+  // they are paired with the values of the specified 'behavior' at those
+  // times.
+  template <typename A, typename B>
+  static SparseEvent<std::pair<A, B>> snapshot(const Behavior<B>& behavior,
+                                               const SparseEvent<A>& event);
+
+ private:
+  // Return a next occurrence function that returns the earliest of the
+  // results of the specified 'leftFunc' and 'rightFunc', or an empty function
+  // if both are empty.
+  static boost::function<double(double)> earliest(
+      const boost::function<double(double)>& leftFunc,
+      const boost::function<double(double)>& rightFunc);
+
+  // Return a pending function that returns 'true' when either of the
+  // specified 'leftFunc' and 'rightFunc' does, or an empty function if both
+  // are empty.
+  static boost::function<bool()> either(
+      const boost::function<bool()>& leftFunc,
+      const boost::function<bool()>& rightFunc);
+};
+
+// ===========================================================================
+//                 INLINE DEFINITIONS
+// ===========================================================================
+
+template <typename T>
+SparseEvent<T> SparseEventUtil::never() {
+  return SparseEvent<T>();
+}
+
+template <typename T>
+SparseEvent<T> SparseEventUtil::periodic(double period, const T& value) {
+  const auto lastInterval = BehaviorGraphArena::makeShared<double>(-1.0);
+  return SparseEvent<T>(
+      Behavior<boost::optional<T>>::fromValuePullFunc(
+          [period, value, lastInterval](double time) {
+            const double interval = std::floor(time / period);
+            if (interval <= *lastInterval)
+              return boost::make_optional(boost::optional<T>());
+            *lastInterval = interval;
+            return boost::make_optional(boost::make_optional(value));
+          }),
+      [period](double time) {
+        return (std::floor(time / period) + 1.0) * period;
+      });
+}
+
+template <typename T>
+std::pair<SparseEvent<T>, boost::function<void(const T&)>>
+SparseEventUtil::trigger() {
+  const auto triggerImpl = boost::make_shared<TriggerImpl<T>>();
+  const Behavior<boost::optional<T>> event =
+      Behavior<boost::optional<T>>::fromValuePullFunc(
+          boost::bind(&TriggerImpl<T>::pullVal, triggerImpl, _1));
+  return std::make_pair(
+      SparseEvent<T>(event,
+                     boost::function<double(double)>(),
+                     boost::bind(&TriggerImpl<T>::changed, triggerImpl)),
+      [triggerImpl](const T& t) { triggerImpl->loadVal(t); });
+}
+
+template <typename T>
+SparseEvent<T> SparseEventUtil::merge(const SparseEvent<T>& leftEvent,
+                                      const SparseEvent<T>& rightEvent) {
+  return SparseEvent<T>(
+      EventUtil::merge(leftEvent.toBehavior(), rightEvent.toBehavior()),
+      earliest(leftEvent.nextOccurrenceFunc(),
+               rightEvent.nextOccurrenceFunc()),
+      either(leftEvent.pendingFunc(), rightEvent.pendingFunc()));
+}
+
+template <typename Function, typename T>
+SparseEvent<T> SparseEventUtil::filter(Function function,
+                                       const SparseEvent<T>& event) {
+  return SparseEvent<T>(EventUtil::filter(function, event.toBehavior()),
+                        event.nextOccurrenceFunc(),
+                        event.pendingFunc());
+}
+
+template <typename Function, typename T>
+SparseEvent<typename std::result_of<Function(T)>::type> SparseEventUtil::map(
+    Function function,
+    const SparseEvent<T>& event) {
+  return SparseEvent<typename std::result_of<Function(T)>::type>(
+      EventMap()(function, event.toBehavior()),
+      event.nextOccurrenceFunc(),
+      event.pendingFunc());
+}
+
+template <typename A, typename B>
+SparseEvent<std::pair<A, B>> SparseEventUtil::snapshot(
+    const Behavior<B>& behavior,
+    const SparseEvent<A>& event) {
+  return SparseEvent<std::pair<A, B>>(
+      EventUtil::snapshot(behavior, event.toBehavior()),
+      event.nextOccurrenceFunc(),
+      event.pendingFunc());
+}
+}
+#endif
@@ -0,0 +1,11 @@
+#ifndef SFRP_SPARSEEVENTUTIL_T_HPP_
+#define SFRP_SPARSEEVENTUTIL_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void sparseeventutilTests(stest::TestCollector&);
+}
+#endif
@@ -0,0 +1,176 @@
+#ifndef SFRP_STATICBEHAVIOR_HPP_
+#define SFRP_STATICBEHAVIOR_HPP_
+
+//@PURPOSE: Provide a statically-typed behavior that is evaluated inline.
+//
+//@CLASSES:
+//  sfrp::StaticBehavior: behavior whose pull function is a concrete type
+//
+//@SEE_ALSO: sfrp_behavior, sfrp_staticbehaviorutil
+//
+//@DESCRIPTION: This component provides a single class template,
+// 'StaticBehavior', which has the same denotational semantics as
+// 'sfrp::Behavior', but whose implementation is a concrete pull function type
+// instead of a shared, type erased, time function.
+//
+// Every 'sfrp::Behavior' node is a heap allocated, reference counted, cached
+// time function wrapping a 'boost::function'. Composing behaviors with
+// 'BehaviorMap' therefore costs an allocation at construction time and an
+// indirect call and a cache update at every pull for every node in the graph.
+// When a graph is static, that is its shape is known at compile time, these
+// costs are unnecessary. A 'StaticBehavior' keeps its entire expression
+// inline as a single value of type 'PullFunc' so that the compiler is able to
+// inline the whole graph into one function.
+//
+// The 'PullFunc' type must be a copyable function object that is callable
+// with a 'double' time argument, returns a 'boost::optional' value, and has a
+// 'result_type' typedef for that return type. The primitive pull functions and
+// the 'map' combinator provided by sfrp_staticbehaviorutil all satisfy this
+// requirement. 'PullFunc' must additionally provide a 'const' 'isPure()'
+// function that returns 'true' if the pull function has no dependence on
+// previous pulls. See 'Behavior::isPure()'.
+//
+// A 'StaticBehavior' is converted into an 'sfrp::Behavior' with the
+// 'toBehavior()' function, or implicitly. This is the only place where type
+// erasure occurs. Because a 'StaticBehavior' has a 'type' typedef and a
+// 'pull()' function, it may also be used directly as an argument to
+// 'BehaviorMap' where it will be embedded inline into the resulting node.
+//
+// Note that, unlike 'sfrp::Behavior', copies of a 'StaticBehavior' do not
+// share a cache. A 'StaticBehavior' that is used as an argument in several
+// places of a graph is evaluated once per use. This is desirable for cheap,
+// stateless expressions, but expensive or stateful sub-expressions that are
+// shared should be converted into an 'sfrp::Behavior' first.
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: Fusing a pipeline
+// - - - - - - - - - - - - - -
+// Say we want a behavior that is the sine of twice the current time. Using
+// 'sfrp_staticbehaviorutil' we build the expression without allocating any
+// nodes.
+//..
+//  auto twiceTime = sfrp::StaticBehaviorUtil::map(
+//      [](double t) { return 2.0 * t; }, sfrp::StaticBehaviorUtil::time());
+//  auto sinTwiceTime = sfrp::StaticBehaviorUtil::map(
+//      [](double t) { return std::sin(t); }, twiceTime);
+//..
+// 'sinTwiceTime' can be pulled directly,
+//..
+//  boost::optional<double> value = sinTwiceTime.pull(1.0);
+//..
+// or it can be converted into a regular behavior, which results in a single
+// node for the entire expression.
+//..
+//  sfrp::Behavior<double> sinTwiceTimeBehavior = sinTwiceTime;
+//..
+
+#include <boost/bind.hpp>
+#include <boost/optional.hpp>
+#include <cstddef>  // std::size_t
+#include <sfrp/behavior.hpp>
+
+namespace sfrp {
+
+// This class implements a partial function from time to a value where the
+// implementation is the specified 'PullFunc' function object type.
+template <typename PullFunc>
+struct StaticBehavior {
+
+  // The type of the function object implementing this behavior.
+  typedef PullFunc pull_func_type;
+
+  // The codomain of this partial time function.
+  typedef typename PullFunc::result_type::value_type type;
+
+  // Create a 'StaticBehavior' object with the specified 'pullFunc' as its
+  // implementation. The behavior is undefined unless 'pullFunc' satisfies the
+  // same requirements as the argument to 'Behavior::fromValuePullFunc()'.
+  explicit StaticBehavior(PullFunc pullFunc);
+
+  // Return the value of this partial time function at the specified 'time' if
+  // it is defined, otherwise return 'boost::none'. The behavior is undefined
+  // unless the preconditions of 'Behavior::pull()' hold for 'time'.
+  boost::optional<type> pull(const double time) const;
+
+  // Pull this behavior at each of the specified 'n' 'times', in order, and
+  // store the values in the specified 'out' array. Return the number of values
+  // stored, which is less than 'n' if this behavior is undefined at one of the
+  // times. The behavior is undefined unless 'times' is increasing and
+  // satisfies the preconditions of 'pull()' and 'out' has room for 'n'
+  // values.
+  std::size_t pullBatch(const double* times, std::size_t n, type* out) const;
+
+  // Return 'true' if the pull function of this behavior is pure.
+  bool isPure() const;
+
+  // Return the underlying pull function.
+  const PullFunc& pullFunc() const;
+
+  // Return a 'Behavior' object that is equivelent to this object. The
+  // resulting behavior consists of a single node evaluating the whole
+  // expression.
+  Behavior<type> toBehavior() const;
+
+  // Return the result of 'toBehavior()'.
+  operator Behavior<type>() const;
+
+ private:
+  PullFunc m_pullFunc;
+};
+
+// ===========================================================================
+//                 INLINE DEFINITIONS
+// ===========================================================================
+
+template <typename PullFunc>
+StaticBehavior<PullFunc>::StaticBehavior(PullFunc pullFunc)
+    : m_pullFunc(std::move(pullFunc)) {}
+
+template <typename PullFunc>
+boost::optional<typename StaticBehavior<PullFunc>::type>
+StaticBehavior<PullFunc>::pull(const double time) const {
+  return m_pullFunc(time);
+}
+
+template <typename PullFunc>
+std::size_t StaticBehavior<PullFunc>::pullBatch(const double* times,
+                                                std::size_t n,
+                                                type* out) const {
+  for (std::size_t i = 0; i < n; ++i) {
+    boost::optional<type> value = m_pullFunc(times[i]);
+    if (!value)
+      return i;
+    out[i] = std::move(*value);
+  }
+  return n;
+}
+
+template <typename PullFunc>
+bool StaticBehavior<PullFunc>::isPure() const {
+  return m_pullFunc.isPure();
+}
+
+template <typename PullFunc>
+const PullFunc& StaticBehavior<PullFunc>::pullFunc() const {
+  return m_pullFunc;
+}
+
+template <typename PullFunc>
+Behavior<typename StaticBehavior<PullFunc>::type>
+StaticBehavior<PullFunc>::toBehavior() const {
+  return Behavior<type>::fromValuePullFunc(
+      m_pullFunc,
+      boost::bind(&StaticBehavior::pullBatch, *this, _1, _2, _3),
+      isPure());
+}
+
+template <typename PullFunc>
+StaticBehavior<PullFunc>::operator Behavior<
+    typename StaticBehavior<PullFunc>::type>() const {
+  return toBehavior();
+}
+}
+#endif
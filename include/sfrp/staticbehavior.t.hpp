@@ -0,0 +1,11 @@
+#ifndef SFRP_STATICBEHAVIOR_T_HPP_
+#define SFRP_STATICBEHAVIOR_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void staticbehaviorTests(stest::TestCollector&);
+}
+#endif
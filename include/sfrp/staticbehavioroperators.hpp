@@ -0,0 +1,200 @@
+#ifndef SFRP_STATICBEHAVIOROPERATORS_HPP_
+#define SFRP_STATICBEHAVIOROPERATORS_HPP_
+
+//@PURPOSE: Provide overloads of C++ operators for static behaviors.
+//
+//@CLASSES:
+//  sfrp::StaticBehaviorOperators: namespace for operators that can't be overloaded
+//
+//@SEE_ALSO: sfrp_behavioroperators, sfrp_staticbehaviorutil
+//
+//@DESCRIPTION: This component provides the same operator overloads, and the
+// same 'ifThenElse' free function, as sfrp_behavioroperators, but for
+// 'StaticBehavior' arguments. The results are themselves 'StaticBehavior'
+// objects so that arithmetic expressions over static behaviors are fused into
+// a single concrete type.
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: Adding static behaviors
+// - - - - - - - - - - - - - - - - -
+// The expression below creates no nodes until it is assigned to an
+// 'sfrp::Behavior'.
+//..
+//  sfrp::Behavior<double> c = sfrp::StaticBehaviorUtil::time() +
+//                             sfrp::StaticBehaviorUtil::always(1.0);
+//..
+
+#include <scpp/operators.hpp>
+#include <sfrp/staticbehavior.hpp>
+#include <sfrp/staticbehaviorutil.hpp>
+
+namespace sfrp {
+
+// Return the static behavior where for every time t, the value is the
+// specified 'lhs' behavior at that time minus the specified 'rhs' behavior at
+// that time. The result is defined wherever both 'lhs' and 'rhs' are defined.
+template <typename A, typename B>
+inline auto operator-(const StaticBehavior<A>& lhs,
+                      const StaticBehavior<B>& rhs)
+    -> decltype(StaticBehaviorUtil::map(
+        scpp::Operators::minus<typename StaticBehavior<A>::type,
+                               typename StaticBehavior<B>::type>,
+        lhs,
+        rhs));
+
+// Return the static behavior where for every time t, the value is the
+// specified 'lhs' behavior at that time plus the specified 'rhs' behavior at
+// that time. The result is defined wherever both 'lhs' and 'rhs' are defined.
+template <typename A, typename B>
+inline auto operator+(const StaticBehavior<A>& lhs,
+                      const StaticBehavior<B>& rhs)
+    -> decltype(StaticBehaviorUtil::map(
+        scpp::Operators::plus<typename StaticBehavior<A>::type,
+                              typename StaticBehavior<B>::type>,
+        lhs,
+        rhs));
+
+// Return the static behavior where for every time t, the value is the
+// negation of the specified 'behavior' at that time.
+template <typename A>
+inline auto operator-(const StaticBehavior<A>& behavior)
+    -> decltype(StaticBehaviorUtil::map(
+        scpp::Operators::negate<typename StaticBehavior<A>::type>,
+        behavior));
+
+// Return the static behavior where for every time t, the value is the
+// specified 'lhs' behavior at that time and-ed with the specified 'rhs'
+// behavior at that time.
+template <typename A, typename B>
+inline auto operator&&(const StaticBehavior<A>& lhs,
+                       const StaticBehavior<B>& rhs)
+    -> decltype(StaticBehaviorUtil::map(
+        scpp::Operators::logicalAnd<typename StaticBehavior<A>::type>,
+        lhs,
+        rhs));
+
+// Return the static behavior where for every time t, the value is the
+// specified 'lhs' behavior at that time or-ed with the specified 'rhs'
+// behavior at that time.
+template <typename A, typename B>
+inline auto operator||(const StaticBehavior<A>& lhs,
+                       const StaticBehavior<B>& rhs)
+    -> decltype(StaticBehaviorUtil::map(
+        scpp::Operators::logicalOr<typename StaticBehavior<A>::type>,
+        lhs,
+        rhs));
+
+// Return the static behavior where for every time t, the value is the logical
+// not of the specified 'behavior' at that time.
+template <typename A>
+inline auto operator!(const StaticBehavior<A>& behavior)
+    -> decltype(StaticBehaviorUtil::map(
+        scpp::Operators::logicalNot<typename StaticBehavior<A>::type>,
+        behavior));
+
+// This class implements a namespace for operations on static behaviors that
+// cannot be implemented as C++ operator overloads.
+struct StaticBehaviorOperators {
+  // Return a static behavior that is the specified 'trueCase' whenever
+  // 'comparison' is 'true' and 'falseCase' whenver 'comparison' is 'false'.
+  template <typename C, typename T, typename F>
+  static auto ifThenElse(const StaticBehavior<C>& comparison,
+                         const StaticBehavior<T>& trueCase,
+                         const StaticBehavior<F>& falseCase)
+      -> decltype(StaticBehaviorUtil::map(
+          scpp::Operators::ifThenElse<typename StaticBehavior<T>::type>,
+          comparison,
+          trueCase,
+          falseCase));
+};
+
+// ===========================================================================
+//                 INLINE DEFINITIONS
+// ===========================================================================
+
+template <typename A, typename B>
+inline auto operator-(const StaticBehavior<A>& a, const StaticBehavior<B>& b)
+    -> decltype(StaticBehaviorUtil::map(
+        scpp::Operators::minus<typename StaticBehavior<A>::type,
+                               typename StaticBehavior<B>::type>,
+        a,
+        b)) {
+  return StaticBehaviorUtil::map(
+      scpp::Operators::minus<typename StaticBehavior<A>::type,
+                             typename StaticBehavior<B>::type>,
+      a,
+      b);
+}
+
+template <typename A, typename B>
+inline auto operator+(const StaticBehavior<A>& a, const StaticBehavior<B>& b)
+    -> decltype(StaticBehaviorUtil::map(
+        scpp::Operators::plus<typename StaticBehavior<A>::type,
+                              typename StaticBehavior<B>::type>,
+        a,
+        b)) {
+  return StaticBehaviorUtil::map(
+      scpp::Operators::plus<typename StaticBehavior<A>::type,
+                            typename StaticBehavior<B>::type>,
+      a,
+      b);
+}
+
+template <typename A>
+inline auto operator-(const StaticBehavior<A>& a)
+    -> decltype(StaticBehaviorUtil::map(
+        scpp::Operators::negate<typename StaticBehavior<A>::type>,
+        a)) {
+  return StaticBehaviorUtil::map(
+      scpp::Operators::negate<typename StaticBehavior<A>::type>, a);
+}
+
+template <typename A, typename B>
+inline auto operator&&(const StaticBehavior<A>& a, const StaticBehavior<B>& b)
+    -> decltype(StaticBehaviorUtil::map(
+        scpp::Operators::logicalAnd<typename StaticBehavior<A>::type>,
+        a,
+        b)) {
+  return StaticBehaviorUtil::map(
+      scpp::Operators::logicalAnd<typename StaticBehavior<A>::type>, a, b);
+}
+
+template <typename A, typename B>
+inline auto operator||(const StaticBehavior<A>& a, const StaticBehavior<B>& b)
+    -> decltype(StaticBehaviorUtil::map(
+        scpp::Operators::logicalOr<typename StaticBehavior<A>::type>,
+        a,
+        b)) {
+  return StaticBehaviorUtil::map(
+      scpp::Operators::logicalOr<typename StaticBehavior<A>::type>, a, b);
+}
+
+template <typename A>
+inline auto operator!(const StaticBehavior<A>& a)
+    -> decltype(StaticBehaviorUtil::map(
+        scpp::Operators::logicalNot<typename StaticBehavior<A>::type>,
+        a)) {
+  return StaticBehaviorUtil::map(
+      scpp::Operators::logicalNot<typename StaticBehavior<A>::type>, a);
+}
+
+template <typename C, typename T, typename F>
+auto StaticBehaviorOperators::ifThenElse(const StaticBehavior<C>& comparison,
+                                         const StaticBehavior<T>& trueCase,
+                                         const StaticBehavior<F>& falseCase)
+    -> decltype(StaticBehaviorUtil::map(
+        scpp::Operators::ifThenElse<typename StaticBehavior<T>::type>,
+        comparison,
+        trueCase,
+        falseCase)) {
+  return StaticBehaviorUtil::map(
+      scpp::Operators::ifThenElse<typename StaticBehavior<T>::type>,
+      comparison,
+      trueCase,
+      falseCase);
+}
+}
+#endif
@@ -0,0 +1,11 @@
+#ifndef SFRP_STATICBEHAVIOROPERATORS_T_HPP_
+#define SFRP_STATICBEHAVIOROPERATORS_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void staticbehavioroperatorsTests(stest::TestCollector&);
+}
+#endif
@@ -0,0 +1,269 @@
+#ifndef SFRP_STATICBEHAVIORUTIL_HPP_
+#define SFRP_STATICBEHAVIORUTIL_HPP_
+
+//@PURPOSE: Provide utility operations that create 'StaticBehavior' objects.
+//
+//@CLASSES:
+//  sfrp::StaticBehaviorUtil: namespace for static behavior operations
+//  sfrp::StaticBehaviorUtil_Always: pull function of a constant behavior
+//  sfrp::StaticBehaviorUtil_Time: pull function of the time behavior
+//  sfrp::StaticBehaviorUtil_Pure: pull function of a time function behavior
+//  sfrp::StaticBehaviorUtil_FromBehavior: pull function wrapping a behavior
+//  sfrp::StaticBehaviorUtil_MapResult: 'map()' result type metafunction
+//
+//@SEE_ALSO: sfrp_staticbehavior, sfrp_behaviorutil
+//
+//@DESCRIPTION: This component provides a single namespace class,
+// 'StaticBehaviorUtil', which mirrors the primitive operations of
+// 'BehaviorUtil' ('always()', 'time()', 'pure()' and 'map()') but produces
+// 'StaticBehavior' objects. No allocations or type erasure occur when these
+// functions are composed. The resulting expression is only type erased when it
+// is converted into an 'sfrp::Behavior'.
+//
+// 'fromBehavior()' embeds an existing 'sfrp::Behavior' into a static
+// expression. Pulls of the resulting static behavior are forwarded to the
+// shared node of the argument so stateful behaviors, such as those created by
+// wormholes, keep their sharing semantics.
+//
+// The 'map()' function uses 'MapValuePullFunc' as its pull function and
+// accepts any mix of 'StaticBehavior' and 'Behavior' arguments.
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: A fused oscillator
+// - - - - - - - - - - - - - - -
+// The following computes 'amplitude * sin(frequency * t)' where the amplitude
+// is an ordinary behavior, for instance one fed by a trigger. Only the
+// conversion at the end allocates a node.
+//..
+//  sfrp::Behavior<double> oscillator(sfrp::Behavior<double> amplitude,
+//                                    double frequency) {
+//    return sfrp::StaticBehaviorUtil::map(
+//        [](double a, double s) { return a * s; },
+//        sfrp::StaticBehaviorUtil::fromBehavior(amplitude),
+//        sfrp::StaticBehaviorUtil::pure(
+//            [frequency](double t) { return std::sin(frequency * t); }));
+//  }
+//..
+
+#include <boost/optional.hpp>
+#include <sfrp/behavior.hpp>
+#include <sfrp/mapvaluepullfunc.hpp>
+#include <sfrp/staticbehavior.hpp>
+#include <type_traits>  // std::result_of
+
+namespace sfrp {
+
+// This class implements the pull function of a behavior that has the same
+// value for all time.
+template <typename T>
+struct StaticBehaviorUtil_Always {
+  typedef boost::optional<T> result_type;
+
+  // Create a pull function that always returns the specified 'value'.
+  explicit StaticBehaviorUtil_Always(const T& value);
+
+  // Return the value of this object.
+  result_type operator()(const double time) const;
+
+  // Return 'true'.
+  bool isPure() const;
+
+ private:
+  T m_value;
+};
+
+// This class implements the pull function of a behavior whose value is the
+// current time.
+struct StaticBehaviorUtil_Time {
+  typedef boost::optional<double> result_type;
+
+  // Return the specified 'time'.
+  result_type operator()(const double time) const;
+
+  // Return 'true'.
+  bool isPure() const;
+};
+
+// This class implements the pull function of a behavior whose value is a
+// function of time.
+template <typename Function>
+struct StaticBehaviorUtil_Pure {
+  typedef boost::optional<typename std::result_of<Function(double)>::type>
+      result_type;
+
+  // Create a pull function that applies the specified 'timeFunction' to the
+  // time.
+  explicit StaticBehaviorUtil_Pure(Function timeFunction);
+
+  // Return the time function of this object applied to the specified 'time'.
+  result_type operator()(const double time) const;
+
+  // Return 'true'.
+  bool isPure() const;
+
+ private:
+  Function m_timeFunction;
+};
+
+// This class implements a pull function that forwards pulls to an
+// 'sfrp::Behavior'.
+template <typename T>
+struct StaticBehaviorUtil_FromBehavior {
+  typedef boost::optional<T> result_type;
+
+  // Create a pull function that pulls the specified 'behavior'.
+  explicit StaticBehaviorUtil_FromBehavior(const Behavior<T>& behavior);
+
+  // Return the result of pulling the behavior of this object at the specified
+  // 'time'.
+  result_type operator()(const double time) const;
+
+  // Return 'true' if the behavior of this object is pure.
+  bool isPure() const;
+
+ private:
+  Behavior<T> m_behavior;
+};
+
+// This class implements a metafunction that returns the 'StaticBehavior' type
+// that results from mapping the specified 'Function' over the specified
+// 'ArgBehaviors'.
+template <typename Function, typename... ArgBehaviors>
+struct StaticBehaviorUtil_MapResult {
+  typedef StaticBehavior<MapValuePullFunc<Function, ArgBehaviors...>> type;
+};
+
+// This class implements a namespace for operations that create
+// 'StaticBehavior' objects.
+struct StaticBehaviorUtil {
+
+  // Return a static behavior that has the specified 'value' for all time.
+  template <typename T>
+  static StaticBehavior<StaticBehaviorUtil_Always<T>> always(const T& value);
+
+  // Return a static behavior that has the value of the current time at every
+  // moment.
+  static StaticBehavior<StaticBehaviorUtil_Time> time();
+
+  // Return a static behavior that, at any time 't', has a value of the
+  // specified 'timeFunction' applied to 't'. The behavior is undefined unless
+  // 'timeFunction' is defined for all input values.
+  template <typename Function>
+  static StaticBehavior<StaticBehaviorUtil_Pure<Function>> pure(
+      Function timeFunction);
+
+  // Return a static behavior that is equivelent to the specified 'behavior'.
+  // Pulls of the result are forwarded to 'behavior'.
+  template <typename T>
+  static StaticBehavior<StaticBehaviorUtil_FromBehavior<T>> fromBehavior(
+      const Behavior<T>& behavior);
+
+  // Return a static behavior that, for any time 't', is defined to be the
+  // specified 'function' applied to the specified 'argBehaviors' at time 't'.
+  // If any of 'argBehaviors' is not defined at time 't', then neither is the
+  // result. 'argBehaviors' may be any mix of 'StaticBehavior' and 'Behavior'
+  // objects.
+  //
+  // The behavior is undefined unless the specified 'Function' meets the
+  // 'Deferred Callable Object' concept of Boost.Fusion.
+  template <typename Function, typename... ArgBehaviors>
+  static typename StaticBehaviorUtil_MapResult<Function, ArgBehaviors...>::type
+      map(Function function, ArgBehaviors... argBehaviors);
+};
+
+// ===========================================================================
+//                 INLINE DEFINITIONS
+// ===========================================================================
+
+template <typename T>
+StaticBehaviorUtil_Always<T>::StaticBehaviorUtil_Always(const T& value)
+    : m_value(value) {}
+
+template <typename T>
+typename StaticBehaviorUtil_Always<T>::result_type
+StaticBehaviorUtil_Always<T>::operator()(const double time) const {
+  return m_value;
+}
+
+template <typename T>
+bool StaticBehaviorUtil_Always<T>::isPure() const {
+  return true;
+}
+
+inline StaticBehaviorUtil_Time::result_type StaticBehaviorUtil_Time::
+operator()(const double time) const {
+  return time;
+}
+
+inline bool StaticBehaviorUtil_Time::isPure() const { return true; }
+
+template <typename Function>
+StaticBehaviorUtil_Pure<Function>::StaticBehaviorUtil_Pure(
+    Function timeFunction)
+    : m_timeFunction(timeFunction) {}
+
+template <typename Function>
+typename StaticBehaviorUtil_Pure<Function>::result_type
+StaticBehaviorUtil_Pure<Function>::operator()(const double time) const {
+  return boost::make_optional(m_timeFunction(time));
+}
+
+template <typename Function>
+bool StaticBehaviorUtil_Pure<Function>::isPure() const {
+  return true;
+}
+
+template <typename T>
+StaticBehaviorUtil_FromBehavior<T>::StaticBehaviorUtil_FromBehavior(
+    const Behavior<T>& behavior)
+    : m_behavior(behavior) {}
+
+template <typename T>
+typename StaticBehaviorUtil_FromBehavior<T>::result_type
+StaticBehaviorUtil_FromBehavior<T>::operator()(const double time) const {
+  return m_behavior.pull(time);
+}
+
+template <typename T>
+bool StaticBehaviorUtil_FromBehavior<T>::isPure() const {
+  return m_behavior.isPure();
+}
+
+template <typename T>
+StaticBehavior<StaticBehaviorUtil_Always<T>> StaticBehaviorUtil::always(
+    const T& value) {
+  return StaticBehavior<StaticBehaviorUtil_Always<T>>(
+      StaticBehaviorUtil_Always<T>(value));
+}
+
+inline StaticBehavior<StaticBehaviorUtil_Time> StaticBehaviorUtil::time() {
+  return StaticBehavior<StaticBehaviorUtil_Time>(StaticBehaviorUtil_Time());
+}
+
+template <typename Function>
+StaticBehavior<StaticBehaviorUtil_Pure<Function>> StaticBehaviorUtil::pure(
+    Function timeFunction) {
+  return StaticBehavior<StaticBehaviorUtil_Pure<Function>>(
+      StaticBehaviorUtil_Pure<Function>(timeFunction));
+}
+
+template <typename T>
+StaticBehavior<StaticBehaviorUtil_FromBehavior<T>>
+StaticBehaviorUtil::fromBehavior(const Behavior<T>& behavior) {
+  return StaticBehavior<StaticBehaviorUtil_FromBehavior<T>>(
+      StaticBehaviorUtil_FromBehavior<T>(behavior));
+}
+
+template <typename Function, typename... ArgBehaviors>
+typename StaticBehaviorUtil_MapResult<Function, ArgBehaviors...>::type
+StaticBehaviorUtil::map(Function function, ArgBehaviors... argBehaviors) {
+  typedef typename StaticBehaviorUtil_MapResult<Function, ArgBehaviors...>::type
+      Result;
+  return Result(
+      MapValuePullFunc<Function, ArgBehaviors...>(function, argBehaviors...));
+}
+}
+#endif
@@ -0,0 +1,11 @@
+#ifndef SFRP_STATICBEHAVIORUTIL_T_HPP_
+#define SFRP_STATICBEHAVIORUTIL_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void staticbehaviorutilTests(stest::TestCollector&);
+}
+#endif
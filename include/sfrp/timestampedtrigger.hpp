@@ -0,0 +1,215 @@
+#ifndef SFRP_TIMESTAMPEDTRIGGER_HPP_
+#define SFRP_TIMESTAMPEDTRIGGER_HPP_
+
+//@PURPOSE: Provide trigger state delivering occurrences at their own times.
+//
+//@CLASSES:
+//  sfrp::TimestampedTrigger: trigger state ordering timestamped occurrences
+//
+//@SEE_ALSO: sfrp_triggerqueue, sfrp_triggerutil
+//
+//@DESCRIPTION: This component provides a single class template,
+// 'TimestampedTrigger', that implements the state of a trigger whose producers
+// supply the time of each occurrence. It is used by
+// 'TriggerUtil::timestampedTrigger()'.
+//
+// An ordinary trigger places an occurrence at the time of the next pull,
+// whenever the producer fired it, so its accuracy is limited by the pull rate.
+// A timestamped occurrence is instead delivered, together with its time, at
+// the first pull whose time is at or after it. A graph pulled at a coarse rate
+// then still sees the exact times of the occurrences it handles.
+//
+// Producers may load occurrences out of order. Loaded occurrences wait in an
+// ordering buffer and every pull delivers, ordered by time, all of those
+// whose time is at or before the watermark of the pull: the pull time minus
+// the allowed lateness given at construction. With an allowed lateness of 'd',
+// producers that report occurrences at most 'd' late are delivered in time
+// order across pulls. An occurrence loaded after the watermark passed its time
+// is late. It is delivered by the next pull with its original time and
+// counted by 'numLate()'.
+//
+// Loading values is lock-free and thread safe, see sfrp_triggerqueue. A
+// single thread, the one pulling the behavior graph, calls the other
+// functions. Loading the end of the trigger ends it once the occurrences
+// loaded before have been delivered.
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: Placing ticks at their exchange time
+// - - - - - - - - - - - - - - - - - - - - - - -
+// Say feed threads receive trades stamped with their exchange time and a graph
+// is pulled ten times a second.
+//..
+//  sfrp::TimestampedTrigger<Trade> trades(0.05);
+//  // on each feed thread
+//  trades.loadVal(trade.exchangeTime, trade);
+//  // on the pulling thread, every 0.1s
+//  auto batch = trades.pullVal(time);
+//..
+// 'batch' holds the trades with exchange times up to 'time - 0.05' that
+// weren't delivered before, each paired with its exchange time.
+
+#include <boost/optional.hpp>
+#include <sfrp/triggerqueue.hpp>
+#include <algorithm>  // std::push_heap, std::pop_heap
+#include <cstddef>    // std::size_t
+#include <limits>
+#include <utility>    // std::pair
+#include <vector>
+
+namespace sfrp {
+
+// This class implements the state of a trigger whose occurrences carry their
+// own times.
+template <typename T>
+struct TimestampedTrigger {
+  // The type of an occurrence delivered by a pull: the time of the
+  // occurrence and its value.
+  typedef std::pair<double, T> Occurrence;
+
+  // Create a trigger that delivers occurrences once the pull time is the
+  // specified 'allowedLateness' past their time and that holds up to the
+  // specified 'capacity' occurrences loaded between pulls. The behavior is
+  // undefined unless 'allowedLateness >= 0.0' and 'capacity > 0'.
+  explicit TimestampedTrigger(double allowedLateness = 0.0,
+                              std::size_t capacity = 1024);
+
+  // Load an occurrence of the specified 'value' at the specified 'time'.
+  // Wait while the occurrences loaded since the previous pull fill the
+  // capacity of this trigger. Do nothing if the end was already loaded. This
+  // function is thread safe.
+  void loadVal(double time, const T& value);
+
+  // Load the end of this trigger. This function is thread safe.
+  void loadEnd();
+
+  // Return, as an occurrence at the specified 'time', the occurrences not
+  // delivered yet whose times are at or before 'time' minus the allowed
+  // lateness, ordered by time. Return no occurrence if there is no such
+  // occurrence and 'boost::none' if the end of this trigger was reached.
+  boost::optional<boost::optional<std::vector<Occurrence>>> pullVal(
+      const double time);
+
+  // Return 'true' if the next 'pullVal()' may return something different than
+  // the previous one. That is the case if an occurrence was loaded or awaits
+  // delivery or if the previous pull returned an occurrence.
+  bool changed() const;
+
+  // Return the number of occurrences loaded after the watermark passed their
+  // time.
+  std::size_t numLate() const;
+
+ private:
+  // An occurrence in the ordering buffer. Occurrences at the same time are
+  // ordered by the order in which they were received.
+  struct Entry {
+    double time;
+    std::size_t sequence;
+    T value;
+  };
+
+  // Return 'true' if the specified 'lhs' is delivered after the specified
+  // 'rhs'.
+  static bool later(const Entry& lhs, const Entry& rhs);
+
+  TriggerQueue<Occurrence> m_queue;
+  double m_allowedLateness;
+  double m_watermark;
+  std::vector<Entry> m_buffer;  // heap of 'later()'
+  std::size_t m_nextSequence;
+  std::size_t m_numLate;
+  bool m_endReceived;
+  bool m_ended;
+  bool m_lastPullOccurred;
+};
+
+// ===========================================================================
+//                 INLINE DEFINITIONS
+// ===========================================================================
+
+template <typename T>
+TimestampedTrigger<T>::TimestampedTrigger(double allowedLateness,
+                                          std::size_t capacity)
+    : m_queue(capacity),
+      m_allowedLateness(allowedLateness),
+      m_watermark(-std::numeric_limits<double>::infinity()),
+      m_buffer(),
+      m_nextSequence(0),
+      m_numLate(0),
+      m_endReceived(false),
+      m_ended(false),
+      m_lastPullOccurred(false) {}
+
+template <typename T>
+void TimestampedTrigger<T>::loadVal(double time, const T& value) {
+  m_queue.loadVal(Occurrence(time, value));
+}
+
+template <typename T>
+void TimestampedTrigger<T>::loadEnd() {
+  m_queue.loadVal(boost::none);
+}
+
+template <typename T>
+boost::optional<boost::optional<std::vector<
+    typename TimestampedTrigger<T>::Occurrence>>>
+TimestampedTrigger<T>::pullVal(const double time) {
+  if (m_ended)
+    return boost::none;
+
+  if (!m_endReceived) {
+    boost::optional<boost::optional<std::vector<Occurrence>>> loaded =
+        m_queue.pullVal(time);
+    if (!loaded)
+      m_endReceived = true;
+    else if (*loaded) {
+      for (Occurrence& occurrence : **loaded) {
+        if (occurrence.first <= m_watermark)
+          ++m_numLate;
+        m_buffer.push_back(Entry{occurrence.first, m_nextSequence++,
+                                 std::move(occurrence.second)});
+        std::push_heap(m_buffer.begin(), m_buffer.end(), &later);
+      }
+    }
+  }
+
+  // Late occurrences are before the new watermark as well, so they are
+  // delivered by this pull.
+  m_watermark = time - m_allowedLateness;
+  std::vector<Occurrence> due;
+  while (!m_buffer.empty() && m_buffer.front().time <= m_watermark) {
+    std::pop_heap(m_buffer.begin(), m_buffer.end(), &later);
+    due.emplace_back(m_buffer.back().time, std::move(m_buffer.back().value));
+    m_buffer.pop_back();
+  }
+
+  m_lastPullOccurred = !due.empty();
+  m_ended = m_endReceived && m_buffer.empty() && due.empty();
+  if (m_lastPullOccurred)
+    return boost::make_optional(boost::make_optional(std::move(due)));
+  else if (m_ended)
+    return boost::none;
+  else
+    return boost::make_optional(boost::optional<std::vector<Occurrence>>());
+}
+
+template <typename T>
+bool TimestampedTrigger<T>::changed() const {
+  return m_lastPullOccurred || !m_buffer.empty() || m_endReceived ||
+         m_queue.changed();
+}
+
+template <typename T>
+std::size_t TimestampedTrigger<T>::numLate() const {
+  return m_numLate;
+}
+
+template <typename T>
+bool TimestampedTrigger<T>::later(const Entry& lhs, const Entry& rhs) {
+  return lhs.time > rhs.time ||
+         (lhs.time == rhs.time && lhs.sequence > rhs.sequence);
+}
+}
+#endif
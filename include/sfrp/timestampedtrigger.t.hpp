@@ -0,0 +1,11 @@
+#ifndef SFRP_TIMESTAMPEDTRIGGER_T_HPP_
+#define SFRP_TIMESTAMPEDTRIGGER_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void timestampedtriggerTests(stest::TestCollector&);
+}
+#endif
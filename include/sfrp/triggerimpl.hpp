@@ -2,49 +2,104 @@
 #define SFRP_TRIGGERIMPL_HPP_
 
 #include <boost/optional.hpp>
-#include <mutex>
+#include <atomic>
+#include <utility>  // std::move
 
 namespace sfrp {
 
+// This class implements the state of a trigger that keeps the last value
+// loaded between two pulls. Any number of threads may call 'loadVal()'
+// concurrently without locking: each loaded value is swapped into a single
+// slot, replacing any value that wasn't pulled yet. A single thread, the one
+// pulling the behavior graph, calls 'pullVal()' and 'changed()'. The storage
+// of a pulled or replaced value is kept for the next loaded value, so a
+// trigger that is set once per pull allocates no memory. See
+// sfrp_triggerqueue for a trigger state that keeps every loaded value.
 template <typename T>
 struct TriggerImpl {
+  TriggerImpl() = default;
+  TriggerImpl(const TriggerImpl&) = delete;
+  TriggerImpl& operator=(const TriggerImpl&) = delete;
+  ~TriggerImpl();
 
   boost::optional<boost::optional<T>> pullVal(const double time);
 
+  // Load the specified 'opT' value, or the end of the trigger if 'opT' is
+  // 'boost::none'. Once the end is loaded, the values loaded before that were
+  // not pulled yet and all the values loaded afterwards are ignored.
   void loadVal(const boost::optional<T>& opT);
 
+  // Return 'true' if the next 'pullVal()' may return something different than
+  // the previous one. That is the case if a value is loaded or if the
+  // previous pull returned an occurrence.
+  bool changed();
+
  private:
-  std::mutex m_mutex;
-  boost::optional       // is there anything loaded?
-      <boost::optional  // Is the thing loaded an "exit" or a
-       <T               // ← value ?
-        >> m_state;
+  // Keep the storage of the specified 'value' for a later 'loadVal()'.
+  void recycle(T* value);
+
+  // The last loaded value that wasn't pulled yet, or 0. A producer that
+  // swaps a value out of the slot owns it, as does the consumer.
+  std::atomic<T*> m_pending{nullptr};
+
+  // Storage for the next loaded value, or 0. It is owned in the same way.
+  std::atomic<T*> m_spare{nullptr};
+  std::atomic<bool> m_endLoaded{false};
+  bool m_lastPullOccurred = false;
 };
 
 // ===========================================================================
 //                 INLINE DEFINITIONS
 // ===========================================================================
 
+template <typename T>
+TriggerImpl<T>::~TriggerImpl() {
+  delete m_pending.load(std::memory_order_relaxed);
+  delete m_spare.load(std::memory_order_relaxed);
+}
+
 template <typename T>
 void TriggerImpl<T>::loadVal(const boost::optional<T>& opT) {
-  m_mutex.lock();
-  if (!(m_state && !(*m_state)))
-    m_state = boost::optional<boost::optional<T>>(opT);
-  m_mutex.unlock();
+  if (m_endLoaded.load(std::memory_order_acquire))
+    return;
+  if (!opT) {
+    m_endLoaded.store(true, std::memory_order_release);
+    return;
+  }
+  T* value = m_spare.exchange(nullptr, std::memory_order_acq_rel);
+  if (value)
+    *value = *opT;
+  else
+    value = new T(*opT);
+  if (T* const replaced = m_pending.exchange(value, std::memory_order_acq_rel))
+    recycle(replaced);
 }
+
 template <typename T>
 boost::optional<boost::optional<T>> TriggerImpl<T>::pullVal(const double time) {
-  m_mutex.lock();
-
-  const boost::optional<boost::optional<T>> ret =
-      m_state ? (*m_state ? boost::optional<boost::optional<T>>(
-                                boost::optional<T>(**m_state))
-                          : boost::optional<boost::optional<T>>())
-              : boost::optional<boost::optional<T>>(boost::optional<T>());
-  if (ret)
-    m_state = boost::optional<boost::optional<T>>();
-  m_mutex.unlock();
+  m_lastPullOccurred = false;
+  if (m_endLoaded.load(std::memory_order_acquire))
+    return boost::none;
+  T* const pending = m_pending.exchange(nullptr, std::memory_order_acq_rel);
+  if (!pending)
+    return boost::optional<boost::optional<T>>(boost::optional<T>());
+  boost::optional<boost::optional<T>> ret(
+      boost::optional<T>(std::move(*pending)));
+  recycle(pending);
+  m_lastPullOccurred = true;
   return ret;
 }
+
+template <typename T>
+void TriggerImpl<T>::recycle(T* value) {
+  delete m_spare.exchange(value, std::memory_order_acq_rel);
+}
+
+template <typename T>
+bool TriggerImpl<T>::changed() {
+  return m_lastPullOccurred ||
+         m_endLoaded.load(std::memory_order_acquire) ||
+         m_pending.load(std::memory_order_acquire);
+}
 }
 #endif
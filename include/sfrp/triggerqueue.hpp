@@ -0,0 +1,218 @@
+#ifndef SFRP_TRIGGERQUEUE_HPP_
+#define SFRP_TRIGGERQUEUE_HPP_
+
+//@PURPOSE: Provide a lock-free trigger state that keeps every occurrence.
+//
+//@CLASSES:
+//  sfrp::TriggerQueue: multi-producer trigger state with batched occurrences
+//
+//@SEE_ALSO: sfrp_triggerutil
+//
+//@DESCRIPTION: This component provides a single class template,
+// 'TriggerQueue', that implements the state of a trigger whose occurrences are
+// batches of all the values loaded since the previous pull. It is used by
+// 'TriggerUtil::queuedTrigger()'.
+//
+// Unlike 'TriggerImpl', which keeps only the last value loaded between two
+// pulls, 'TriggerQueue' keeps loaded values in a bounded ring buffer. Any
+// number of threads may call 'loadVal()' concurrently without locking. A
+// single thread, the one pulling the behavior graph, calls 'pullVal()' and
+// 'changed()'.
+//
+// A pull removes the values loaded so far, at most the capacity of the queue,
+// and returns them in loading order as a single occurrence. Values loaded by
+// different threads are ordered by the time they claimed their slot. A pull
+// without loaded values returns no occurrence.
+//
+// Loading 'boost::none' signals the end of the trigger. The values loaded
+// before the end signal are still delivered, after which the trigger is no
+// longer defined. Values loaded after the end signal are ignored.
+//
+// When the ring buffer is full, 'loadVal()' yields until the consumer makes
+// room, so no values are lost. 'tryLoadVal()' returns 'false' instead.
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: Collecting ticks from several threads
+// - - - - - - - - - - - - - - - - - - - - - - - -
+// Say several feed threads report prices. All of the prices reported between
+// two frames are handled at the next frame.
+//..
+//  auto queue = boost::make_shared<sfrp::TriggerQueue<double>>(4096);
+//  // on each feed thread
+//  queue->loadVal(boost::make_optional(price));
+//  // on the pulling thread, 'prices' is 'make_optional(make_optional(...))'
+//  // with all prices loaded since the previous pull
+//  auto prices = queue->pullVal(time);
+//..
+
+#include <boost/optional.hpp>
+#include <atomic>
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::intptr_t
+#include <memory>   // std::unique_ptr
+#include <thread>   // std::this_thread::yield
+#include <vector>
+
+namespace sfrp {
+
+// This class implements the lock-free state of a trigger that keeps every
+// value loaded between pulls.
+template <typename T>
+struct TriggerQueue {
+  // Create an empty queue that holds at least the specified 'capacity'
+  // values. The behavior is undefined unless 'capacity > 0'.
+  explicit TriggerQueue(std::size_t capacity = 1024);
+
+  TriggerQueue(const TriggerQueue&) = delete;
+  TriggerQueue& operator=(const TriggerQueue&) = delete;
+
+  // Return the number of values this queue can hold.
+  std::size_t capacity() const;
+
+  // Load the specified 'opT' into this queue, waiting while it is full. If
+  // 'opT' is 'boost::none' the trigger ends after the values loaded before
+  // it. Do nothing if the end was already loaded. This function is thread
+  // safe.
+  void loadVal(const boost::optional<T>& opT);
+
+  // Load the specified 'opT' as 'loadVal()' does unless this queue is full.
+  // Return 'false' if this queue is full and 'true' otherwise. This function
+  // is thread safe.
+  bool tryLoadVal(const boost::optional<T>& opT);
+
+  // Return the values loaded since the previous pull, in loading order, as
+  // an occurrence at the specified 'time', no occurrence if no value was
+  // loaded, and 'boost::none' if the end of the trigger was reached.
+  boost::optional<boost::optional<std::vector<T>>> pullVal(const double time);
+
+  // Return 'true' if the next 'pullVal()' may return something different than
+  // the previous one. That is the case if a value is loaded or if the
+  // previous pull returned an occurrence.
+  bool changed() const;
+
+ private:
+  // A slot of the ring buffer. A slot at position 'p' is free for a producer
+  // when its sequence is 'p' and holds a value for the consumer when it is
+  // 'p + 1'.
+  struct Cell {
+    std::atomic<std::size_t> sequence;
+    boost::optional<T> value;
+  };
+
+  std::unique_ptr<Cell[]> m_cells;
+  std::size_t m_mask;
+  alignas(64) std::atomic<std::size_t> m_enqueuePosition;
+  alignas(64) std::size_t m_dequeuePosition;
+  std::atomic<bool> m_endLoaded;
+  bool m_ended;
+  bool m_lastPullOccurred;
+};
+
+// ===========================================================================
+//                 INLINE DEFINITIONS
+// ===========================================================================
+
+template <typename T>
+TriggerQueue<T>::TriggerQueue(std::size_t capacity)
+    : m_cells(),
+      m_mask(0),
+      m_enqueuePosition(0),
+      m_dequeuePosition(0),
+      m_endLoaded(false),
+      m_ended(false),
+      m_lastPullOccurred(false) {
+  std::size_t size = 1;
+  while (size < capacity)
+    size *= 2;
+  m_cells.reset(new Cell[size]);
+  m_mask = size - 1;
+  for (std::size_t i = 0; i < size; ++i)
+    m_cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template <typename T>
+std::size_t TriggerQueue<T>::capacity() const {
+  return m_mask + 1;
+}
+
+template <typename T>
+void TriggerQueue<T>::loadVal(const boost::optional<T>& opT) {
+  while (!tryLoadVal(opT))
+    std::this_thread::yield();
+}
+
+template <typename T>
+bool TriggerQueue<T>::tryLoadVal(const boost::optional<T>& opT) {
+  if (m_endLoaded.load(std::memory_order_acquire))
+    return true;
+
+  std::size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+  Cell* cell;
+  for (;;) {
+    cell = &m_cells[position & m_mask];
+    const std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    const std::intptr_t difference =
+        std::intptr_t(sequence) - std::intptr_t(position);
+    if (difference == 0) {
+      if (m_enqueuePosition.compare_exchange_weak(
+              position, position + 1, std::memory_order_relaxed))
+        break;
+    } else if (difference < 0) {
+      // The consumer hasn't freed this slot yet.
+      return false;
+    } else {
+      position = m_enqueuePosition.load(std::memory_order_relaxed);
+    }
+  }
+  cell->value = opT;
+  if (!opT)
+    m_endLoaded.store(true, std::memory_order_release);
+  cell->sequence.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+boost::optional<boost::optional<std::vector<T>>> TriggerQueue<T>::pullVal(
+    const double time) {
+  if (m_ended)
+    return boost::none;
+
+  std::vector<T> values;
+  for (std::size_t i = 0; i <= m_mask; ++i) {
+    Cell& cell = m_cells[m_dequeuePosition & m_mask];
+    if (cell.sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1)
+      break;
+    const bool isEnd = !cell.value;
+    if (!isEnd)
+      values.push_back(std::move(*cell.value));
+    cell.value = boost::none;
+    cell.sequence.store(m_dequeuePosition + m_mask + 1,
+                        std::memory_order_release);
+    ++m_dequeuePosition;
+    if (isEnd) {
+      m_ended = true;
+      break;
+    }
+  }
+
+  m_lastPullOccurred = !values.empty();
+  if (m_lastPullOccurred)
+    return boost::make_optional(boost::make_optional(std::move(values)));
+  else if (m_ended)
+    return boost::none;
+  else
+    return boost::make_optional(boost::optional<std::vector<T>>());
+}
+
+template <typename T>
+bool TriggerQueue<T>::changed() const {
+  if (m_lastPullOccurred)
+    return true;
+  const Cell& cell = m_cells[m_dequeuePosition & m_mask];
+  return cell.sequence.load(std::memory_order_acquire) == m_dequeuePosition + 1;
+}
+}
+#endif
@@ -0,0 +1,11 @@
+#ifndef SFRP_TRIGGERQUEUE_T_HPP_
+#define SFRP_TRIGGERQUEUE_T_HPP_
+
+namespace stest {
+struct TestCollector;
+}
+
+namespace sfrp {
+void triggerqueueTests(stest::TestCollector&);
+}
+#endif
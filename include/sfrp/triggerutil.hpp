@@ -6,13 +6,21 @@
 #include <boost/optional.hpp>
 #include <sfrp/behavior.hpp>
 #include <sfrp/eventutil.hpp>
+#include <sfrp/timestampedtrigger.hpp>
 #include <sfrp/triggerimpl.hpp>
+#include <sfrp/triggerqueue.hpp>
+#include <cstddef>  // std::size_t
+#include <vector>
 
 namespace sfrp {
 struct TriggerUtil {
   // Create an event-like behavior that occurs whenever the returned function is
   // called. If the returned function is called with boost::none, it signifies
-  // the end of the behavior. The function is thread-safe.
+  // the end of the behavior. The function is lock-free and may be called
+  // concurrently by many threads. Only the last value passed since the
+  // previous pull occurs; use 'queuedTrigger()' to keep every value. The
+  // behavior is a polled node, see sfrp_behaviornode, that changes only when
+  // the function was called or an occurrence was pulled.
   template <typename T>
   static std::pair<Behavior<boost::optional<T>>,
                    boost::function<void(const boost::optional<T>&)>>
@@ -25,9 +33,37 @@ struct TriggerUtil {
                    boost::function<void(const T&)>>
       triggerInf();
 
+  // Create an event-like behavior whose occurrences are batches, in loading
+  // order, of all the values passed to the returned function since the
+  // previous pull. If the returned function is called with 'boost::none', the
+  // behavior ends after the values passed before. The returned function is
+  // lock-free, may be called concurrently by many threads and waits while the
+  // optionally specified 'capacity' values are awaiting a pull. The behavior
+  // is a polled node like that of 'trigger()'. See sfrp_triggerqueue.
+  template <typename T>
+  static std::pair<Behavior<boost::optional<std::vector<T>>>,
+                   boost::function<void(const boost::optional<T>&)>>
+      queuedTrigger(std::size_t capacity = 1024);
+
+  // Create a never-ending event-like behavior whose occurrences are batches,
+  // ordered by time, of the values passed to the returned function paired
+  // with the times passed with them. Each value is delivered by the first pull
+  // whose time is the optionally specified 'allowedLateness' past the time
+  // passed with it. The returned function is lock-free, may be called
+  // concurrently by many threads and waits while the optionally specified
+  // 'capacity' values are awaiting a pull. See sfrp_timestampedtrigger.
+  template <typename T>
+  static std::pair<
+      Behavior<boost::optional<
+          std::vector<typename TimestampedTrigger<T>::Occurrence>>>,
+      boost::function<void(double, const T&)>>
+  timestampedTrigger(double allowedLateness = 0.0,
+                     std::size_t capacity = 1024);
+
   // Create a never-ending behavior whose value is initial the specified 't0'
   // and will change based on calls to the resulting function.  The resulting
-  // function is thread safe.
+  // function is thread safe. Like the result of 'EventUtil::step()', the
+  // resulting behavior only reports a change of its value after a call.
   template <typename T>
   static std::pair<Behavior<T>, boost::function<void(const T&)>> triggerInfStep(
       const T& t0);
@@ -42,10 +78,13 @@ std::pair<Behavior<boost::optional<T>>,
           boost::function<void(const boost::optional<T>&)>>
 TriggerUtil::trigger() {
   const auto triggerImpPtr = boost::make_shared<TriggerImpl<T>>();
-  return std::make_pair(
+  Behavior<boost::optional<T>> event =
       Behavior<boost::optional<T>>::fromValuePullFunc(
-          boost::bind(&TriggerImpl<T>::pullVal, triggerImpPtr, _1)),
-      boost::bind(&TriggerImpl<T>::loadVal, triggerImpPtr, _1));
+          boost::bind(&TriggerImpl<T>::pullVal, triggerImpPtr, _1));
+  event.node()->setPolled(
+      boost::bind(&TriggerImpl<T>::changed, triggerImpPtr));
+  return std::make_pair(
+      event, boost::bind(&TriggerImpl<T>::loadVal, triggerImpPtr, _1));
 }
 
 template <typename T>
@@ -57,6 +96,36 @@ TriggerUtil::triggerInf() {
   });
 }
 
+template <typename T>
+std::pair<Behavior<boost::optional<std::vector<T>>>,
+          boost::function<void(const boost::optional<T>&)>>
+TriggerUtil::queuedTrigger(std::size_t capacity) {
+  const auto queue = boost::make_shared<TriggerQueue<T>>(capacity);
+  Behavior<boost::optional<std::vector<T>>> event =
+      Behavior<boost::optional<std::vector<T>>>::fromValuePullFunc(
+          boost::bind(&TriggerQueue<T>::pullVal, queue, _1));
+  event.node()->setPolled(boost::bind(&TriggerQueue<T>::changed, queue));
+  return std::make_pair(
+      event, boost::bind(&TriggerQueue<T>::loadVal, queue, _1));
+}
+
+template <typename T>
+std::pair<Behavior<boost::optional<
+              std::vector<typename TimestampedTrigger<T>::Occurrence>>>,
+          boost::function<void(double, const T&)>>
+TriggerUtil::timestampedTrigger(double allowedLateness, std::size_t capacity) {
+  typedef boost::optional<
+      std::vector<typename TimestampedTrigger<T>::Occurrence>> Batch;
+  const auto trigger =
+      boost::make_shared<TimestampedTrigger<T>>(allowedLateness, capacity);
+  Behavior<Batch> event = Behavior<Batch>::fromValuePullFunc(
+      boost::bind(&TimestampedTrigger<T>::pullVal, trigger, _1));
+  event.node()->setPolled(
+      boost::bind(&TimestampedTrigger<T>::changed, trigger));
+  return std::make_pair(
+      event, boost::bind(&TimestampedTrigger<T>::loadVal, trigger, _1, _2));
+}
+
 template <typename T>
 std::pair<Behavior<T>, boost::function<void(const T&)>>
 TriggerUtil::triggerInfStep(const T& t0) {
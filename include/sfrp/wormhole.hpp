@@ -6,7 +6,7 @@
 //@CLASSES:
 //  sfrp::Wormhole: circular connection between behaviors
 //
-//@SEE_ALSO: sfrp_wormholeutil
+//@SEE_ALSO: sfrp_wormholeutil, sfrp_behaviorcheckpoint
 //
 //@DESCRIPTION: This component provides a single class, 'Wormhole', that allows
 // one to make connections in a FRP dependency graph that are circular.
@@ -54,12 +54,34 @@
 // wormhole is kept up-to-date. It is important that the return value of
 // 'setInputBehavior' is pulled at every time of interest otherwise
 // 'outputBehavior' will return values that are out of date.
+//
+// Incremental Evaluation
+// ----------------------
+// The output behavior of a wormhole is a derived node without children and
+// the behavior returned by 'setInputBehavior' is a derived node of its input
+// (see sfrp_behaviornode). Whenever a value different from the current output
+// is fed into the wormhole, the output node is marked dirty. Values are
+// compared as those of distinct behaviors are, see
+// 'CachedIncreasingPartialTimeFunction_ValueComparison'. Values of types
+// without an 'operator==' are always considered different.
+//
+// Checkpoints
+// -----------
+// A wormhole created while a 'BehaviorCheckpointScope' is active adds its
+// current output, a 'boost::optional<T>', to the registry of the scope (see
+// sfrp_behaviorcheckpoint). Restoring it marks the output node dirty.
 
-#include <boost/make_shared.hpp>
 #include <boost/optional.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
 #include <sfrp/behavior.hpp>
+#include <sfrp/behaviorcheckpoint.hpp>
+#include <sfrp/behaviorgrapharena.hpp>
+#include <sfrp/cachedincreasingpartialtimefunction.hpp>
+#include <sfrp/behaviornode.hpp>
+#include <sfrp/graphpointer.hpp>
 #include <utility>  // std::pair
+#include <vector>
 
 namespace sfrp {
 
@@ -89,9 +111,9 @@ struct Wormhole {
   template <typename T>
   friend struct Wormhole_ClosedBehaviorFunction;
 
-  Wormhole(const boost::shared_ptr<std::pair<bool, boost::optional<T>>>& data_);
+  Wormhole(const GraphPointer<std::pair<bool, boost::optional<T>>>& data_);
 
-  boost::shared_ptr<std::pair<bool, boost::optional<T>>> m_data;
+  GraphPointer<std::pair<bool, boost::optional<T>>> m_data;
 
   sfrp::Behavior<T> m_outputBehavior;
 };
@@ -102,7 +124,7 @@ struct Wormhole {
 
 template <typename T>
 Wormhole<T>::Wormhole(
-    const boost::shared_ptr<std::pair<bool, boost::optional<T>>>& data_)
+    const GraphPointer<std::pair<bool, boost::optional<T>>>& data_)
     : m_data(data_) {}
 
 template <typename T>
@@ -119,19 +141,40 @@ sfrp::Behavior<T> Wormhole<T>::outputBehavior() const
 template <typename T>
 struct Wormhole_BehaviorFunction {
   Wormhole_BehaviorFunction(
-      const boost::shared_ptr<std::pair<bool, boost::optional<T>>>& data_)
+      const GraphPointer<std::pair<bool, boost::optional<T>>>& data_)
       : data(data_) {}
   typedef boost::optional<T> result_type;
   result_type operator()(const double time) const { return data->second; }
-  boost::shared_ptr<std::pair<bool, boost::optional<T>>> data;
+  GraphPointer<std::pair<bool, boost::optional<T>>> data;
 };
 
 template <typename T>
 Wormhole<T>::Wormhole(const T& value)
-    : m_data(boost::make_shared<std::pair<bool, boost::optional<T>>>(false,
-                                                                     value)),
+    : m_data(
+          BehaviorGraphArena::makeGraphPointer<
+              std::pair<bool, boost::optional<T>>>(false, value)),
       m_outputBehavior(Behavior<T>::fromValuePullFunc(
-          Wormhole_BehaviorFunction<T>(m_data))) {}
+          Wormhole_BehaviorFunction<T>(m_data))) {
+  m_outputBehavior.nodeAddress()->setDerived(
+      std::vector<boost::shared_ptr<BehaviorNode>>());
+  if (BehaviorCheckpoint* const checkpoint = BehaviorCheckpoint::current()) {
+    const boost::weak_ptr<std::pair<bool, boost::optional<T>>> data =
+        boost::shared_ptr<std::pair<bool, boost::optional<T>>>(m_data);
+    const boost::weak_ptr<BehaviorNode> output = m_outputBehavior.node();
+    checkpoint->addState(
+        [data]() {
+          const auto lockedData = data.lock();
+          return lockedData ? boost::any(lockedData->second) : boost::any();
+        },
+        [data, output](const boost::any& value) {
+          if (const auto lockedData = data.lock())
+            lockedData->second =
+                boost::any_cast<const boost::optional<T>&>(value);
+          if (const auto lockedOutput = output.lock())
+            lockedOutput->markDirty();
+        });
+  }
+}
 
 template <typename T>
 struct Wormhole_ClosedBehaviorFunction {
@@ -140,7 +183,23 @@ struct Wormhole_ClosedBehaviorFunction {
       : wh(wh_), pm(pm_) {}
   typedef boost::optional<T> result_type;
   result_type operator()(const double time) const {
-    return wh.m_data->second = pm.pull(time);
+    result_type value = pm.pull(time);
+    if (differ(wh.m_data->second, value)) {
+      wh.m_data->second = value;
+      if (BehaviorNode* const output = wh.m_outputBehavior.nodeAddress())
+        output->markDirty();
+    }
+    return value;
+  }
+  // Return 'false' if the specified 'lhs' and 'rhs' are known to be equal and
+  // 'true' otherwise.
+  static bool differ(const result_type& lhs, const result_type& rhs) {
+    const auto equal =
+        CachedIncreasingPartialTimeFunction_ValueComparison<T>::function();
+    if (lhs && rhs)
+      return !equal || !equal(*lhs, *rhs);
+    else
+      return bool(lhs) != bool(rhs);
   }
   Wormhole<T> wh;
   Behavior<T> pm;
@@ -149,7 +208,10 @@ struct Wormhole_ClosedBehaviorFunction {
 template <typename T>
 Behavior<T> Wormhole<T>::setInputBehavior(const Behavior<T>& pm) const {
   m_data->first = true;
-  return Behavior<T>::fromValuePullFunc(Wormhole_ClosedBehaviorFunction<T>(*this, pm));
+  Behavior<T> result =
+      Behavior<T>::fromValuePullFunc(Wormhole_ClosedBehaviorFunction<T>(*this, pm));
+  result.nodeAddress()->setDerived({pm.node()});
+  return result;
 }
 }
 #endif
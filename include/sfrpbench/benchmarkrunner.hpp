@@ -0,0 +1,130 @@
+#ifndef SFRPBENCH_BENCHMARKRUNNER_HPP_
+#define SFRPBENCH_BENCHMARKRUNNER_HPP_
+
+//@PURPOSE: Provide a runner that measures the pull rate of behavior graphs.
+//
+//@CLASSES:
+//  sfrpbench::BenchmarkRunner: registry and runner of graph benchmarks
+//  sfrpbench::BenchmarkRunner_Result: measurements of a single benchmark
+//  sfrpbench::BenchmarkRunner_AllocationCounter: global allocation counter
+//
+//@SEE_ALSO: sfrpbench_benchmarks
+//
+//@DESCRIPTION: This component provides a class, 'BenchmarkRunner', that runs
+// a set of named benchmarks. A benchmark is a factory of pull functions. For
+// each repetition of a benchmark the runner creates a fresh graph with the
+// factory and calls the pull function at a fixed number of increasing times,
+// measuring the elapsed time and the number of allocations of the pulls.
+// Graph construction is not measured.
+//
+// The number of pulls and allocations of a benchmark depend only upon the
+// library and are expected to be identical from run to run. The time per pull
+// is the median over the repetitions. 'print()' writes the results one line
+// per benchmark, in registration order, so the outputs of two releases may be
+// compared with 'diff'. Timings can be omitted from the output to make such
+// comparisons exact.
+//
+// Allocations are counted by 'BenchmarkRunner_AllocationCounter', which is
+// incremented by the replacement global 'operator new' of the benchmark
+// executable. Without that replacement all allocation counts are zero.
+//
+// Usage
+// -----
+// This section illustrates intended use of this component.
+//
+// Example 1: Benchmarking a behavior
+// - - - - - - - - - - - - - - - - -
+//..
+//  sfrpbench::BenchmarkRunner runner;
+//  runner.add("time", 10000, []() -> boost::function<void(double)> {
+//    const sfrp::Behavior<double> time = sfrp::BehaviorUtil::time();
+//    return [time](double t) { time.pull(t); };
+//  });
+//  sfrpbench::BenchmarkRunner::print(std::cout, runner.run(""), true);
+//..
+
+#include <boost/function.hpp>
+#include <atomic>
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::uint64_t
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace sfrpbench {
+
+// This class implements the measurements of a single benchmark.
+struct BenchmarkRunner_Result {
+  std::string name;
+  std::size_t numPulls;
+  std::uint64_t numAllocations;
+  double nanosecondsPerPull;
+};
+
+// This class provides a namespace for the allocation counter of the current
+// process.
+struct BenchmarkRunner_AllocationCounter {
+  // Record a single allocation.
+  static void increment();
+
+  // Return the number of allocations recorded so far.
+  static std::uint64_t count();
+
+ private:
+  static std::atomic<std::uint64_t> s_count;
+};
+
+// This class implements a registry and runner of behavior graph benchmarks.
+struct BenchmarkRunner {
+  // A function that creates a new graph and returns a function that pulls it
+  // at a time.
+  typedef boost::function<boost::function<void(double)>()> GraphFactory;
+
+  // Create a runner without benchmarks that runs each benchmark the specified
+  // 'numRepetitions' times.
+  explicit BenchmarkRunner(unsigned numRepetitions = 5);
+
+  // Add a benchmark with the specified 'name' that pulls graphs created with
+  // the specified 'factory' at the specified 'numPulls' increasing times.
+  void add(const std::string& name,
+           std::size_t numPulls,
+           const GraphFactory& factory);
+
+  // Run the benchmarks whose name contains the specified 'filter' and return
+  // their results in the order they were added.
+  std::vector<BenchmarkRunner_Result> run(const std::string& filter) const;
+
+  // Write the specified 'results' to the specified 'stream', one line per
+  // result, and include the time measurements if the specified
+  // 'includeTimes' is 'true'.
+  static void print(std::ostream& stream,
+                    const std::vector<BenchmarkRunner_Result>& results,
+                    bool includeTimes);
+
+  // The interval between the times at which graphs are pulled.
+  static const double k_TIME_STEP;
+
+ private:
+  struct Benchmark {
+    std::string name;
+    std::size_t numPulls;
+    GraphFactory factory;
+  };
+
+  unsigned m_numRepetitions;
+  std::vector<Benchmark> m_benchmarks;
+};
+
+// ===========================================================================
+//                 INLINE DEFINITIONS
+// ===========================================================================
+
+inline void BenchmarkRunner_AllocationCounter::increment() {
+  s_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline std::uint64_t BenchmarkRunner_AllocationCounter::count() {
+  return s_count.load(std::memory_order_relaxed);
+}
+}
+#endif
@@ -0,0 +1,45 @@
+#ifndef SFRPBENCH_BENCHMARKS_HPP_
+#define SFRPBENCH_BENCHMARKS_HPP_
+
+//@PURPOSE: Collect the benchmarks of the sfrp package.
+//
+//@FUNCTIONS: sfrpbench::benchmarks
+//
+//@SEE_ALSO: sfrpbench_benchmarkrunner
+//
+//@DESCRIPTION: This component provides a single function, 'benchmarks()',
+// that adds the benchmarks of the sfrp package to a 'BenchmarkRunner'. The
+// benchmarks cover the following graph shapes.
+//
+//: o 'mapChain': a long chain of 'BehaviorMap' applications.
+//:
+//: o 'fanIn': a tree of 'BehaviorMap' applications over many sources.
+//:
+//: o 'wormholeSum' and 'wormholeIntegral': the 'Wormhole' feedback loops of
+//:   'VectorSpaceUtil::sum()' and 'VectorSpaceUtil::integral()'.
+//:
+//: o 'accumulate': 'EventUtil::accumulate()' over an event that occurs at
+//:   every pull.
+//:
+//: o 'joinSwitch': 'JoinUtil::join()' switching to a new behavior at regular
+//:   intervals.
+//:
+//: o 'triggerInjection': a 'TriggerUtil::triggerInfStep()' behavior that is
+//:   set before every pull.
+//
+// The benchmarks whose names end with '/scheduled' pull the same graph as the
+// benchmark without the suffix with a 'BehaviorSchedule' instead of
+// recursively.
+//
+// The names and sizes of the benchmarks are part of their identity. A change
+// of either should come with a new name so that results of different releases
+// remain comparable.
+
+namespace sfrpbench {
+struct BenchmarkRunner;
+
+// Add the benchmarks of the sfrp package to the specified 'runner'.
+void benchmarks(BenchmarkRunner& runner);
+}
+
+#endif
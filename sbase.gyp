@@ -3,6 +3,14 @@
         '../build/common.gypi',
     ],
 
+    'variables': {
+        # Set to 1 to enable sfrp_behaviorprofiler.
+        'sfrp_profile%': 0,
+        # Set to 1 to use non-atomic reference counts in sfrp, see
+        # sfrp_graphpointer.
+        'sfrp_single_threaded%': 0,
+    },
+
     'targets': [
         {
             "target_name": 'sbasetest_main',
@@ -103,6 +111,20 @@
         {
             "target_name": 'sfrp',
             "type": 'static_library',
+            'conditions': [
+                ['sfrp_profile==1', {
+                    'defines': [ 'SFRP_PROFILE' ],
+                    'direct_dependent_settings': {
+                        'defines': [ 'SFRP_PROFILE' ],
+                    },
+                }],
+                ['sfrp_single_threaded==1', {
+                    'defines': [ 'SFRP_SINGLE_THREADED' ],
+                    'direct_dependent_settings': {
+                        'defines': [ 'SFRP_SINGLE_THREADED' ],
+                    },
+                }],
+            ],
             'dependencies': [
                 '../boost-gyp/boost.gyp:boost.headers',
                 'sboost',
@@ -121,9 +143,49 @@
             'include_dirs': [ 'include' ],
             'sources': [
                 'src/sfrp_behavior.cpp',
+                'src/sfrp_behaviorarray.cpp',
+                'src/sfrp_behaviorarray.t.cpp',
+                'src/sfrp_behaviorcheckpoint.cpp',
+                'src/sfrp_behaviorcheckpoint.t.cpp',
+                'src/sfrp_behaviordriver.cpp',
+                'src/sfrp_behaviordriver.t.cpp',
+                'src/sfrp_behaviorgrapharena.cpp',
+                'src/sfrp_behaviorgrapharena.t.cpp',
+                'src/sfrp_behaviorhashcons.cpp',
+                'src/sfrp_behaviorhashcons.t.cpp',
+                'src/sfrp_behaviornode.cpp',
+                'src/sfrp_behaviornode.t.cpp',
+                'src/sfrp_behaviorprofiler.cpp',
+                'src/sfrp_behaviorprofiler.t.cpp',
+                'src/sfrp_behaviorschedule.cpp',
+                'src/sfrp_behaviorschedule.t.cpp',
+                'src/sfrp_eventrecorder.cpp',
+                'src/sfrp_eventrecorder.t.cpp',
+                'src/sfrp_graphpointer.cpp',
+                'src/sfrp_graphpointer.t.cpp',
+                'src/sfrp_incrementalengine.cpp',
+                'src/sfrp_incrementalengine.t.cpp',
+                'src/sfrp_montecarlorunner.cpp',
+                'src/sfrp_montecarlorunner.t.cpp',
                 'src/sfrp_normedvectorspaceutil.cpp',
                 'src/sfrp_normedvectorspaceutil.t.cpp',
+                'src/sfrp_pullthreadpool.cpp',
+                'src/sfrp_pullthreadpool.t.cpp',
+                'src/sfrp_sparseevent.cpp',
+                'src/sfrp_sparseevent.t.cpp',
+                'src/sfrp_sparseeventutil.cpp',
+                'src/sfrp_sparseeventutil.t.cpp',
+                'src/sfrp_staticbehavior.cpp',
+                'src/sfrp_staticbehavior.t.cpp',
+                'src/sfrp_staticbehavioroperators.cpp',
+                'src/sfrp_staticbehavioroperators.t.cpp',
+                'src/sfrp_staticbehaviorutil.cpp',
+                'src/sfrp_staticbehaviorutil.t.cpp',
                 'src/sfrp_tests.cpp',
+                'src/sfrp_timestampedtrigger.cpp',
+                'src/sfrp_timestampedtrigger.t.cpp',
+                'src/sfrp_triggerqueue.cpp',
+                'src/sfrp_triggerqueue.t.cpp',
                 'src/sfrp_util.cpp',
                 'src/sfrp_util.t.cpp',
                 'src/sfrp_vectorspaceutil.cpp',
@@ -134,6 +196,32 @@
                 'src/sfrp_wormholeutil.t.cpp',
             ],
         },
+        {
+            "target_name": 'sfrpbench_main',
+            "type": 'executable',
+            'dependencies': [
+                'sfrpbench',
+            ],
+            'sources': [
+                'src/sfrpbench_main.cpp',
+            ],
+        },
+        {
+            "target_name": 'sfrpbench',
+            "type": 'static_library',
+            'dependencies': [
+                'sfrp',
+                'smisc',
+            ],
+            'direct_dependent_settings': {
+                'include_dirs': [ 'include' ],
+            },
+            'include_dirs': [ 'include' ],
+            'sources': [
+                'src/sfrpbench_benchmarkrunner.cpp',
+                'src/sfrpbench_benchmarks.cpp',
+            ],
+        },
         {
             "target_name": 'smisc',
             "type": 'static_library',
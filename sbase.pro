@@ -39,16 +39,32 @@ SOURCES += src/sfp_fliputil.t.cpp
 SOURCES += src/sfp_tests.cpp
 SOURCES += src/sfrp_behavior.cpp
 SOURCES += src/sfrp_behavior.t.cpp
+SOURCES += src/sfrp_behaviorarray.cpp
+SOURCES += src/sfrp_behaviorarray.t.cpp
+SOURCES += src/sfrp_behaviorcheckpoint.cpp
+SOURCES += src/sfrp_behaviorcheckpoint.t.cpp
 SOURCES += src/sfrp_behaviordebugutil.cpp
 SOURCES += src/sfrp_behaviordebugutil.t.cpp
+SOURCES += src/sfrp_behaviordriver.cpp
+SOURCES += src/sfrp_behaviordriver.t.cpp
+SOURCES += src/sfrp_behaviorgrapharena.cpp
+SOURCES += src/sfrp_behaviorgrapharena.t.cpp
+SOURCES += src/sfrp_behaviorhashcons.cpp
+SOURCES += src/sfrp_behaviorhashcons.t.cpp
 SOURCES += src/sfrp_behaviormap.cpp
 SOURCES += src/sfrp_behaviormap.t.cpp
+SOURCES += src/sfrp_behaviornode.cpp
+SOURCES += src/sfrp_behaviornode.t.cpp
 SOURCES += src/sfrp_behavioroperators.cpp
 SOURCES += src/sfrp_behavioroperators.t.cpp
 SOURCES += src/sfrp_behaviorpairutil.cpp
 SOURCES += src/sfrp_behaviorpairutil.t.cpp
+SOURCES += src/sfrp_behaviorprofiler.cpp
+SOURCES += src/sfrp_behaviorprofiler.t.cpp
 SOURCES += src/sfrp_behaviorpuller.cpp
 SOURCES += src/sfrp_behaviorpuller.t.cpp
+SOURCES += src/sfrp_behaviorschedule.cpp
+SOURCES += src/sfrp_behaviorschedule.t.cpp
 SOURCES += src/sfrp_behaviortimeutil.cpp
 SOURCES += src/sfrp_behaviortimeutil.t.cpp
 SOURCES += src/sfrp_behaviorutil.cpp
@@ -63,18 +79,42 @@ SOURCES += src/sfrp_eventmap.cpp
 SOURCES += src/sfrp_eventmap.t.cpp
 SOURCES += src/sfrp_eventmapfunctionadapter.cpp
 SOURCES += src/sfrp_eventmapfunctionadapter.t.cpp
+SOURCES += src/sfrp_eventrecorder.cpp
+SOURCES += src/sfrp_eventrecorder.t.cpp
 SOURCES += src/sfrp_eventutil.cpp
 SOURCES += src/sfrp_eventutil.t.cpp
+SOURCES += src/sfrp_graphpointer.cpp
+SOURCES += src/sfrp_graphpointer.t.cpp
 SOURCES += src/sfrp_increasingpartialtimefunction.cpp
 SOURCES += src/sfrp_increasingpartialtimefunction.t.cpp
+SOURCES += src/sfrp_incrementalengine.cpp
+SOURCES += src/sfrp_incrementalengine.t.cpp
 SOURCES += src/sfrp_joinpullfunc.cpp
 SOURCES += src/sfrp_joinutil.cpp
 SOURCES += src/sfrp_mapvaluepullfunc.cpp
 SOURCES += src/sfrp_mapvaluepullfunc.t.cpp
+SOURCES += src/sfrp_montecarlorunner.cpp
+SOURCES += src/sfrp_montecarlorunner.t.cpp
 SOURCES += src/sfrp_normedvectorspaceutil.cpp
 SOURCES += src/sfrp_normedvectorspaceutil.t.cpp
+SOURCES += src/sfrp_pullthreadpool.cpp
+SOURCES += src/sfrp_pullthreadpool.t.cpp
+SOURCES += src/sfrp_sparseevent.cpp
+SOURCES += src/sfrp_sparseevent.t.cpp
+SOURCES += src/sfrp_sparseeventutil.cpp
+SOURCES += src/sfrp_sparseeventutil.t.cpp
+SOURCES += src/sfrp_staticbehavior.cpp
+SOURCES += src/sfrp_staticbehavior.t.cpp
+SOURCES += src/sfrp_staticbehavioroperators.cpp
+SOURCES += src/sfrp_staticbehavioroperators.t.cpp
+SOURCES += src/sfrp_staticbehaviorutil.cpp
+SOURCES += src/sfrp_staticbehaviorutil.t.cpp
 SOURCES += src/sfrp_tests.cpp
+SOURCES += src/sfrp_timestampedtrigger.cpp
+SOURCES += src/sfrp_timestampedtrigger.t.cpp
 SOURCES += src/sfrp_triggerimpl.cpp
+SOURCES += src/sfrp_triggerqueue.cpp
+SOURCES += src/sfrp_triggerqueue.t.cpp
 SOURCES += src/sfrp_triggerutil.cpp
 SOURCES += src/sfrp_vectorspaceutil.cpp
 SOURCES += src/sfrp_vectorspaceutil.t.cpp
@@ -82,6 +122,8 @@ SOURCES += src/sfrp_wormhole.cpp
 SOURCES += src/sfrp_wormhole.t.cpp
 SOURCES += src/sfrp_wormholeutil.cpp
 SOURCES += src/sfrp_wormholeutil.t.cpp
+SOURCES += src/sfrpbench_benchmarkrunner.cpp
+SOURCES += src/sfrpbench_benchmarks.cpp
 SOURCES += src/smisc_anyserializer.cpp
 SOURCES += src/smisc_anyserializer.t.cpp
 SOURCES += src/smisc_classserializer.cpp
@@ -121,3 +163,10 @@ SOURCES += src/stest_tests.cpp
 ## Build Options
 
 CONFIG -= qt
+
+# Build with 'CONFIG+=sfrp_profile' to enable sfrp_behaviorprofiler.
+sfrp_profile:DEFINES += SFRP_PROFILE
+
+# Build with 'CONFIG+=sfrp_single_threaded' to use non-atomic reference counts
+# for behavior graphs confined to a thread, see sfrp_graphpointer.
+sfrp_single_threaded:DEFINES += SFRP_SINGLE_THREADED
@@ -3,6 +3,7 @@
 #include <boost/make_shared.hpp>
 #include <sfrp/behavior.hpp>
 #include <stest/testcollector.hpp>
+#include <algorithm>  // std::copy
 #include <chrono>
 #include <ctime>
 #include <list>
@@ -188,5 +189,31 @@ void behaviorTests(stest::TestCollector& col) {
     BOOST_CHECK_EQUAL(sum.pull(1.0), 7);
     BOOST_CHECK_EQUAL(sum.pull(1000.0), 7);
   });
+  col.addTest("sfrp_behavior_pullBatch", []()->void {
+    // Check that a batch function is used when provided and that the scalar
+    // function is used otherwise.
+    int numBatchCalls = 0;
+    sfrp::Behavior<double> b = sfrp::Behavior<double>::fromValuePullFunc(
+        [](double t) { return boost::make_optional(t); },
+        [&numBatchCalls](const double* times, std::size_t n, double* out) {
+          ++numBatchCalls;
+          std::copy(times, times + n, out);
+          return n;
+        },
+        true);
+    sfrp::Behavior<double> c = sfrp::Behavior<double>::fromValuePullFunc(
+        [](double t) { return boost::make_optional(t * 2.0); });
+    BOOST_CHECK(b.isPure());
+    BOOST_CHECK(!c.isPure());
+    const double times[] = {0.0, 1.0, 2.0};
+    double values[3];
+    BOOST_CHECK_EQUAL(b.pullBatch(times, 3, values), 3u);
+    BOOST_CHECK_EQUAL(values[2], 2.0);
+    BOOST_CHECK_EQUAL(numBatchCalls, 1);
+    BOOST_CHECK_EQUAL(c.pullBatch(times, 3, values), 3u);
+    BOOST_CHECK_EQUAL(values[2], 4.0);
+    BOOST_CHECK_EQUAL(sfrp::Behavior<double>().pullBatch(times, 3, values),
+                      0u);
+  });
 }
 }
@@ -0,0 +1 @@
+#include <sfrp/behaviorarray.hpp>
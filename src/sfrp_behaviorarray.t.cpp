@@ -0,0 +1,151 @@
+#include <sfrp/behaviorarray.t.hpp>
+
+#include <boost/optional/optional_io.hpp>
+#include <sfrp/behaviorarray.hpp>
+#include <sfrp/behaviorutil.hpp>
+#include <sfrp/normedvectorspaceutil.hpp>
+#include <sfrp/vectorspaceutil.hpp>
+#include <smisc/point1dnormedvectorspace.hpp>
+#include <smisc/point1dvectorspace.hpp>
+#include <smisc/point2dnormedvectorspace.hpp>
+#include <smisc/point2dvectorspace.hpp>
+#include <stest/testcollector.hpp>
+#include <cmath>
+#include <vector>
+
+namespace sfrp {
+void behaviorarrayTests(stest::TestCollector& col) {
+  col.addTest("sfrp_behaviorarray_valueArray", []()->void {
+    ValueArray<smisc::Point2D> points(3, smisc::Point2D(1.0, 2.0));
+    points.set(1, smisc::Point2D(3.0, 4.0));
+    BOOST_CHECK_EQUAL(points.size(), 3u);
+    BOOST_CHECK_EQUAL(points.xs()[1], 3.0);
+    BOOST_CHECK_EQUAL(points.ys()[1], 4.0);
+    BOOST_CHECK_EQUAL(points.get(2).x, 1.0);
+
+    ValueArray<smisc::Point2D> moved = points;
+    moved.addScaled(2.0, points);
+    BOOST_CHECK_EQUAL(moved.get(1).x, 9.0);
+    BOOST_CHECK_EQUAL(moved.get(1).y, 12.0);
+
+    // The second point is out of reach of its target, the others aren't.
+    const ValueArray<smisc::Point2D> origin(3, smisc::Point2D(0.0, 0.0));
+    moved.moveTowards(origin, 10.0);
+    BOOST_CHECK(moved.get(0).x == 0.0 && moved.get(0).y == 0.0);
+    BOOST_CHECK_EQUAL(moved.get(1).x, 3.0);
+    BOOST_CHECK_EQUAL(moved.get(1).y, 4.0);
+    BOOST_CHECK(moved != points);
+    BOOST_CHECK(points == ValueArray<smisc::Point2D>(points));
+  });
+  col.addTest("sfrp_behaviorarray_sharing", []()->void {
+    // Copies share their values until either of them is modified.
+    ValueArray<smisc::Point2D> points(3, smisc::Point2D(1.0, 2.0));
+    const ValueArray<smisc::Point2D> copy = points;
+    BOOST_CHECK_EQUAL(copy.xs(), points.xs());
+    points.set(0, smisc::Point2D(3.0, 4.0));
+    BOOST_CHECK(copy.xs() != points.xs());
+    BOOST_CHECK_EQUAL(copy.get(0).x, 1.0);
+    BOOST_CHECK_EQUAL(points.get(0).x, 3.0);
+
+    // The sums grow with their argument, and every other pull reuses the
+    // storage of the sums of the pull before the previous one.
+    const BehaviorArray<double> sums =
+        BehaviorArrayUtil::sum(BehaviorUtil::pure([](double time) {
+          return ValueArray<double>(time < 2.0 ? 2 : 3, 1.0);
+        }));
+    BOOST_CHECK_EQUAL(sums.pullPointer(0.0)->size(), 2u);
+    BOOST_CHECK_EQUAL(sums.pullPointer(1.0)->get(1), 2.0);
+    const ValueArray<double>* values = sums.pullPointer(2.0);
+    BOOST_REQUIRE_EQUAL(values->size(), 3u);
+    BOOST_CHECK_EQUAL(values->get(1), 3.0);
+    BOOST_CHECK_EQUAL(values->get(2), 1.0);
+    const double* const storage = sums.pullPointer(3.0)->data();
+    sums.pullPointer(4.0);
+    values = sums.pullPointer(5.0);
+    BOOST_CHECK_EQUAL(values->data(), storage);
+    BOOST_CHECK_EQUAL(values->get(0), 6.0);
+    BOOST_CHECK_EQUAL(values->get(2), 4.0);
+  });
+  col.addTest("sfrp_behaviorarray_integral_sum", []()->void {
+    const std::size_t n = 5;
+    std::vector<Behavior<double>> behaviors;
+    for (std::size_t i = 0; i < n; ++i) {
+      behaviors.push_back(BehaviorUtil::pure(
+          [i](double time) { return std::sin(time + double(i)); }));
+    }
+    const BehaviorArray<double> array =
+        BehaviorArrayUtil::fromBehaviors(behaviors);
+    const BehaviorArray<double> integrals = BehaviorArrayUtil::integral(array);
+    const BehaviorArray<double> sums = BehaviorArrayUtil::sum(array);
+    std::vector<Behavior<double>> expectedIntegrals;
+    std::vector<Behavior<double>> expectedSums;
+    for (const Behavior<double>& behavior : behaviors) {
+      expectedIntegrals.push_back(VectorSpaceUtil::integral(behavior));
+      expectedSums.push_back(VectorSpaceUtil::sum(behavior));
+    }
+    for (int step = 0; step < 10; ++step) {
+      const double time = step * 0.25;
+      const ValueArray<double>* const integralValues =
+          integrals.pullPointer(time);
+      const ValueArray<double>* const sumValues = sums.pullPointer(time);
+      BOOST_REQUIRE(integralValues && sumValues);
+      BOOST_CHECK_EQUAL(integralValues->size(), n);
+      for (std::size_t i = 0; i < n; ++i) {
+        BOOST_CHECK_SMALL(
+            integralValues->get(i) - *expectedIntegrals[i].pull(time), 1e-12);
+        BOOST_CHECK_SMALL(sumValues->get(i) - *expectedSums[i].pull(time),
+                          1e-12);
+      }
+    }
+  });
+  col.addTest("sfrp_behaviorarray_smooth", []()->void {
+    // Targets moving along circles of different radii.
+    const std::size_t n = 4;
+    std::vector<Behavior<smisc::Point2D>> targets;
+    for (std::size_t i = 0; i < n; ++i) {
+      targets.push_back(BehaviorUtil::pure([i](double time) {
+        return smisc::Point2D(i * std::cos(time), i * std::sin(time));
+      }));
+    }
+    const Behavior<smisc::Point1D> velocity = BehaviorUtil::always(1.5);
+    const BehaviorArray<smisc::Point2D> smoothed = BehaviorArrayUtil::smooth(
+        velocity,
+        BehaviorArrayUtil::map(
+            [](const smisc::Point2D& p) { return 2.0 * p; },
+            BehaviorArrayUtil::fromBehaviors(targets)));
+    std::vector<Behavior<smisc::Point2D>> expected;
+    for (const Behavior<smisc::Point2D>& target : targets) {
+      expected.push_back(NormedVectorSpaceUtil::smooth(
+          velocity,
+          BehaviorUtil::pure([target](double time) {
+            return 2.0 * *target.pull(time);
+          })));
+    }
+    for (int step = 0; step < 20; ++step) {
+      const double time = step * 0.1;
+      const ValueArray<smisc::Point2D> values = *smoothed.pull(time);
+      for (std::size_t i = 0; i < n; ++i) {
+        const smisc::Point2D expectedValue = *expected[i].pull(time);
+        BOOST_CHECK_SMALL(values.get(i).x - expectedValue.x, 1e-12);
+        BOOST_CHECK_SMALL(values.get(i).y - expectedValue.y, 1e-12);
+      }
+    }
+  });
+  col.addTest("sfrp_behaviorarray_element", []()->void {
+    ValueArray<double> values(3, 1.0);
+    values.set(2, 5.0);
+    const BehaviorArray<double> array = BehaviorArrayUtil::always(values);
+    BOOST_CHECK(array.isConstant());
+    const Behavior<double> element = BehaviorArrayUtil::element(
+        BehaviorArrayUtil::map([](double x) { return x * x; }, array), 2);
+    BOOST_CHECK_EQUAL(element.pull(0.0), boost::make_optional(25.0));
+    BOOST_CHECK_EQUAL(element.pull(1.0), boost::make_optional(25.0));
+
+    // An array is undefined when any of its behaviors is.
+    const BehaviorArray<double> undefined = BehaviorArrayUtil::fromBehaviors(
+        std::vector<Behavior<double>>{BehaviorUtil::always(1.0),
+                                      Behavior<double>()});
+    BOOST_CHECK(!undefined.pull(0.0));
+  });
+}
+}
@@ -0,0 +1,124 @@
+#include <sfrp/behaviorcheckpoint.hpp>
+
+#include <boost/archive/archive_exception.hpp>
+#include <boost/optional.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+#include <sboost/serializablestringutil.hpp>
+#include <smisc/anyserializer.hpp>
+#include <smisc/cpptypeid.hpp>
+#include <cassert>
+#include <typeinfo>
+#include <utility>  // std::pair
+
+namespace sfrp {
+namespace {
+// The unique type identifier and string of every cell of a checkpoint. Cells
+// of destroyed states have an empty type identifier.
+typedef std::vector<std::pair<std::string, std::string>> CheckpointData;
+
+// The type identifier of the cells of unsavable state that was set.
+const char k_UNSAVABLE_TYPE_ID[] = "sfrp::BehaviorCheckpoint::Unsavable";
+}
+
+BehaviorCheckpoint::BehaviorCheckpoint() : m_mutex(), m_cells() {}
+
+void BehaviorCheckpoint::addState(
+    const boost::function<boost::any()>& save,
+    const boost::function<void(const boost::any&)>& load) {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  m_cells.push_back(Cell{save, load});
+}
+
+void BehaviorCheckpoint::addUnsavableState(
+    const boost::function<bool()>& isSet) {
+  addState([isSet]() {
+             return isSet() ? boost::any(Unsavable()) : boost::any();
+           },
+           [](const boost::any&) {});
+}
+
+std::size_t BehaviorCheckpoint::size() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_cells.size();
+}
+
+std::string BehaviorCheckpoint::save(
+    const smisc::AnySerializer& serializer) const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  CheckpointData data;
+  data.reserve(m_cells.size());
+  for (const Cell& cell : m_cells) {
+    const boost::any value = cell.save();
+    if (value.empty()) {
+      data.emplace_back();
+      continue;
+    }
+    if (value.type() == typeid(Unsavable)) {
+      data.emplace_back(k_UNSAVABLE_TYPE_ID, std::string());
+      continue;
+    }
+    const smisc::AnySerializer::Entry& entry =
+        serializer.entryFromCppTypeId(smisc::CppTypeId::fromAny(value));
+    assert(entry.opSerializer);
+    data.emplace_back(entry.uniqueTypeId, entry.opSerializer->toString(value));
+  }
+  return sboost::SerializableStringUtil::toString(data);
+}
+
+bool BehaviorCheckpoint::restore(const std::string& checkpoint,
+                                 const smisc::AnySerializer& serializer) const {
+  boost::optional<CheckpointData> data;
+  try {
+    data =
+        sboost::SerializableStringUtil::fromString<CheckpointData>(checkpoint);
+  }
+  catch (const boost::archive::archive_exception&) {
+    // The header of the archive is read before 'fromString' handles errors.
+  }
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  if (!data || data->size() != m_cells.size())
+    return false;
+
+  // All of the values are converted before the first one is loaded so that a
+  // mismatched checkpoint leaves the cells unchanged.
+  std::vector<boost::any> values(m_cells.size());
+  for (std::size_t i = 0; i < m_cells.size(); ++i) {
+    const std::pair<std::string, std::string>& saved = (*data)[i];
+    if (saved.first == k_UNSAVABLE_TYPE_ID)
+      return false;
+    const boost::any current = m_cells[i].save();
+    if (saved.first.empty() || current.empty())
+      continue;
+    if (!serializer.hasUniqueTypeId(saved.first))
+      return false;
+    const smisc::AnySerializer::Entry& entry =
+        serializer.entryFromUniqueTypeId(saved.first);
+    if (!entry.opSerializer ||
+        !(entry.cppTypeId == smisc::CppTypeId::fromAny(current)))
+      return false;
+    values[i] = entry.opSerializer->fromString(saved.second);
+  }
+  for (std::size_t i = 0; i < m_cells.size(); ++i) {
+    if (!values[i].empty())
+      m_cells[i].load(values[i]);
+  }
+  return true;
+}
+
+BehaviorCheckpoint*& BehaviorCheckpoint::currentRegistry() {
+  thread_local BehaviorCheckpoint* registry = 0;
+  return registry;
+}
+
+BehaviorCheckpointScope::BehaviorCheckpointScope(
+    BehaviorCheckpoint& checkpoint)
+    : m_previous(BehaviorCheckpoint::currentRegistry()) {
+  BehaviorCheckpoint::currentRegistry() = &checkpoint;
+}
+
+BehaviorCheckpointScope::~BehaviorCheckpointScope() {
+  BehaviorCheckpoint::currentRegistry() = m_previous;
+}
+}
@@ -0,0 +1,139 @@
+#include <sfrp/behaviorcheckpoint.t.hpp>
+
+#include <boost/make_shared.hpp>
+#include <boost/optional.hpp>
+#include <boost/optional/optional_io.hpp>
+#include <boost/serialization/optional.hpp>
+#include <sfrp/behavior.hpp>
+#include <sfrp/behaviorcheckpoint.hpp>
+#include <sfrp/behaviormap.hpp>
+#include <sfrp/behaviortimeutil.hpp>
+#include <sfrp/joinutil.hpp>
+#include <sfrp/triggerutil.hpp>
+#include <sfrp/wormhole.hpp>
+#include <smisc/anyserializer.hpp>
+#include <smisc/classserializerboostserializableutil.hpp>
+#include <smisc/classserializerlexicalcastutil.hpp>
+#include <stest/testcollector.hpp>
+#include <string>
+
+namespace sfrp {
+namespace {
+// Return a serializer of the cells of the graphs of these tests.
+smisc::AnySerializer makeSerializer() {
+  smisc::AnySerializer serializer;
+  serializer.registerType<bool>(
+      "Bool",
+      smisc::ClassSerializerLexicalCastUtil::classSerializerFromLexicalCasts<
+          bool>());
+  serializer.registerType<boost::optional<int>>(
+      "OptionalInt",
+      smisc::ClassSerializerBoostSerializableUtil::
+          classSerializerFromSerializable<boost::optional<int>>());
+  return serializer;
+}
+
+// Return the running total of the specified 'amounts', which is -1 at the
+// first pull.
+Behavior<int> makeTotal(const Behavior<boost::optional<int>>& amounts) {
+  Wormhole<int> total(0);
+  return BehaviorTimeUtil::replaceInitialValue(
+      total.setInputBehavior(BehaviorMap()(
+          [](const boost::optional<int>& amount, int previous) {
+            return previous + amount.get_value_or(0);
+          },
+          amounts,
+          total.outputBehavior())),
+      -1);
+}
+}
+
+void behaviorcheckpointTests(stest::TestCollector& col) {
+  col.addTest("sfrp_behaviorcheckpoint_restore", []()->void {
+    const smisc::AnySerializer serializer = makeSerializer();
+    const auto amounts = TriggerUtil::triggerInf<int>();
+    BehaviorCheckpoint checkpoint;
+    Behavior<int> total;
+    {
+      BehaviorCheckpointScope scope(checkpoint);
+      total = makeTotal(amounts.first);
+    }
+    BOOST_CHECK_EQUAL(checkpoint.size(), 2u);
+    BOOST_CHECK(!BehaviorCheckpoint::current());
+    for (int i = 1; i <= 3; ++i) {
+      amounts.second(i);
+      total.pull(i);
+    }
+    BOOST_CHECK_EQUAL(total.pull(3.5), boost::make_optional(6));
+    const std::string saved = checkpoint.save(serializer);
+
+    // A fresh graph continues from the total instead of starting over.
+    const auto restoredAmounts = TriggerUtil::triggerInf<int>();
+    BehaviorCheckpoint restored;
+    Behavior<int> restoredTotal;
+    {
+      BehaviorCheckpointScope scope(restored);
+      restoredTotal = makeTotal(restoredAmounts.first);
+    }
+    BOOST_CHECK(restored.restore(saved, serializer));
+    restoredAmounts.second(4);
+    BOOST_CHECK_EQUAL(restoredTotal.pull(4), boost::make_optional(10));
+    amounts.second(4);
+    BOOST_CHECK_EQUAL(total.pull(4), boost::make_optional(10));
+  });
+  col.addTest("sfrp_behaviorcheckpoint_mismatch", []()->void {
+    const smisc::AnySerializer serializer = makeSerializer();
+    BehaviorCheckpoint checkpoint;
+    const boost::shared_ptr<bool> flag = boost::make_shared<bool>(true);
+    checkpoint.addState(flag);
+    const std::string saved = checkpoint.save(serializer);
+
+    BehaviorCheckpoint other;
+    const boost::shared_ptr<bool> otherFlag = boost::make_shared<bool>(false);
+    other.addState(otherFlag);
+    BOOST_CHECK(!other.restore("not a checkpoint", serializer));
+    BOOST_CHECK(!other.restore(saved, smisc::AnySerializer()));
+    BOOST_CHECK(!*otherFlag);
+    BOOST_CHECK(other.restore(saved, serializer));
+    BOOST_CHECK(*otherFlag);
+
+    // Checkpoints of a different number of cells are rejected.
+    other.addState(boost::make_shared<bool>(false));
+    BOOST_CHECK(!other.restore(saved, serializer));
+
+    // Cells of destroyed states are skipped.
+    const std::string withDestroyed = other.save(serializer);
+    *otherFlag = false;
+    BOOST_CHECK(other.restore(withDestroyed, serializer));
+    BOOST_CHECK(*otherFlag);
+  });
+  col.addTest("sfrp_behaviorcheckpoint_join", []()->void {
+    const smisc::AnySerializer serializer = makeSerializer();
+    const auto switches = TriggerUtil::triggerInf<Behavior<int>>();
+    BehaviorCheckpoint checkpoint;
+    Behavior<boost::optional<int>> joined;
+    {
+      BehaviorCheckpointScope scope(checkpoint);
+      joined = JoinUtil::join(switches.first);
+    }
+    BOOST_CHECK_EQUAL(checkpoint.size(), 1u);
+    joined.pull(0.0);
+    const std::string beforeSwitch = checkpoint.save(serializer);
+    switches.second(Behavior<int>::fromConstantValue(3));
+    BOOST_CHECK_EQUAL(joined.pull(1.0),
+                      boost::make_optional(boost::make_optional(3)));
+    const std::string afterSwitch = checkpoint.save(serializer);
+
+    // The behavior switched into is lost, so only the checkpoint saved before
+    // the switch is restored.
+    BehaviorCheckpoint restored;
+    Behavior<boost::optional<int>> restoredJoined;
+    {
+      BehaviorCheckpointScope scope(restored);
+      restoredJoined = JoinUtil::join(switches.first);
+    }
+    BOOST_CHECK(restored.restore(beforeSwitch, serializer));
+    BOOST_CHECK(!restored.restore(afterSwitch, serializer));
+  });
+}
+}
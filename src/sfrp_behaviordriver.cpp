@@ -0,0 +1,142 @@
+#include <sfrp/behaviordriver.hpp>
+
+#include <algorithm>  // std::fill_n
+#include <cmath>      // std::log2, std::floor
+
+namespace sfrp {
+BehaviorDriver_Histogram::BehaviorDriver_Histogram()
+    : m_count(0), m_sum(0.0), m_max(0.0) {
+  std::fill_n(m_buckets, int(k_NUM_BUCKETS), std::uint64_t(0));
+}
+
+void BehaviorDriver_Histogram::add(double seconds) {
+  const double microseconds = seconds * 1e6;
+  std::size_t bucket = 0;
+  if (microseconds >= 1.0) {
+    bucket = std::size_t(std::floor(std::log2(microseconds))) + 1;
+    if (bucket >= k_NUM_BUCKETS)
+      bucket = k_NUM_BUCKETS - 1;
+  }
+  ++m_buckets[bucket];
+  ++m_count;
+  m_sum += seconds;
+  if (seconds > m_max)
+    m_max = seconds;
+}
+
+BehaviorDriver_Stats::BehaviorDriver_Stats()
+    : numTicks(0), numWakeups(0), numOverruns(0), latency(), jitter() {}
+
+BehaviorDriver::BehaviorDriver(Mode mode, double period)
+    : m_mode(mode),
+      m_period(std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(period))),
+      m_mutex(),
+      m_wakeup(),
+      m_woken(false),
+      m_stopped(false),
+      m_stats() {}
+
+void BehaviorDriver::runTicks(const boost::function<bool(double)>& tickFunc) {
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_woken = false;
+    m_stats = BehaviorDriver_Stats();
+  }
+
+  const Clock::time_point start = Clock::now();
+  Clock::time_point deadline = start;
+  bool scheduled = true;
+  bool woken = false;
+  for (;;) {
+    const Clock::time_point tickStart = Clock::now();
+    const bool defined = tickFunc(
+        std::chrono::duration<double>(tickStart - start).count());
+    const Clock::time_point tickEnd = Clock::now();
+
+    const Clock::time_point tickDeadline = deadline;
+    bool overrun = false;
+    if (m_mode == e_FIXED_RATE) {
+      if (scheduled)
+        deadline += m_period;
+      if (tickEnd > deadline) {
+        // Skip the deadlines that were missed.
+        overrun = true;
+        deadline += m_period * ((tickEnd - deadline) / m_period + 1);
+      }
+    } else if (m_mode == e_VARIABLE_RATE) {
+      deadline = tickStart + m_period;
+      if (tickEnd > deadline) {
+        overrun = true;
+        deadline = tickEnd;
+      }
+    }
+
+    {
+      const std::lock_guard<std::mutex> lock(m_mutex);
+      ++m_stats.numTicks;
+      if (woken)
+        ++m_stats.numWakeups;
+      if (overrun)
+        ++m_stats.numOverruns;
+      m_stats.latency.add(
+          std::chrono::duration<double>(tickEnd - tickStart).count());
+      if (scheduled && m_mode != e_AS_FAST_AS_POSSIBLE)
+        m_stats.jitter.add(
+            std::chrono::duration<double>(tickStart - tickDeadline).count());
+    }
+
+    if (!defined)
+      break;
+    if (m_mode == e_AS_FAST_AS_POSSIBLE) {
+      const std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_stopped)
+        break;
+      woken = m_woken;
+      m_woken = false;
+      scheduled = false;
+      continue;
+    }
+    woken = sleepUntil(deadline);
+    scheduled = !woken;
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_stopped)
+      break;
+  }
+
+  // A 'stop()' that comes before the run, even before it started, ends it, so
+  // the flag is only cleared once the run is over.
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  m_stopped = false;
+}
+
+void BehaviorDriver::wake() {
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_woken = true;
+  }
+  m_wakeup.notify_one();
+}
+
+void BehaviorDriver::stop() {
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopped = true;
+  }
+  m_wakeup.notify_one();
+}
+
+BehaviorDriver_Stats BehaviorDriver::stats() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_stats;
+}
+
+bool BehaviorDriver::sleepUntil(Clock::time_point deadline) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_wakeup.wait_until(lock, deadline,
+                      [this]() { return m_woken || m_stopped; });
+  const bool woken = m_woken;
+  m_woken = false;
+  return woken;
+}
+}
@@ -0,0 +1,110 @@
+#include <sfrp/behaviordriver.t.hpp>
+
+#include <boost/optional.hpp>
+#include <sfrp/behavior.hpp>
+#include <sfrp/behaviordriver.hpp>
+#include <sfrp/triggerutil.hpp>
+#include <stest/testcollector.hpp>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace sfrp {
+void behaviordriverTests(stest::TestCollector& col) {
+  col.addTest("sfrp_behaviordriver_histogram", []()->void {
+    BehaviorDriver_Histogram histogram;
+    BOOST_CHECK_EQUAL(histogram.mean(), 0.0);
+    histogram.add(0.5e-6);
+    histogram.add(3e-6);
+    histogram.add(1e9);
+    BOOST_CHECK_EQUAL(histogram.count(), 3u);
+    BOOST_CHECK_EQUAL(histogram.bucketCount(0), 1u);
+    BOOST_CHECK_EQUAL(histogram.bucketCount(2), 1u);
+    BOOST_CHECK_EQUAL(
+        histogram.bucketCount(BehaviorDriver_Histogram::k_NUM_BUCKETS - 1),
+        1u);
+    BOOST_CHECK_EQUAL(histogram.max(), 1e9);
+  });
+  col.addTest("sfrp_behaviordriver_asFastAsPossible", []()->void {
+    int numPulls = 0;
+    const Behavior<int> root =
+        Behavior<int>::fromValuePullFunc([&numPulls](double time) {
+          return ++numPulls <= 100 ? boost::make_optional(numPulls)
+                                   : boost::none;
+        });
+    std::vector<double> times;
+    BehaviorDriver driver(BehaviorDriver::e_AS_FAST_AS_POSSIBLE, 1.0);
+    driver.run(root, [&times](double time, int value) {
+      times.push_back(time);
+    });
+    BOOST_REQUIRE_EQUAL(times.size(), 100u);
+    BOOST_CHECK_GE(times.front(), 0.0);
+    for (std::size_t i = 1; i < times.size(); ++i)
+      BOOST_CHECK_GT(times[i], times[i - 1]);
+
+    const BehaviorDriver_Stats stats = driver.stats();
+    BOOST_CHECK_EQUAL(stats.numTicks, 101u);
+    BOOST_CHECK_EQUAL(stats.latency.count(), 101u);
+    BOOST_CHECK_EQUAL(stats.jitter.count(), 0u);
+    BOOST_CHECK_EQUAL(stats.numOverruns, 0u);
+  });
+  col.addTest("sfrp_behaviordriver_fixedRate", []()->void {
+    const Behavior<double> root =
+        Behavior<double>::fromValuePullFunc([](double time) {
+          return time < 0.02 ? boost::make_optional(time) : boost::none;
+        });
+    BehaviorDriver driver(BehaviorDriver::e_FIXED_RATE, 0.001);
+    driver.run(root);
+
+    // Every tick is scheduled and has a deadline.
+    const BehaviorDriver_Stats stats = driver.stats();
+    BOOST_CHECK_GE(stats.numTicks, 2u);
+    BOOST_CHECK_LE(stats.numTicks, 22u);
+    BOOST_CHECK_EQUAL(stats.numWakeups, 0u);
+    BOOST_CHECK_EQUAL(stats.jitter.count(), stats.numTicks);
+  });
+  col.addTest("sfrp_behaviordriver_wakeup", []()->void {
+    // A driver with a long period is woken by its trigger.
+    BehaviorDriver driver(BehaviorDriver::e_VARIABLE_RATE, 60.0);
+    const auto trigger = TriggerUtil::trigger<int>();
+    const boost::function<void(const boost::optional<int>&)> fire =
+        driver.wakingFunction(trigger.second);
+    std::vector<int> values;
+
+    std::thread producer([&fire]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      fire(boost::make_optional(1));
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      fire(boost::none);
+    });
+    const auto start = std::chrono::steady_clock::now();
+    driver.run(trigger.first,
+               [&values](double time, const boost::optional<int>& occurrence) {
+                 if (occurrence)
+                   values.push_back(*occurrence);
+               });
+    producer.join();
+    BOOST_CHECK(std::chrono::steady_clock::now() - start <
+                std::chrono::seconds(30));
+
+    const BehaviorDriver_Stats stats = driver.stats();
+    BOOST_CHECK_GE(stats.numWakeups, 1u);
+    BOOST_CHECK_EQUAL(stats.numOverruns, 0u);
+    BOOST_CHECK(values == std::vector<int>{1});
+  });
+  col.addTest("sfrp_behaviordriver_stopBeforeRun", []()->void {
+    // A stop that comes before the run ends it after its first tick, and only
+    // that run.
+    const Behavior<int> root = Behavior<int>::fromValuePullFunc(
+        [](double time) { return boost::make_optional(0); });
+    BehaviorDriver driver(BehaviorDriver::e_AS_FAST_AS_POSSIBLE, 1.0);
+    driver.stop();
+    driver.run(root);
+    BOOST_CHECK_EQUAL(driver.stats().numTicks, 1u);
+
+    int numTicks = 0;
+    driver.runTicks([&numTicks](double time) { return ++numTicks < 10; });
+    BOOST_CHECK_EQUAL(numTicks, 10);
+  });
+}
+}
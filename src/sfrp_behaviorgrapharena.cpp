@@ -0,0 +1,127 @@
+#include <sfrp/behaviorgrapharena.hpp>
+
+#include <algorithm>  // std::fill_n
+#include <cstdint>    // std::uintptr_t
+#include <utility>    // std::make_pair
+
+namespace {
+thread_local sfrp::BehaviorGraphArena* currentArena = 0;
+}
+
+namespace sfrp {
+BehaviorGraphArena_Storage::BehaviorGraphArena_Storage(std::size_t blockSize,
+                                                       bool recycling)
+    : m_blockSize(blockSize),
+      m_recycling(recycling),
+      m_blocks(),
+      m_next(0),
+      m_end(0),
+      m_mutex(),
+      m_largeFreeLists() {
+  std::fill_n(m_freeLists, int(k_NUM_SIZE_CLASSES), static_cast<void*>(0));
+}
+
+void* BehaviorGraphArena_Storage::allocate(std::size_t size,
+                                           std::size_t alignment) {
+  if (!m_recycling)
+    return allocateFromBlocks(size, alignment);
+
+  const std::size_t index = sizeClass(size, alignment);
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  if (index == k_NUM_SIZE_CLASSES) {
+    const auto i = m_largeFreeLists.find(std::make_pair(size, alignment));
+    if (i == m_largeFreeLists.end() || i->second.empty())
+      return allocateFromBlocks(size, alignment);
+    void* const p = i->second.back();
+    i->second.pop_back();
+    return p;
+  }
+  if (void* const p = m_freeLists[index]) {
+    m_freeLists[index] = *static_cast<void**>(p);
+    return p;
+  }
+  return allocateFromBlocks((index + 1) * k_SIZE_CLASS, k_SIZE_CLASS);
+}
+
+void BehaviorGraphArena_Storage::deallocate(void* p,
+                                            std::size_t size,
+                                            std::size_t alignment) {
+  if (!m_recycling)
+    return;
+
+  const std::size_t index = sizeClass(size, alignment);
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  if (index == k_NUM_SIZE_CLASSES) {
+    m_largeFreeLists[std::make_pair(size, alignment)].push_back(p);
+    return;
+  }
+
+  // The free lists are linked through the first bytes of the free memory.
+  *static_cast<void**>(p) = m_freeLists[index];
+  m_freeLists[index] = p;
+}
+
+std::size_t BehaviorGraphArena_Storage::sizeClass(std::size_t size,
+                                                  std::size_t alignment) const {
+  if (size == 0 || alignment > k_SIZE_CLASS ||
+      size > k_SIZE_CLASS * k_NUM_SIZE_CLASSES)
+    return k_NUM_SIZE_CLASSES;
+  return (size - 1) / k_SIZE_CLASS;
+}
+
+void* BehaviorGraphArena_Storage::allocateFromBlocks(std::size_t size,
+                                                     std::size_t alignment) {
+  const std::uintptr_t next = reinterpret_cast<std::uintptr_t>(m_next);
+  const std::uintptr_t aligned = (next + alignment - 1) & ~(alignment - 1);
+  if (m_next && aligned + size <= reinterpret_cast<std::uintptr_t>(m_end)) {
+    m_next = reinterpret_cast<char*>(aligned + size);
+    return reinterpret_cast<void*>(aligned);
+  }
+
+  // Allocations that don't fit in a fresh block get a block of their own so
+  // that the current block can continue to be filled.
+  const std::size_t blockSize = size + alignment - 1;
+  if (blockSize > m_blockSize) {
+    m_blocks.emplace_back(new char[blockSize]);
+    const std::uintptr_t begin =
+        reinterpret_cast<std::uintptr_t>(m_blocks.back().get());
+    return reinterpret_cast<void*>((begin + alignment - 1) & ~(alignment - 1));
+  }
+
+  m_blocks.emplace_back(new char[m_blockSize]);
+  m_next = m_blocks.back().get();
+  m_end = m_next + m_blockSize;
+  return allocateFromBlocks(size, alignment);
+}
+
+BehaviorGraphArena::BehaviorGraphArena(std::size_t blockSize,
+                                       Recycling recycling)
+    : m_storage(boost::make_shared<BehaviorGraphArena_Storage>(
+          blockSize,
+          recycling == e_RECYCLING)) {}
+
+void* BehaviorGraphArena::allocate(std::size_t size, std::size_t alignment) {
+  return m_storage->allocate(size, alignment);
+}
+
+void BehaviorGraphArena::deallocate(void* p,
+                                    std::size_t size,
+                                    std::size_t alignment) {
+  m_storage->deallocate(p, size, alignment);
+}
+
+std::size_t BehaviorGraphArena::numBlocks() const {
+  return m_storage->m_blocks.size();
+}
+
+BehaviorGraphArena* BehaviorGraphArena::current() { return currentArena; }
+
+BehaviorGraphArenaScope::BehaviorGraphArenaScope(BehaviorGraphArena& arena)
+    : m_previous(currentArena) {
+  currentArena = &arena;
+}
+
+BehaviorGraphArenaScope::~BehaviorGraphArenaScope() {
+  currentArena = m_previous;
+}
+}
@@ -0,0 +1,133 @@
+#include <sfrp/behaviorgrapharena.t.hpp>
+
+#include <boost/optional/optional_io.hpp>
+#include <sfrp/behaviorgrapharena.hpp>
+#include <sfrp/behaviorutil.hpp>
+#include <sfrp/joinutil.hpp>
+#include <sfrp/wormhole.hpp>
+#include <stest/testcollector.hpp>
+#include <cstdint>  // std::uintptr_t
+
+namespace {
+sfrp::Behavior<double> buildSubGraph(double offset) {
+  sfrp::BehaviorGraphArena arena;
+  sfrp::BehaviorGraphArenaScope scope(arena);
+  return sfrp::BehaviorUtil::map([offset](double t) { return t + offset; },
+                                 sfrp::BehaviorUtil::time());
+}
+}
+
+namespace sfrp {
+void behaviorgrapharenaTests(stest::TestCollector& col) {
+  col.addTest("sfrp_behaviorgrapharena_allocate", []()->void {
+    sfrp::BehaviorGraphArena arena(64);
+    BOOST_CHECK_EQUAL(arena.numBlocks(), 0u);
+    char* const a = static_cast<char*>(arena.allocate(1, 1));
+    char* const b = static_cast<char*>(arena.allocate(8, 8));
+    BOOST_CHECK_EQUAL(arena.numBlocks(), 1u);
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(b) % 8, 0u);
+    BOOST_CHECK(b > a && b < a + 64);
+
+    // Oversized allocations get their own block and don't disturb the
+    // current one.
+    arena.allocate(1000, 8);
+    BOOST_CHECK_EQUAL(arena.numBlocks(), 2u);
+    char* const c = static_cast<char*>(arena.allocate(8, 8));
+    BOOST_CHECK(c == b + 8);
+  });
+  col.addTest("sfrp_behaviorgrapharena_scope", []()->void {
+    BOOST_CHECK(!sfrp::BehaviorGraphArena::current());
+    sfrp::BehaviorGraphArena outer;
+    {
+      sfrp::BehaviorGraphArenaScope outerScope(outer);
+      BOOST_CHECK_EQUAL(sfrp::BehaviorGraphArena::current(), &outer);
+      sfrp::BehaviorGraphArena inner;
+      {
+        sfrp::BehaviorGraphArenaScope innerScope(inner);
+        BOOST_CHECK_EQUAL(sfrp::BehaviorGraphArena::current(), &inner);
+      }
+      BOOST_CHECK_EQUAL(sfrp::BehaviorGraphArena::current(), &outer);
+    }
+    BOOST_CHECK(!sfrp::BehaviorGraphArena::current());
+  });
+  col.addTest("sfrp_behaviorgrapharena_nodes", []()->void {
+    // Check that nodes are placed in the current arena and remain valid after
+    // the arena object is destroyed.
+    sfrp::BehaviorGraphArena arena;
+    {
+      sfrp::BehaviorGraphArenaScope scope(arena);
+      sfrp::Wormhole<int> w(3);
+      sfrp::BehaviorUtil::always(4);
+    }
+    BOOST_CHECK(arena.numBlocks() > 0u);
+
+    sfrp::Behavior<double> b = buildSubGraph(1.0);
+    BOOST_CHECK_EQUAL(b.pull(0.0), boost::make_optional(1.0));
+    BOOST_CHECK_EQUAL(b.pull(2.0), boost::make_optional(3.0));
+  });
+  col.addTest("sfrp_behaviorgrapharena_recycling", []()->void {
+    sfrp::BehaviorGraphArena arena(4096,
+                                   sfrp::BehaviorGraphArena::e_RECYCLING);
+    void* const a = arena.allocate(20, 8);
+    arena.deallocate(a, 20, 8);
+    BOOST_CHECK_EQUAL(arena.allocate(32, 16), a);
+    BOOST_CHECK(arena.allocate(20, 8) != a);
+
+    // Large and over-aligned allocations are reused for the same size and
+    // alignment.
+    void* const large = arena.allocate(10000, 8);
+    arena.deallocate(large, 10000, 8);
+    BOOST_CHECK(arena.allocate(9000, 8) != large);
+    BOOST_CHECK_EQUAL(arena.allocate(10000, 8), large);
+    arena.deallocate(large, 10000, 8);
+    void* const aligned = arena.allocate(64, 64);
+    arena.deallocate(aligned, 64, 64);
+    BOOST_CHECK_EQUAL(arena.allocate(64, 64), aligned);
+    const std::size_t numBlocks = arena.numBlocks();
+    for (int i = 0; i < 10; ++i)
+      arena.deallocate(arena.allocate(10000, 8), 10000, 8);
+    BOOST_CHECK_EQUAL(arena.numBlocks(), numBlocks);
+
+    // Nodes of rebuilt sub-graphs reuse the memory of destroyed ones.
+    {
+      sfrp::BehaviorGraphArenaScope scope(arena);
+      for (int i = 0; i < 100; ++i) {
+        sfrp::Behavior<double> b = sfrp::BehaviorUtil::map(
+            [i](double t) { return t + i; }, sfrp::BehaviorUtil::time());
+        BOOST_CHECK_EQUAL(b.pull(1.0), boost::make_optional(1.0 + i));
+      }
+    }
+    BOOST_CHECK_EQUAL(arena.numBlocks(), numBlocks);
+
+    // Monotonic arenas ignore deallocations.
+    sfrp::BehaviorGraphArena monotonic;
+    void* const c = monotonic.allocate(20, 8);
+    monotonic.deallocate(c, 20, 8);
+    BOOST_CHECK(monotonic.allocate(20, 8) != c);
+  });
+  col.addTest("sfrp_behaviorgrapharena_join", []()->void {
+    // A join switching into a new behavior at every other pull.
+    int numPulls = 0;
+    const sfrp::Behavior<boost::optional<sfrp::Behavior<double>>> switches =
+        sfrp::Behavior<boost::optional<sfrp::Behavior<double>>>::
+            fromValuePullFunc([&numPulls](double time) {
+              typedef boost::optional<sfrp::Behavior<double>> Occurrence;
+              if (numPulls++ % 2 != 0)
+                return boost::make_optional(Occurrence());
+              const double offset = time * 100.0;
+              return boost::make_optional(Occurrence(sfrp::BehaviorUtil::map(
+                  [offset](double t) { return t + offset; },
+                  sfrp::BehaviorUtil::time())));
+            });
+    const sfrp::Behavior<boost::optional<double>> joined =
+        sfrp::JoinUtil::join(switches);
+    for (int i = 0; i < 100; ++i) {
+      const double switchTime = i - i % 2;
+      BOOST_CHECK_EQUAL(
+          joined.pull(i),
+          boost::make_optional(boost::make_optional(switchTime * 100.0 +
+                                                    (i - switchTime))));
+    }
+  });
+}
+}
@@ -0,0 +1,77 @@
+#include <sfrp/behaviorhashcons.hpp>
+
+#include <boost/functional/hash.hpp>
+
+namespace sfrp {
+BehaviorHashCons_Key::BehaviorHashCons_Key()
+    : functionType(0),
+      functionPointer(0),
+      argumentNodes(),
+      distinct(false),
+      pool(0) {}
+
+bool BehaviorHashCons_Key::operator==(const BehaviorHashCons_Key& other) const {
+  return (functionType == other.functionType ||
+          (functionType && other.functionType &&
+           *functionType == *other.functionType)) &&
+         functionPointer == other.functionPointer &&
+         argumentNodes == other.argumentNodes && distinct == other.distinct &&
+         pool == other.pool;
+}
+
+std::size_t BehaviorHashCons_KeyHash::operator()(
+    const BehaviorHashCons_Key& key) const {
+  std::size_t seed = key.functionType ? key.functionType->hash_code() : 0;
+  boost::hash_combine(seed, reinterpret_cast<std::size_t>(key.functionPointer));
+  for (const BehaviorNode* const node : key.argumentNodes)
+    boost::hash_combine(seed, node);
+  boost::hash_combine(seed, key.distinct);
+  boost::hash_combine(seed, key.pool);
+  return seed;
+}
+
+BehaviorHashCons::BehaviorHashCons() : m_mutex(), m_nodes() {}
+
+boost::shared_ptr<BehaviorNode> BehaviorHashCons::find(
+    const BehaviorHashCons_Key& key) const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  const auto i = m_nodes.find(key);
+  return i != m_nodes.end() ? i->second.lock()
+                            : boost::shared_ptr<BehaviorNode>();
+}
+
+void BehaviorHashCons::insert(const BehaviorHashCons_Key& key,
+                              const boost::shared_ptr<BehaviorNode>& node) {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  m_nodes[key] = node;
+}
+
+void BehaviorHashCons::purge() {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto i = m_nodes.begin(); i != m_nodes.end();) {
+    if (i->second.expired())
+      i = m_nodes.erase(i);
+    else
+      ++i;
+  }
+}
+
+std::size_t BehaviorHashCons::size() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_nodes.size();
+}
+
+BehaviorHashCons*& BehaviorHashCons::currentTable() {
+  thread_local BehaviorHashCons* table = 0;
+  return table;
+}
+
+BehaviorHashConsScope::BehaviorHashConsScope(BehaviorHashCons& table)
+    : m_previous(BehaviorHashCons::currentTable()) {
+  BehaviorHashCons::currentTable() = &table;
+}
+
+BehaviorHashConsScope::~BehaviorHashConsScope() {
+  BehaviorHashCons::currentTable() = m_previous;
+}
+}
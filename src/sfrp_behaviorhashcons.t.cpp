@@ -0,0 +1,101 @@
+#include <sfrp/behaviorhashcons.t.hpp>
+
+#include <sfrp/behavior.hpp>
+#include <sfrp/behaviorhashcons.hpp>
+#include <sfrp/behaviormap.hpp>
+#include <sfrp/behavioroperators.hpp>
+#include <sfrp/behaviorutil.hpp>
+#include <sfrp/pullthreadpool.hpp>
+#include <stest/testcollector.hpp>
+#include <memory>  // std::make_shared
+
+namespace {
+int doubleInt(int i) { return i * 2; }
+int tripleInt(int i) { return i * 3; }
+}
+
+namespace sfrp {
+void behaviorhashconsTests(stest::TestCollector& col) {
+  col.addTest("sfrp_behaviorhashcons_sharing", []()->void {
+    auto numCalls = std::make_shared<int>(0);
+    const Behavior<int> source =
+        Behavior<int>::fromValuePullFunc([numCalls](double time) {
+          ++*numCalls;
+          return boost::make_optional(static_cast<int>(time));
+        });
+    const Behavior<int> other = BehaviorUtil::always(1);
+    const auto add = [](int a, int b) { return a + b; };
+
+    // Without a scope nothing is shared.
+    BOOST_CHECK(BehaviorMap()(add, source, other).node() !=
+                BehaviorMap()(add, source, other).node());
+
+    BehaviorHashCons table;
+    const BehaviorHashConsScope scope(table);
+    BOOST_CHECK_EQUAL(BehaviorHashCons::current(), &table);
+
+    const Behavior<int> sum1 = BehaviorMap()(add, source, other);
+    const Behavior<int> sum2 = BehaviorMap()(add, source, other);
+    BOOST_CHECK(sum1.node() == sum2.node());
+    BOOST_CHECK(BehaviorMap()(add, other, source).node() != sum1.node());
+
+    // Function pointers are identified by address and operators are shared.
+    BOOST_CHECK(BehaviorMap()(&doubleInt, source).node() ==
+                BehaviorMap()(&doubleInt, source).node());
+    BOOST_CHECK(BehaviorMap()(&doubleInt, source).node() !=
+                BehaviorMap()(&tripleInt, source).node());
+    BOOST_CHECK((source + other).node() == (source + other).node());
+
+    // Functions with state are never shared.
+    const int offset = 1;
+    const auto addOffset = [offset](int a) { return a + offset; };
+    BOOST_CHECK(BehaviorMap()(addOffset, source).node() !=
+                BehaviorMap()(addOffset, source).node());
+
+    // Mappings by differently configured maps aren't shared, so that shared
+    // nodes are never reconfigured.
+    const Behavior<int> distinctSum =
+        BehaviorMap().distinct()(add, source, other);
+    BOOST_CHECK(distinctSum.node() != sum1.node());
+    BOOST_CHECK(!sum1.node()->reportsChanges());
+    BOOST_CHECK(distinctSum.node()->reportsChanges());
+    BOOST_CHECK(BehaviorMap().distinct()(add, source, other).node() ==
+                distinctSum.node());
+    PullThreadPool pool(1);
+    const Behavior<int> pooledSum = BehaviorMap(pool)(add, source, other);
+    BOOST_CHECK(pooledSum.node() != sum1.node());
+    BOOST_CHECK(BehaviorMap(pool)(add, source, other).node() ==
+                pooledSum.node());
+
+    // The shared node is evaluated once per time.
+    const Behavior<int> total = BehaviorMap()(add, sum1, sum2);
+    for (int i = 0; i < 10; ++i)
+      BOOST_CHECK_EQUAL(*total.pull(i), 2 * (i + 1));
+    BOOST_CHECK_EQUAL(*numCalls, 10);
+  });
+  col.addTest("sfrp_behaviorhashcons_lifetime", []()->void {
+    BehaviorHashCons table;
+    const BehaviorHashConsScope scope(table);
+    const Behavior<int> source = Behavior<int>::fromValuePullFunc(
+        [](double time) { return boost::make_optional(3); });
+    {
+      const BehaviorHashConsScope innerScope(table);
+      const Behavior<int> doubled = BehaviorMap()(&doubleInt, source);
+      BOOST_CHECK_EQUAL(table.size(), 1u);
+    }
+    BOOST_CHECK_EQUAL(BehaviorHashCons::current(), &table);
+
+    // The table doesn't keep its nodes alive.
+    const Behavior<int> doubled = BehaviorMap()(&doubleInt, source);
+    BOOST_CHECK_EQUAL(*doubled.pull(0.0), 6);
+    BOOST_CHECK_EQUAL(table.size(), 1u);
+    table.purge();
+    BOOST_CHECK_EQUAL(table.size(), 1u);
+
+    BehaviorMap()(&tripleInt, source);
+    BOOST_CHECK_EQUAL(table.size(), 2u);
+    table.purge();
+    BOOST_CHECK_EQUAL(table.size(), 1u);
+  });
+}
+}
@@ -1 +1,14 @@
 #include <sfrp/behaviormap.hpp>
+
+namespace sfrp {
+BehaviorMap::BehaviorMap() : m_pool(0), m_distinct(false) {}
+
+BehaviorMap::BehaviorMap(PullThreadPool& pool)
+    : m_pool(&pool), m_distinct(false) {}
+
+BehaviorMap_Distinct BehaviorMap::distinct() const {
+  BehaviorMap result = *this;
+  result.m_distinct = true;
+  return BehaviorMap_Distinct(result);
+}
+}
@@ -3,9 +3,31 @@
 #include <sfrp/behavior.hpp>
 #include <sfrp/behaviormap.hpp>
 #include <sfrp/behaviorutil.hpp>
+#include <sfrp/pullthreadpool.hpp>
+#include <sfrp/triggerutil.hpp>
 #include <stest/testcollector.hpp>
+#include <atomic>
+#include <cstdint>  // std::uint64_t
+#include <memory>  // std::make_shared
 
 namespace {
+// This class counts the number of times its objects are copied in
+// 'numCopies'.
+struct CopyCounter {
+  CopyCounter() {}
+  CopyCounter(const CopyCounter&) { ++numCopies; }
+  CopyCounter(CopyCounter&&) {}
+  CopyCounter& operator=(const CopyCounter&) {
+    ++numCopies;
+    return *this;
+  }
+  CopyCounter& operator=(CopyCounter&&) { return *this; }
+
+  static int numCopies;
+};
+
+int CopyCounter::numCopies = 0;
+
 sfrp::Behavior<int> addBehaviors(sfrp::Behavior<int> lhs,
                                  sfrp::Behavior<int> rhs) {
   return sfrp::BehaviorMap()([](int a, int b) { return a + b; }, lhs, rhs);
@@ -39,5 +61,170 @@ void behaviormapTests(stest::TestCollector& col) {
     BOOST_CHECK_EQUAL(*mappedBehavior3.pull(0.0), "3foo");
     BOOST_CHECK_EQUAL(*mappedBehavior3.pull(2.0), "3foo");
   });
+  col.addTest("sfrp_behaviormap_parallel", []()->void {
+    PullThreadPool pool(2);
+
+    // 'shared' is an argument of both of the inner mappings and should still
+    // be evaluated once per time.
+    auto numCalls = std::make_shared<std::atomic<int>>(0);
+    const Behavior<int> shared =
+        Behavior<int>::fromValuePullFunc([numCalls](double time) {
+          ++*numCalls;
+          return boost::make_optional(static_cast<int>(time));
+        });
+    const Behavior<int> lhs =
+        BehaviorMap(pool)([](int a, int b) { return a + b; }, shared,
+                          BehaviorUtil::always(1));
+    const Behavior<int> rhs =
+        BehaviorMap(pool)([](int a) { return a * 10; }, shared);
+    const Behavior<int> sum =
+        BehaviorMap(pool)([](int a, int b) { return a + b; }, lhs, rhs);
+
+    for (int i = 0; i < 100; ++i)
+      BOOST_CHECK_EQUAL(*sum.pull(i), i + 1 + i * 10);
+    BOOST_CHECK_EQUAL(numCalls->load(), 100);
+
+    // The result is undefined when any of the arguments is undefined.
+    const Behavior<int> curtailed = BehaviorMap(pool)(
+        [](int a, int b) { return a + b; }, shared,
+        Behavior<int>::fromValuePullFunc([](double time) {
+          return time < 150.0 ? boost::make_optional(1) : boost::none;
+        }));
+    BOOST_CHECK_EQUAL(*curtailed.pull(100.0), 101);
+    BOOST_CHECK(!curtailed.pull(150.0));
+  });
+  col.addTest("sfrp_behaviormap_constant", []()->void {
+    // A mapping over constant arguments is applied once.
+    auto numCalls = std::make_shared<int>(0);
+    const Behavior<int> sum =
+        BehaviorMap()([numCalls](int a, int b) {
+                        ++*numCalls;
+                        return a + b;
+                      },
+                      BehaviorUtil::always(1), BehaviorUtil::always(2));
+    BOOST_CHECK(sum.isConstant());
+    BOOST_CHECK_EQUAL(*numCalls, 1);
+    for (int i = 0; i < 10; ++i)
+      BOOST_CHECK_EQUAL(*sum.pull(i), 3);
+    BOOST_CHECK_EQUAL(*numCalls, 1);
+
+    // A mapping over an undefined behavior is undefined.
+    BOOST_CHECK(!BehaviorMap()([](int a) { return a; }, Behavior<int>())
+                     .node());
+    BOOST_CHECK(!BehaviorMap()([](int a, double b) { return a + b; },
+                               BehaviorUtil::always(1),
+                               BehaviorUtil::time()).isConstant());
+
+    // A mapping without arguments is applied at every pull.
+    auto counter = std::make_shared<int>(0);
+    const Behavior<int> count = BehaviorMap()([counter]() {
+      return ++*counter;
+    });
+    BOOST_CHECK(!count.isConstant());
+    BOOST_CHECK(!count.isPure());
+    BOOST_CHECK_EQUAL(*counter, 0);
+    BOOST_CHECK_EQUAL(*count.pull(0.0), 1);
+    BOOST_CHECK_EQUAL(*count.pull(1.0), 2);
+  });
+  col.addTest("sfrp_behaviormap_stepped", []()->void {
+    // Mappings over stepped arguments are applied once per change.
+    auto numCalls = std::make_shared<int>(0);
+    const auto setting = TriggerUtil::triggerInfStep(1);
+    const Behavior<int> doubled = BehaviorMap()([numCalls](int a, int b) {
+      ++*numCalls;
+      return (a + b) * 2;
+    }, setting.first, BehaviorUtil::always(1));
+    const Behavior<int> chained =
+        BehaviorMap()([](int a) { return a + 1; }, doubled);
+    BOOST_CHECK(chained.node()->reportsChanges());
+
+    for (int i = 0; i < 10; ++i)
+      BOOST_CHECK_EQUAL(*chained.pull(i), 5);
+    BOOST_CHECK_EQUAL(*numCalls, 1);
+    setting.second(2);
+    for (int i = 10; i < 20; ++i)
+      BOOST_CHECK_EQUAL(*chained.pull(i), 7);
+    BOOST_CHECK_EQUAL(*numCalls, 2);
+
+    // A mapping with an argument that doesn't report its changes is applied at
+    // every pull.
+    const Behavior<double> timed =
+        BehaviorMap()([numCalls](int a, double time) {
+          ++*numCalls;
+          return a + time;
+        }, setting.first, BehaviorUtil::time());
+    BOOST_CHECK(!timed.node()->reportsChanges());
+    for (int i = 20; i < 30; ++i)
+      BOOST_CHECK_EQUAL(*timed.pull(i), 2.0 + i);
+    BOOST_CHECK_EQUAL(*numCalls, 12);
+  });
+  col.addTest("sfrp_behaviormap_noArgumentCopies", []()->void {
+    CopyCounter::numCopies = 0;
+    const Behavior<CopyCounter> source =
+        Behavior<CopyCounter>::fromValuePullFunc([](double time) {
+          return boost::make_optional(CopyCounter());
+        });
+
+    // Consumers taking their argument by 'const' reference read the cached
+    // value of 'source' in place.
+    PullThreadPool pool(2);
+    const auto count = [](const CopyCounter& c) { return 1; };
+    const Behavior<int> sum = BehaviorMap()(
+        [](int a, int b, int c) { return a + b + c; },
+        BehaviorMap()(count, source), BehaviorMap()(count, source),
+        BehaviorMap(pool)(count, source));
+
+    for (int i = 0; i < 10; ++i)
+      BOOST_CHECK_EQUAL(*sum.pull(i), 3);
+    BOOST_CHECK_EQUAL(CopyCounter::numCopies, 0);
+
+    // 'pull()' returns a copy.
+    source.pull(10.0);
+    BOOST_CHECK_EQUAL(CopyCounter::numCopies, 1);
+  });
+  col.addTest("sfrp_behaviormap_release", []()->void {
+    // A mapping with a reuse hint releases its arguments once it ends.
+    const auto token = std::make_shared<int>(0);
+    const Behavior<int> mapped = BehaviorMap()(
+        [](int a, int b) { return a + b; },
+        BehaviorUtil::distinct(Behavior<int>::fromValuePullFunc(
+            [](double time) {
+              return time < 1.0 ? boost::make_optional(0) : boost::none;
+            })),
+        BehaviorUtil::distinct(
+            Behavior<int>::fromValuePullFunc([token](double time) {
+              return boost::make_optional(*token);
+            })));
+    BOOST_CHECK(mapped.node()->reportsChanges());
+    BOOST_CHECK(mapped.pull(0.0));
+    BOOST_CHECK(token.use_count() > 1);
+    BOOST_CHECK(!mapped.pull(1.0));
+    BOOST_CHECK_EQUAL(token.use_count(), 1);
+  });
+  col.addTest("sfrp_behaviormap_distinct", []()->void {
+    // Dependents of a distinct mapping are applied once per distinct value.
+    auto numCalls = std::make_shared<int>(0);
+    const Behavior<int> sign = BehaviorMap().distinct()(
+        [](double time) { return time < 5.0 ? -1 : 1; },
+        BehaviorUtil::time());
+    BOOST_CHECK(sign.node()->reportsChanges());
+    const Behavior<int> negated = BehaviorMap()([numCalls](int s) {
+      ++*numCalls;
+      return -s;
+    }, sign);
+    BOOST_CHECK(negated.node()->reportsChanges());
+
+    sign.pull(0.0);
+    const std::uint64_t version = sign.valueVersion();
+    for (int i = 0; i < 10; ++i)
+      BOOST_CHECK_EQUAL(*negated.pull(i), i < 5 ? 1 : -1);
+    BOOST_CHECK_EQUAL(*numCalls, 2);
+    BOOST_CHECK(sign.valueVersion() != version);
+
+    // Mappings that aren't distinct change at every pull.
+    const Behavior<int> plain = BehaviorMap()(
+        [](double time) { return 0; }, BehaviorUtil::time());
+    BOOST_CHECK(!plain.node()->reportsChanges());
+  });
 }
 }
@@ -0,0 +1,175 @@
+#include <sfrp/behaviornode.hpp>
+
+#include <algorithm>  // std::find, std::replace
+
+namespace sfrp {
+BehaviorNode_Extension::BehaviorNode_Extension()
+    : m_mutex(),
+      m_incrementalCount(0),
+      m_changedFunc(),
+      m_changeHintFunc(),
+      m_reuseHintFunc() {}
+
+std::atomic<unsigned> BehaviorNode::s_numConcurrencyScopes(0);
+
+BehaviorNode::BehaviorNode()
+    : m_extension(0),
+      m_children(),
+#ifdef SFRP_SINGLE_THREADED
+      m_childNodes(),
+#endif
+      m_dependents(),
+      m_valueVersion(0),
+      m_changeMode(e_VOLATILE),
+      m_dirty(true),
+      m_comparesValues(false) {
+#ifdef SFRP_PROFILE
+  m_profileRecord = BehaviorProfiler::createRecord();
+#endif
+}
+
+BehaviorNode::~BehaviorNode() {
+#ifdef SFRP_SINGLE_THREADED
+  for (BehaviorNode* const dependent : m_dependents)
+    std::replace(dependent->m_childNodes.begin(),
+                 dependent->m_childNodes.end(),
+                 this,
+                 static_cast<BehaviorNode*>(0));
+  for (BehaviorNode* const child : m_childNodes) {
+    if (child) {
+      std::vector<BehaviorNode*>& dependents = child->m_dependents;
+      const auto i = std::find(dependents.begin(), dependents.end(), this);
+      if (i != dependents.end())
+        dependents.erase(i);
+    }
+  }
+#else
+  for (const boost::weak_ptr<BehaviorNode>& weakChild : m_children) {
+    if (const boost::shared_ptr<BehaviorNode> child = weakChild.lock()) {
+      std::vector<BehaviorNode*>& dependents = child->m_dependents;
+      const auto i = std::find(dependents.begin(), dependents.end(), this);
+      if (i != dependents.end())
+        dependents.erase(i);
+    }
+  }
+#endif
+  delete findExtension();
+}
+
+void BehaviorNode::setConstant() { m_changeMode = e_CONSTANT; }
+
+void BehaviorNode::setDerived(
+    const std::vector<boost::shared_ptr<BehaviorNode>>& children) {
+  m_changeMode = e_DERIVED;
+  for (const boost::shared_ptr<BehaviorNode>& child : children) {
+    if (child) {
+      m_children.push_back(child);
+#ifdef SFRP_SINGLE_THREADED
+      m_childNodes.push_back(child.get());
+#endif
+      child->m_dependents.push_back(this);
+    }
+  }
+}
+
+void BehaviorNode::setPolled(boost::function<bool()> changedFunc) {
+  m_changeMode = e_POLLED;
+  extension().m_changedFunc = std::move(changedFunc);
+}
+
+void BehaviorNode::setChangeHint(boost::function<bool()> changedFunc) {
+  extension().m_changeHintFunc = std::move(changedFunc);
+}
+
+void BehaviorNode::setReuseHint(boost::function<bool(double)> reuseFunc) {
+  extension().m_reuseHintFunc = std::move(reuseFunc);
+}
+
+void BehaviorNode::releaseHints() {
+  if (BehaviorNode_Extension* const extension = findExtension()) {
+    extension->m_changeHintFunc.clear();
+    extension->m_reuseHintFunc.clear();
+  }
+}
+
+bool BehaviorNode::pollChanged() { return findExtension()->m_changedFunc(); }
+
+bool BehaviorNode::pullAt(double) { return false; }
+
+void BehaviorNode::markDirty() {
+  // A dirty node's dependents are already dirty so the walk stops there.
+  if (isDirty())
+    return;
+  m_dirty.store(true, std::memory_order_relaxed);
+  for (BehaviorNode* dependent : m_dependents)
+    dependent->markDirty();
+}
+
+void BehaviorNode::markClean() {
+  // Only constant and incremental nodes reuse their values. Other nodes stay
+  // dirty, which is always safe.
+  if (m_changeMode != e_CONSTANT && !isIncremental())
+    return;
+
+  // A child may have been marked dirty after it was pulled at the current
+  // time. This node must then stay dirty so that 'markDirty()' may stop at
+  // dirty nodes.
+#ifdef SFRP_SINGLE_THREADED
+  for (const BehaviorNode* const child : m_childNodes) {
+    if (child && child->isDirty())
+      return;
+  }
+#else
+  for (const boost::weak_ptr<BehaviorNode>& weakChild : m_children) {
+    const boost::shared_ptr<BehaviorNode> child = weakChild.lock();
+    if (child && child->isDirty())
+      return;
+  }
+#endif
+  m_dirty.store(false, std::memory_order_relaxed);
+}
+
+void BehaviorNode::beginIncremental() { ++extension().m_incrementalCount; }
+
+void BehaviorNode::endIncremental() { --findExtension()->m_incrementalCount; }
+
+BehaviorNode_Extension& BehaviorNode::extension() {
+  BehaviorNode_Extension* extension = findExtension();
+  if (!extension) {
+    BehaviorNode_Extension* const created = new BehaviorNode_Extension();
+    if (m_extension.compare_exchange_strong(extension, created))
+      extension = created;
+    else
+      delete created;
+  }
+  return *extension;
+}
+
+unsigned& BehaviorNode::concurrencyDepth() {
+  thread_local unsigned depth = 0;
+  return depth;
+}
+
+BehaviorNodeConcurrencyScope::BehaviorNodeConcurrencyScope() {
+  ++BehaviorNode::s_numConcurrencyScopes;
+  ++BehaviorNode::concurrencyDepth();
+}
+
+BehaviorNodeConcurrencyScope::~BehaviorNodeConcurrencyScope() {
+  --BehaviorNode::concurrencyDepth();
+  --BehaviorNode::s_numConcurrencyScopes;
+}
+
+bool BehaviorNodeConcurrencyScope::isActive() {
+  return BehaviorNode::concurrencyDepth() > 0;
+}
+
+BehaviorNodeExclusiveScope::BehaviorNodeExclusiveScope()
+    : m_suspendedDepth(BehaviorNode::concurrencyDepth()) {
+  BehaviorNode::concurrencyDepth() = 0;
+}
+
+BehaviorNodeExclusiveScope::~BehaviorNodeExclusiveScope() {
+  BehaviorNode::concurrencyDepth() = m_suspendedDepth;
+}
+}
@@ -0,0 +1,105 @@
+#include <sfrp/behaviornode.t.hpp>
+
+#include <boost/make_shared.hpp>
+#include <sfrp/behaviornode.hpp>
+#include <stest/testcollector.hpp>
+#include <vector>
+
+namespace {
+// This class exposes the protected interface of 'BehaviorNode' for testing.
+struct TestNode : sfrp::BehaviorNode {
+  using sfrp::BehaviorNode::canReuse;
+  using sfrp::BehaviorNode::markClean;
+};
+}
+
+namespace sfrp {
+void behaviornodeTests(stest::TestCollector& col) {
+  col.addTest("sfrp_behaviornode_markDirty", []()->void {
+    const boost::shared_ptr<TestNode> source = boost::make_shared<TestNode>();
+    const boost::shared_ptr<TestNode> derived = boost::make_shared<TestNode>();
+    derived->setDerived({source});
+    BOOST_CHECK(derived->changeMode() == sfrp::BehaviorNode::e_DERIVED);
+    BOOST_CHECK_EQUAL(derived->children().size(), 1u);
+
+    // Nodes that are neither constant nor incremental stay dirty.
+    source->markClean();
+    BOOST_CHECK(source->isDirty());
+    source->beginIncremental();
+    derived->beginIncremental();
+
+    source->markClean();
+    derived->markClean();
+    BOOST_CHECK(!derived->isDirty());
+    source->markDirty();
+    BOOST_CHECK(source->isDirty());
+    BOOST_CHECK(derived->isDirty());
+
+    // A node whose child is dirty stays dirty.
+    derived->markClean();
+    BOOST_CHECK(derived->isDirty());
+  });
+  col.addTest("sfrp_behaviornode_canReuse", []()->void {
+    const boost::shared_ptr<TestNode> constant = boost::make_shared<TestNode>();
+    constant->setConstant();
+    BOOST_CHECK(!constant->canReuse());
+    constant->markClean();
+    BOOST_CHECK(constant->canReuse());
+
+    const boost::shared_ptr<TestNode> derived = boost::make_shared<TestNode>();
+    derived->setDerived({constant});
+    derived->markClean();
+    BOOST_CHECK(!derived->canReuse());
+    derived->beginIncremental();
+    derived->markClean();
+    BOOST_CHECK(derived->canReuse());
+    derived->endIncremental();
+    BOOST_CHECK(!derived->canReuse());
+
+    const boost::shared_ptr<TestNode> volatileNode =
+        boost::make_shared<TestNode>();
+    volatileNode->beginIncremental();
+    volatileNode->markClean();
+    BOOST_CHECK(!volatileNode->canReuse());
+  });
+  col.addTest("sfrp_behaviornode_destruction", []()->void {
+    // Check that destroyed dependents are no longer marked dirty.
+    const boost::shared_ptr<TestNode> source = boost::make_shared<TestNode>();
+    source->beginIncremental();
+    source->markClean();
+    {
+      const boost::shared_ptr<TestNode> derived =
+          boost::make_shared<TestNode>();
+      derived->setDerived({source});
+    }
+    source->markDirty();
+    BOOST_CHECK(source->isDirty());
+
+    // Check that dependents survive their children.
+    boost::shared_ptr<TestNode> child = boost::make_shared<TestNode>();
+    const boost::shared_ptr<TestNode> parent = boost::make_shared<TestNode>();
+    parent->setDerived({child});
+    parent->beginIncremental();
+    child.reset();
+    parent->markClean();
+    BOOST_CHECK(!parent->isDirty());
+
+    // Check that a child shared by dependents destroyed before and after it
+    // is no longer consulted.
+    boost::shared_ptr<TestNode> shared = boost::make_shared<TestNode>();
+    boost::shared_ptr<TestNode> first = boost::make_shared<TestNode>();
+    const boost::shared_ptr<TestNode> second = boost::make_shared<TestNode>();
+    first->setDerived({shared});
+    second->setDerived({shared, parent});
+    second->beginIncremental();
+    second->markClean();
+    BOOST_CHECK(second->isDirty());
+    first.reset();
+    shared.reset();
+    second->markClean();
+    BOOST_CHECK(!second->isDirty());
+    parent->markDirty();
+    BOOST_CHECK(second->isDirty());
+  });
+}
+}
@@ -3,6 +3,7 @@
 #include <sfrp/behavioroperators.hpp>
 #include <sfrp/behaviorutil.hpp>
 #include <stest/testcollector.hpp>
+#include <vector>
 
 static void example1()
 {
@@ -71,6 +72,98 @@ void behavioroperatorsTests(stest::TestCollector& col) {
         sfrp::BehaviorUtil::always(4));
     BOOST_CHECK(ifThenElse.pull(0.0) == boost::make_optional(4));
     BOOST_CHECK(ifThenElse.pull(1.6) == boost::make_optional(3));
+
+    // With a constant comparison the case that isn't selected is still
+    // pulled, and the result ends when it ends.
+    std::vector<double> pullTimes;
+    const sfrp::Behavior<int> unselected =
+        sfrp::Behavior<int>::fromValuePullFunc([&pullTimes](double time) {
+          pullTimes.push_back(time);
+          return time < 1.0 ? boost::make_optional(4) : boost::none;
+        });
+    const sfrp::Behavior<int> strict = sfrp::BehaviorOperators::ifThenElse(
+        sfrp::BehaviorUtil::always(true),
+        sfrp::BehaviorUtil::always(3),
+        unselected);
+    BOOST_CHECK(strict.pull(0.0) == boost::make_optional(3));
+    BOOST_CHECK(strict.pull(0.5) == boost::make_optional(3));
+    BOOST_CHECK(!strict.pull(1.0));
+    BOOST_CHECK_EQUAL(pullTimes.size(), 3u);
+
+    // Constant arguments are folded.
+    BOOST_CHECK(sfrp::BehaviorOperators::ifThenElse(
+                    sfrp::BehaviorUtil::always(false),
+                    sfrp::BehaviorUtil::always(3),
+                    sfrp::BehaviorUtil::always(4)).isConstant());
+  });
+  col.addTest("sfrp_behavioroperators_constant", []()->void {
+    const sfrp::Behavior<double> sum =
+        sfrp::BehaviorUtil::always(1.0) + sfrp::BehaviorUtil::always(2.0);
+    BOOST_CHECK(sum.isConstant());
+    BOOST_CHECK(sum.constantValue() == boost::make_optional(3.0));
+    BOOST_CHECK(!(sfrp::BehaviorUtil::time() + sum).isConstant());
+  });
+  col.addTest("sfrp_behavioroperators_lazyIfThenElse", []()->void {
+    // Each case records the times at which it is pulled.
+    std::vector<double> trueTimes;
+    std::vector<double> falseTimes;
+    const sfrp::Behavior<int> lazy = sfrp::BehaviorOperators::lazyIfThenElse(
+        sfrp::BehaviorUtil::pure([](double time) {
+          return time >= 1.0 && time < 2.0;
+        }),
+        sfrp::Behavior<int>::fromValuePullFunc([&trueTimes](double time) {
+          trueTimes.push_back(time);
+          return boost::make_optional(3);
+        }),
+        sfrp::Behavior<int>::fromValuePullFunc([&falseTimes](double time) {
+          falseTimes.push_back(time);
+          return boost::make_optional(4);
+        }));
+    for (int i = 0; i < 6; ++i) {
+      const double time = i * 0.5;
+      BOOST_CHECK(lazy.pull(time) ==
+                  boost::make_optional(time >= 1.0 && time < 2.0 ? 3 : 4));
+    }
+    BOOST_CHECK(trueTimes == std::vector<double>({1.0, 1.5}));
+    BOOST_CHECK(falseTimes == std::vector<double>({0.0, 0.5, 2.0, 2.5}));
+
+    // A case that isn't selected may be undefined.
+    const sfrp::Behavior<int> guarded = sfrp::BehaviorOperators::lazyIfThenElse(
+        sfrp::BehaviorUtil::pure([](double time) { return time < 1.0; }),
+        sfrp::BehaviorUtil::always(1),
+        sfrp::Behavior<int>());
+    BOOST_CHECK(guarded.isPure());
+    BOOST_CHECK(guarded.pull(0.5) == boost::make_optional(1));
+    BOOST_CHECK(guarded.pull(1.5) == boost::none);
+    BOOST_CHECK(guarded.pull(2.0) == boost::none);
+  });
+  col.addTest("sfrp_behavioroperators_lazyAndOr", []()->void {
+    int numPulls = 0;
+    const sfrp::Behavior<bool> rhs =
+        sfrp::Behavior<bool>::fromValuePullFunc([&numPulls](double time) {
+          ++numPulls;
+          return boost::make_optional(time < 2.0);
+        });
+    const sfrp::Behavior<bool> lhs =
+        sfrp::BehaviorUtil::pure([](double time) { return time >= 1.0; });
+    const sfrp::Behavior<bool> lazyAnd =
+        sfrp::BehaviorOperators::lazyAnd(lhs, rhs);
+    BOOST_CHECK(lazyAnd.pull(0.0) == boost::make_optional(false));
+    BOOST_CHECK_EQUAL(numPulls, 0);
+    BOOST_CHECK(lazyAnd.pull(1.0) == boost::make_optional(true));
+    BOOST_CHECK(lazyAnd.pull(2.0) == boost::make_optional(false));
+    BOOST_CHECK_EQUAL(numPulls, 2);
+
+    const sfrp::Behavior<bool> lazyOr = sfrp::BehaviorOperators::lazyOr(
+        lhs, sfrp::BehaviorUtil::pure([](double time) { return time < 0.5; }));
+    BOOST_CHECK(lazyOr.pull(0.0) == boost::make_optional(true));
+    BOOST_CHECK(lazyOr.pull(0.6) == boost::make_optional(false));
+    BOOST_CHECK(lazyOr.pull(1.6) == boost::make_optional(true));
+
+    // A constant left-hand side is folded.
+    BOOST_CHECK(sfrp::BehaviorOperators::lazyAnd(
+                    sfrp::BehaviorUtil::always(true), rhs).node() ==
+                rhs.node());
   });
 }
 }
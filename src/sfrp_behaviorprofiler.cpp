@@ -0,0 +1,199 @@
+#include <sfrp/behaviorprofiler.hpp>
+
+#include <boost/core/demangle.hpp>
+#include <boost/make_shared.hpp>
+#include <sfrp/behaviornode.hpp>
+#include <smisc/doc.hpp>
+#include <algorithm>  // std::sort, std::max
+#include <iomanip>    // std::setprecision
+#include <ostream>
+#include <sstream>
+#include <vector>
+
+namespace {
+// This class implements the registry of the records of all nodes.
+struct Registry {
+  std::mutex mutex;
+  std::vector<boost::shared_ptr<sfrp::BehaviorProfiler_Record>> records;
+  std::uint64_t nextId = 0;
+};
+
+Registry& registry() {
+  static Registry r;
+  return r;
+}
+
+// Return the registered records ordered by decreasing exclusive time.
+std::vector<boost::shared_ptr<sfrp::BehaviorProfiler_Record>> rankedRecords() {
+  std::vector<boost::shared_ptr<sfrp::BehaviorProfiler_Record>> records;
+  {
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    records = registry().records;
+  }
+  std::stable_sort(
+      records.begin(), records.end(),
+      [](const boost::shared_ptr<sfrp::BehaviorProfiler_Record>& a,
+         const boost::shared_ptr<sfrp::BehaviorProfiler_Record>& b) {
+        return a->exclusiveNanoseconds > b->exclusiveNanoseconds;
+      });
+  return records;
+}
+
+std::string formatMilliseconds(std::uint64_t nanoseconds) {
+  std::ostringstream s;
+  s << std::fixed << std::setprecision(3) << nanoseconds / 1e6;
+  return s.str();
+}
+
+std::string formatSeconds(std::uint64_t nanoseconds) {
+  std::ostringstream s;
+  s << std::setprecision(9) << nanoseconds / 1e9;
+  return s.str();
+}
+
+std::string jsonString(const std::string& value) {
+  std::ostringstream s;
+  s << '"';
+  for (const char c : value) {
+    if (c == '"' || c == '\\')
+      s << '\\' << c;
+    else if (static_cast<unsigned char>(c) < 0x20)
+      s << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+        << static_cast<int>(c) << std::dec;
+    else
+      s << c;
+  }
+  s << '"';
+  return s.str();
+}
+}
+
+namespace sfrp {
+BehaviorProfiler_Record::BehaviorProfiler_Record(std::uint64_t id)
+    : numPulls(0),
+      numCacheHits(0),
+      inclusiveNanoseconds(0),
+      exclusiveNanoseconds(0),
+      numValueCopies(0),
+      m_id(id),
+      m_valueType(0),
+      m_nameMutex(),
+      m_name() {}
+
+std::string BehaviorProfiler_Record::name() const {
+  std::lock_guard<std::mutex> lock(m_nameMutex);
+  return m_name;
+}
+
+void BehaviorProfiler_Record::setName(const std::string& name) {
+  std::lock_guard<std::mutex> lock(m_nameMutex);
+  m_name = name;
+}
+
+std::string BehaviorProfiler_Record::valueTypeName() const {
+  const std::type_info* const valueType = m_valueType;
+  return valueType ? boost::core::demangle(valueType->name()) : std::string();
+}
+
+void BehaviorProfiler_Record::setValueType(const std::type_info& valueType) {
+  m_valueType = &valueType;
+}
+
+void BehaviorProfiler_Record::reset() {
+  numPulls = 0;
+  numCacheHits = 0;
+  inclusiveNanoseconds = 0;
+  exclusiveNanoseconds = 0;
+  numValueCopies = 0;
+}
+
+#ifdef SFRP_PROFILE
+BehaviorProfiler_PullScope*& BehaviorProfiler_PullScope::current() {
+  thread_local BehaviorProfiler_PullScope* scope = 0;
+  return scope;
+}
+#endif
+
+boost::shared_ptr<BehaviorProfiler_Record> BehaviorProfiler::createRecord() {
+  std::lock_guard<std::mutex> lock(registry().mutex);
+  const boost::shared_ptr<BehaviorProfiler_Record> record =
+      boost::make_shared<BehaviorProfiler_Record>(registry().nextId++);
+  registry().records.push_back(record);
+  return record;
+}
+
+void BehaviorProfiler::setName(const BehaviorNode& node,
+                               const std::string& name) {
+  if (BehaviorProfiler_Record* const record = node.profileRecord())
+    record->setName(name);
+}
+
+smisc::Doc BehaviorProfiler::report() {
+  std::vector<std::vector<std::string>> rows;
+  rows.push_back({"node", "name", "type", "pulls", "cacheHits", "inclusiveMs",
+                  "exclusiveMs", "valueCopies"});
+  for (const boost::shared_ptr<BehaviorProfiler_Record>& record :
+       rankedRecords()) {
+    rows.push_back({std::to_string(record->id()), record->name(),
+                    record->valueTypeName(), std::to_string(record->numPulls),
+                    std::to_string(record->numCacheHits),
+                    formatMilliseconds(record->inclusiveNanoseconds),
+                    formatMilliseconds(record->exclusiveNanoseconds),
+                    std::to_string(record->numValueCopies)});
+  }
+
+  std::vector<std::size_t> widths(rows.front().size(), 0);
+  for (const std::vector<std::string>& row : rows) {
+    for (std::size_t i = 0; i < row.size(); ++i)
+      widths[i] = std::max(widths[i], row[i].size());
+  }
+
+  std::vector<smisc::Doc> lines;
+  for (const std::vector<std::string>& row : rows) {
+    std::vector<smisc::Doc> cells;
+    for (std::size_t i = 0; i < row.size(); ++i) {
+      const std::string padding(widths[i] - row[i].size(), ' ');
+      cells.push_back(smisc::dStr(i + 1 < row.size() ? row[i] + padding + "  "
+                                                     : row[i]));
+    }
+    lines.push_back(smisc::dHorL(cells));
+  }
+  return smisc::dVertL(lines);
+}
+
+void BehaviorProfiler::writeJson(std::ostream& stream) {
+  stream << "{\"nodes\":[";
+  bool first = true;
+  for (const boost::shared_ptr<BehaviorProfiler_Record>& record :
+       rankedRecords()) {
+    if (!first)
+      stream << ',';
+    first = false;
+    stream << "{\"id\":" << record->id()
+           << ",\"name\":" << jsonString(record->name())
+           << ",\"type\":" << jsonString(record->valueTypeName())
+           << ",\"pulls\":" << record->numPulls
+           << ",\"cacheHits\":" << record->numCacheHits
+           << ",\"inclusiveSeconds\":"
+           << formatSeconds(record->inclusiveNanoseconds)
+           << ",\"exclusiveSeconds\":"
+           << formatSeconds(record->exclusiveNanoseconds)
+           << ",\"valueCopies\":" << record->numValueCopies << '}';
+  }
+  stream << "]}";
+}
+
+void BehaviorProfiler::reset() {
+  std::lock_guard<std::mutex> lock(registry().mutex);
+  std::vector<boost::shared_ptr<BehaviorProfiler_Record>>& records =
+      registry().records;
+  records.erase(
+      std::remove_if(records.begin(), records.end(),
+                     [](const boost::shared_ptr<BehaviorProfiler_Record>& r) {
+                       return r.unique();
+                     }),
+      records.end());
+  for (const boost::shared_ptr<BehaviorProfiler_Record>& record : records)
+    record->reset();
+}
+}
@@ -0,0 +1,76 @@
+#include <sfrp/behaviorprofiler.t.hpp>
+
+#include <boost/lexical_cast.hpp>
+#include <sfrp/behavior.hpp>
+#include <sfrp/behaviormap.hpp>
+#include <sfrp/behaviorprofiler.hpp>
+#include <smisc/doc.hpp>
+#include <stest/testcollector.hpp>
+#include <sstream>
+#include <string>
+
+namespace sfrp {
+void behaviorprofilerTests(stest::TestCollector& col) {
+  col.addTest("sfrp_behaviorprofiler_counts", []()->void {
+    const Behavior<int> source = Behavior<int>::fromValuePullFunc(
+        [](double time) { return boost::make_optional(static_cast<int>(time)); });
+    const Behavior<int> doubled =
+        BehaviorMap()([](int a) { return a * 2; }, source);
+    const Behavior<int> sum =
+        BehaviorMap()([](int a, int b) { return a + b; }, source, doubled);
+    BehaviorProfiler::setName(*source.node(), "source");
+
+    for (int i = 0; i < 10; ++i)
+      BOOST_CHECK_EQUAL(*sum.pull(i), i * 3);
+
+    const BehaviorProfiler_Record* const sourceRecord =
+        source.node()->profileRecord();
+    if (!BehaviorProfiler::isEnabled()) {
+      BOOST_CHECK(!sourceRecord);
+      return;
+    }
+
+    const BehaviorProfiler_Record* const sumRecord =
+        sum.node()->profileRecord();
+
+    // 'source' is pulled by 'sum' and then again by 'doubled' at every time.
+    // Both read its cached value without copying it.
+    BOOST_REQUIRE(sourceRecord);
+    BOOST_CHECK_EQUAL(sourceRecord->name(), "source");
+    BOOST_CHECK_EQUAL(sourceRecord->valueTypeName(), "int");
+    BOOST_CHECK_EQUAL(sourceRecord->numPulls, 20u);
+    BOOST_CHECK_EQUAL(sourceRecord->numCacheHits, 10u);
+    BOOST_CHECK_EQUAL(sourceRecord->numValueCopies, 0u);
+    BOOST_CHECK_EQUAL(sumRecord->numValueCopies, 10u);
+
+    BOOST_CHECK_EQUAL(sumRecord->numPulls, 10u);
+    BOOST_CHECK_EQUAL(sumRecord->numCacheHits, 0u);
+    BOOST_CHECK(sumRecord->inclusiveNanoseconds >=
+                sumRecord->exclusiveNanoseconds);
+    BOOST_CHECK(sumRecord->inclusiveNanoseconds >=
+                sourceRecord->inclusiveNanoseconds);
+  });
+  col.addTest("sfrp_behaviorprofiler_report", []()->void {
+    BehaviorProfiler::reset();
+    const Behavior<double> reported = Behavior<double>::fromValuePullFunc(
+        [](double time) { return boost::make_optional(time); });
+    BehaviorProfiler::setName(*reported.node(), "reported \"node\"");
+    reported.pull(1.0);
+
+    const std::string report =
+        boost::lexical_cast<std::string>(BehaviorProfiler::report());
+    BOOST_CHECK(report.find("exclusiveMs") != std::string::npos);
+
+    std::ostringstream json;
+    BehaviorProfiler::writeJson(json);
+    BOOST_CHECK_EQUAL(json.str().find("{\"nodes\":["), 0u);
+    if (BehaviorProfiler::isEnabled()) {
+      BOOST_CHECK(report.find("reported \"node\"") != std::string::npos);
+      BOOST_CHECK(json.str().find("\"name\":\"reported \\\"node\\\"\"") !=
+                  std::string::npos);
+    } else {
+      BOOST_CHECK_EQUAL(json.str(), "{\"nodes\":[]}");
+    }
+  });
+}
+}
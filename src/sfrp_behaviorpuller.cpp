@@ -2,4 +2,6 @@
 
 namespace sfrp {
 BehaviorPuller::BehaviorPuller(double time) : m_time(time) {}
+
+BehaviorReferencePuller::BehaviorReferencePuller(double time) : m_time(time) {}
 }
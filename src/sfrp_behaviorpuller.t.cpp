@@ -21,6 +21,10 @@ static void example() {
   boost::optional<int> intTimeReult = atOne( intTime );
   // Will be 'make_optional(string("Four"))'
   boost::optional<std::string> alwaysFourResult = atOne( alwaysFour );
+
+  sfrp::BehaviorReferencePuller refAtOne(1.0);
+  // Will refer to the cached "Four" of 'alwaysFour'
+  boost::optional<const std::string&> alwaysFourRef = refAtOne( alwaysFour );
 }
 
 namespace sfrp {
@@ -45,5 +49,21 @@ void behaviorpullerTests(stest::TestCollector& col) {
     BOOST_CHECK(atOne(intTime) == boost::make_optional(1));
     BOOST_CHECK(atOne(doubleIntTime) == boost::make_optional(2));
   });
+  col.addTest("sfrp_behaviorpuller_reference", []()->void {
+    sfrp::Behavior<std::string> intTimeString =
+        sfrp::Behavior<std::string>::fromValuePullFunc([](double time) {
+          return time < 2.0 ? boost::make_optional(std::to_string(int(time)))
+                            : boost::none;
+        });
+
+    sfrp::BehaviorReferencePuller atOne(1.0);
+    const boost::optional<const std::string&> first = atOne(intTimeString);
+    const boost::optional<const std::string&> second = atOne(intTimeString);
+    BOOST_REQUIRE(first && second);
+    BOOST_CHECK_EQUAL(*first, "1");
+    BOOST_CHECK_EQUAL(&*first, &*second);
+
+    BOOST_CHECK(!sfrp::BehaviorReferencePuller(2.0)(intTimeString));
+  });
 }
 }
@@ -0,0 +1,45 @@
+#include <sfrp/behaviorschedule.hpp>
+
+#include <unordered_set>
+#include <utility>  // std::pair
+
+namespace sfrp {
+BehaviorSchedule_Steps::BehaviorSchedule_Steps(
+    const boost::shared_ptr<BehaviorNode>& root)
+    : m_steps() {
+  // The walk is an iterative depth-first search that appends every node once
+  // all of its children were appended. Each entry of the stack is a node and
+  // the position of the next of its children to visit.
+  std::unordered_set<BehaviorNode*> visited;
+  std::vector<std::pair<boost::shared_ptr<BehaviorNode>, std::size_t>> stack;
+  if (root) {
+    visited.insert(root.get());
+    stack.emplace_back(root, 0);
+  }
+  while (!stack.empty()) {
+    const boost::shared_ptr<BehaviorNode> node = stack.back().first;
+    const std::vector<boost::weak_ptr<BehaviorNode>>& children =
+        node->children();
+    std::size_t& childIndex = stack.back().second;
+    boost::shared_ptr<BehaviorNode> child;
+    while (!child && childIndex < children.size()) {
+      child = children[childIndex++].lock();
+      if (child && !visited.insert(child.get()).second)
+        child.reset();
+    }
+    if (child)
+      stack.emplace_back(child, 0);
+    else {
+      m_steps.push_back(Step{node.get(), node});
+      stack.pop_back();
+    }
+  }
+}
+
+void BehaviorSchedule_Steps::pullDescendantsAt(double time) const {
+  for (std::size_t i = 0; i + 1 < m_steps.size(); ++i) {
+    if (!m_steps[i].weakNode.expired())
+      m_steps[i].node->pullAt(time);
+  }
+}
+}
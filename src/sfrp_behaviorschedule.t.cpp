@@ -0,0 +1,104 @@
+#include <sfrp/behaviorschedule.t.hpp>
+
+#include <boost/optional/optional_io.hpp>
+#include <sfrp/behaviorschedule.hpp>
+#include <sfrp/behaviorutil.hpp>
+#include <sfrp/wormhole.hpp>
+#include <stest/testcollector.hpp>
+#include <cstddef>  // std::size_t
+#include <map>
+
+namespace {
+// Return a behavior whose value at every pull is ten times the value of
+// 'sfrp::BehaviorUtil::time()' at the previous pull. The output of the
+// wormhole is pulled before its input.
+sfrp::Behavior<double> makeTenTimesPrevious() {
+  const sfrp::Wormhole<double> w(0.0);
+  return sfrp::BehaviorUtil::curtail(
+      sfrp::BehaviorUtil::map([](double previous) { return previous * 10.0; },
+                              w.outputBehavior()),
+      w.setInputBehavior(sfrp::BehaviorUtil::time()));
+}
+}
+
+namespace sfrp {
+void behaviorscheduleTests(stest::TestCollector& col) {
+  col.addTest("sfrp_behaviorschedule_order", []()->void {
+    // A diamond whose shared node is evaluated once per pull.
+    int numCalls = 0;
+    const Behavior<double> shared = BehaviorUtil::map([&numCalls](double t) {
+      ++numCalls;
+      return t * 2.0;
+    }, BehaviorUtil::time());
+    const Behavior<double> root = BehaviorUtil::map(
+        [](double x, double y) { return x + y; },
+        BehaviorUtil::map([](double x) { return x + 1.0; }, shared),
+        BehaviorUtil::map([](double x) { return x * x; }, shared));
+    BehaviorSchedule<double> schedule(root);
+
+    // Every node is scheduled once and after its children.
+    const BehaviorSchedule_Steps& steps = schedule.steps();
+    BOOST_CHECK_EQUAL(steps.size(), 5u);
+    std::map<BehaviorNode*, std::size_t> positions;
+    for (std::size_t i = 0; i < steps.size(); ++i) {
+      BOOST_REQUIRE(steps.node(i));
+      positions[steps.node(i)] = i;
+    }
+    BOOST_CHECK_EQUAL(positions.size(), steps.size());
+    for (std::size_t i = 0; i < steps.size(); ++i) {
+      for (const boost::weak_ptr<BehaviorNode>& child :
+           steps.node(i)->children())
+        BOOST_CHECK(positions.at(child.lock().get()) < i);
+    }
+    BOOST_CHECK(steps.node(steps.size() - 1) == root.nodeAddress());
+
+    BOOST_CHECK_EQUAL(schedule.pull(1.0), boost::make_optional(7.0));
+    BOOST_CHECK_EQUAL(*schedule.pullPointer(2.0), 21.0);
+    BOOST_CHECK_EQUAL(numCalls, 2);
+  });
+  col.addTest("sfrp_behaviorschedule_wormhole", []()->void {
+    // A schedule reads the outputs of wormholes at the same point of a pull
+    // as a recursive pull does.
+    const Behavior<double> recursive = makeTenTimesPrevious();
+    BehaviorSchedule<double> schedule(makeTenTimesPrevious());
+    for (int step = 0; step < 5; ++step) {
+      const double time = step * 0.5;
+      BOOST_CHECK_EQUAL(schedule.pull(time), recursive.pull(time));
+    }
+    BOOST_CHECK_EQUAL(schedule.pull(3.0), boost::make_optional(20.0));
+
+    // The arguments of a map are scheduled in order.
+    const Wormhole<double> w(0.0);
+    BehaviorSchedule<double> sum(BehaviorUtil::map(
+        [](double previous, double current) { return previous + current; },
+        w.outputBehavior(),
+        w.setInputBehavior(BehaviorUtil::time())));
+    BOOST_CHECK_EQUAL(sum.pull(1.0), boost::make_optional(1.0));
+    BOOST_CHECK_EQUAL(sum.pull(2.0), boost::make_optional(3.0));
+  });
+  col.addTest("sfrp_behaviorschedule_undefined", []()->void {
+    // The arguments released by a behavior that became undefined are
+    // skipped.
+    const Behavior<double> root = BehaviorUtil::curtail(
+        BehaviorUtil::map([](double t) { return t + 1.0; },
+                          BehaviorUtil::time()),
+        Behavior<int>::fromValuePullFunc([](double t) {
+          return t < 1.0 ? boost::make_optional(0) : boost::none;
+        }));
+    BehaviorSchedule<double> schedule(root);
+    BOOST_CHECK_EQUAL(schedule.steps().size(), 4u);
+    BOOST_CHECK_EQUAL(schedule.pull(0.0), boost::make_optional(1.0));
+    BOOST_CHECK_EQUAL(schedule.pull(1.0), boost::none);
+    std::size_t numDestroyed = 0;
+    for (std::size_t i = 0; i < schedule.steps().size(); ++i)
+      numDestroyed += schedule.steps().node(i) ? 0 : 1;
+    BOOST_CHECK_EQUAL(numDestroyed, 3u);
+    BOOST_CHECK_EQUAL(schedule.pull(2.0), boost::none);
+  });
+  col.addTest("sfrp_behaviorschedule_empty", []()->void {
+    BehaviorSchedule<int> schedule((Behavior<int>()));
+    BOOST_CHECK_EQUAL(schedule.steps().size(), 0u);
+    BOOST_CHECK_EQUAL(schedule.pull(0.0), boost::none);
+  });
+}
+}
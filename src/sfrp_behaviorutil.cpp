@@ -1,9 +1,15 @@
 #include <sfrp/behaviorutil.hpp>
 
+#include <algorithm>  // std::copy
+
 namespace sfrp {
 Behavior<double> BehaviorUtil::time() {
-  return Behavior<double>::fromValuePullFunc([](double time) {
-    return boost::make_optional(time);
-  });
+  const boost::function<std::size_t(const double*, std::size_t, double*)>
+      copy = [](const double* times, std::size_t n, double* out) {
+        std::copy(times, times + n, out);
+        return n;
+      };
+  return Behavior<double>::fromValuePullFunc(
+      [](double time) { return boost::make_optional(time); }, copy, copy);
 }
 }
@@ -4,7 +4,8 @@
 #include <smisc/unit.hpp>
 #include <sfrp/behaviorutil.hpp>
 #include <stest/testcollector.hpp>
-#include <cmath>  // std::atan2, std::sin
+#include <cmath>    // std::atan2, std::sin
+#include <utility>  // std::make_pair, std::pair
 
 namespace {
 
@@ -50,6 +51,9 @@ void behaviorutilTests(stest::TestCollector& col) {
     BOOST_CHECK_EQUAL(always3.pull(0.0), boost::make_optional(3));
     BOOST_CHECK_EQUAL(always3.pull(1.0), boost::make_optional(3));
     BOOST_CHECK_EQUAL(always3.pull(2.0), boost::make_optional(3));
+    BOOST_CHECK(always3.isConstant());
+    BOOST_CHECK_EQUAL(always3.constantValue(), boost::make_optional(3));
+    BOOST_CHECK(!sfrp::BehaviorUtil::time().isConstant());
   });
   col.addTest("sfrp_behaviorutil_time", []()->void {
     sfrp::Behavior<double> time = sfrp::BehaviorUtil::time();
@@ -74,6 +78,13 @@ void behaviorutilTests(stest::TestCollector& col) {
     BOOST_CHECK_EQUAL(curtailed.pull(0.0), boost::make_optional(3));
     BOOST_CHECK_EQUAL(curtailed.pull(1.0), boost::make_optional(3));
     BOOST_CHECK_EQUAL(curtailed.pull(2.1), boost::none);
+
+    // A constant curtailing behavior is folded.
+    const sfrp::Behavior<double> time = sfrp::BehaviorUtil::time();
+    BOOST_CHECK(sfrp::BehaviorUtil::curtail(time, sfrp::BehaviorUtil::always(1))
+                    .node() == time.node());
+    BOOST_CHECK(!sfrp::BehaviorUtil::curtail(time, sfrp::Behavior<int>())
+                     .node());
   });
   col.addTest("sfrp_behaviorutil_map", []()->void {
     sfrp::Behavior<double> mapped =
@@ -84,5 +95,63 @@ void behaviorutilTests(stest::TestCollector& col) {
     BOOST_CHECK_EQUAL(mapped.pull(1.0), boost::make_optional(2.0));
     BOOST_CHECK_EQUAL(mapped.pull(3.0), boost::make_optional(4.0));
   });
+  col.addTest("sfrp_behaviorutil_pullBatch", []()->void {
+    sfrp::Behavior<double> mapped =
+        sfrp::BehaviorUtil::map([](double a, double b) { return a + b; },
+                                sfrp::BehaviorUtil::always(1.0),
+                                sfrp::BehaviorUtil::pure(
+                                    [](double time) { return time * 2.0; }));
+    BOOST_CHECK(mapped.isPure());
+    const double times[] = {0.0, 1.0, 3.0};
+    double values[3];
+    BOOST_CHECK_EQUAL(mapped.pullBatch(times, 3, values), 3u);
+    BOOST_CHECK_EQUAL(values[0], 1.0);
+    BOOST_CHECK_EQUAL(values[1], 3.0);
+    BOOST_CHECK_EQUAL(values[2], 7.0);
+    BOOST_CHECK_EQUAL(mapped.pull(3.0), boost::make_optional(7.0));
+  });
+  col.addTest("sfrp_behaviorutil_distinct", []()->void {
+    // The level changes at times 1.0 and 2.0.
+    int numCalls = 0;
+    const sfrp::Behavior<int> level = sfrp::BehaviorUtil::distinct(
+        sfrp::BehaviorUtil::map([](double time) { return int(time); },
+                                sfrp::BehaviorUtil::time()));
+    BOOST_CHECK(level.node()->reportsChanges());
+    const sfrp::Behavior<int> banner =
+        sfrp::BehaviorUtil::map([&numCalls](int l) {
+          ++numCalls;
+          return l * 10;
+        }, level);
+    for (int i = 0; i < 12; ++i) {
+      BOOST_CHECK_EQUAL(banner.pull(i * 0.25),
+                        boost::make_optional(i / 4 * 10));
+    }
+    BOOST_CHECK_EQUAL(numCalls, 3);
+
+    // Pure and constant behaviors remain so.
+    const sfrp::Behavior<double> pure = sfrp::BehaviorUtil::distinct(
+        sfrp::BehaviorUtil::pure([](double time) { return time * 2.0; }));
+    BOOST_CHECK(pure.isPure());
+    const double times[] = {0.0, 1.0};
+    double values[2];
+    BOOST_CHECK_EQUAL(pure.pullBatch(times, 2, values), 2u);
+    BOOST_CHECK_EQUAL(values[1], 2.0);
+    const sfrp::Behavior<int> always3 = sfrp::BehaviorUtil::always(3);
+    BOOST_CHECK(sfrp::BehaviorUtil::distinct(always3).node() ==
+                always3.node());
+
+    // Values without 'operator==', including pairs of such values, can't be
+    // made distinct.
+    typedef sfrp::CachedIncreasingPartialTimeFunction_ValueComparison<
+        std::pair<int, Drawing>> DrawingComparison;
+    typedef sfrp::CachedIncreasingPartialTimeFunction_ValueComparison<
+        std::pair<int, int>> IntComparison;
+    BOOST_CHECK(!DrawingComparison::comparable());
+    BOOST_CHECK(IntComparison::comparable());
+    BOOST_CHECK(sfrp::BehaviorUtil::distinct(sfrp::BehaviorUtil::pure(
+                    [](double time) { return std::make_pair(1, 2); }))
+                    .node()
+                    ->reportsChanges());
+  });
 }
 }
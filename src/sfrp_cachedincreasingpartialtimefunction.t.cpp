@@ -2,6 +2,8 @@
 
 #include <sfrp/cachedincreasingpartialtimefunction.hpp>
 #include <stest/testcollector.hpp>
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::uint64_t
 
 namespace sfrp {
 void cachedincreasingpartialtimefunctionTests(stest::TestCollector& col)
@@ -24,5 +26,86 @@ void cachedincreasingpartialtimefunctionTests(stest::TestCollector& col)
     BOOST_CHECK(b.pull(2.0) == boost::make_optional(2.0));
     BOOST_CHECK_EQUAL(numCalls, 2);
   });
+  col.addTest("sfrp_cachedincreasingpartialtimefunction_pullBatch",
+                  []()->void {
+    // Check that a batch starting at the cached time uses the cache, and that
+    // the last value of a batch is cached.
+    int numCalls = 0;
+    sfrp::CachedIncreasingPartialTimeFunction<double> b(
+            [&numCalls](double t)->boost::optional<double> {
+              ++numCalls;
+              return t;
+            });
+
+    BOOST_CHECK(b.pull(1.0) == boost::make_optional(1.0));
+    BOOST_CHECK_EQUAL(numCalls, 1);
+    const double times[] = {1.0, 2.0, 3.0};
+    double values[3];
+    BOOST_CHECK_EQUAL(b.pullBatch(times, 3, values), 3u);
+    BOOST_CHECK_EQUAL(values[0], 1.0);
+    BOOST_CHECK_EQUAL(values[2], 3.0);
+    BOOST_CHECK_EQUAL(numCalls, 3);
+    BOOST_CHECK(b.pull(3.0) == boost::make_optional(3.0));
+    BOOST_CHECK_EQUAL(numCalls, 3);
+  });
+  col.addTest("sfrp_cachedincreasingpartialtimefunction_pullBatchVersion",
+                  []()->void {
+    // Check that batches update the value version and dirty state like pulls
+    // do.
+    sfrp::CachedIncreasingPartialTimeFunction<int> b(
+            [](double t)->boost::optional<int> { return t < 5.0 ? 1 : 2; });
+    b.setDistinct();
+    b.beginIncremental();
+
+    BOOST_CHECK(b.pull(0.0) == boost::make_optional(1));
+    const std::uint64_t version = b.valueVersion();
+    const double times[] = {1.0, 2.0, 3.0};
+    int values[3];
+    BOOST_CHECK_EQUAL(b.pullBatch(times, 3, values), 3u);
+    BOOST_CHECK_EQUAL(b.valueVersion(), version);
+    BOOST_CHECK(!b.isDirty());
+    BOOST_CHECK_EQUAL(b.pullBatch(times + 2, 1, values), 1u);
+    BOOST_CHECK_EQUAL(b.valueVersion(), version);
+
+    const double laterTimes[] = {4.0, 5.0};
+    BOOST_CHECK_EQUAL(b.pullBatch(laterTimes, 2, values), 2u);
+    BOOST_CHECK_EQUAL(values[1], 2);
+    BOOST_CHECK(b.valueVersion() != version);
+  });
+  col.addTest("sfrp_cachedincreasingpartialtimefunction_evaluate",
+                  []()->void {
+    // Check that evaluations may precede previous pulls and leave the cache
+    // and value version unchanged, and that only time functions with an
+    // evaluation function are evaluated.
+    const boost::function<std::size_t(const double*, std::size_t, double*)>
+        twice = [](const double* times, std::size_t n, double* out) {
+          for (std::size_t i = 0; i < n; ++i)
+            out[i] = 2.0 * times[i];
+          return n;
+        };
+    sfrp::CachedIncreasingPartialTimeFunction<double> b(
+            [](double t)->boost::optional<double> { return 2.0 * t; },
+            twice,
+            twice);
+    BOOST_CHECK(b.isPure());
+
+    const double* const value = b.pullPointer(3.0);
+    const std::uint64_t version = b.valueVersion();
+    const double times[] = {1.0, 2.0};
+    double values[2];
+    BOOST_CHECK_EQUAL(b.evaluate(times, 2, values), 2u);
+    BOOST_CHECK_EQUAL(values[0], 2.0);
+    BOOST_CHECK_EQUAL(values[1], 4.0);
+    BOOST_CHECK_EQUAL(b.pullPointer(3.0), value);
+    BOOST_CHECK_EQUAL(*value, 6.0);
+    BOOST_CHECK_EQUAL(b.valueVersion(), version);
+
+    sfrp::CachedIncreasingPartialTimeFunction<double> unevaluated(
+            [](double t)->boost::optional<double> { return 2.0 * t; },
+            twice,
+            true);
+    BOOST_CHECK(unevaluated.isPure());
+    BOOST_CHECK_EQUAL(unevaluated.evaluate(times, 2, values), 0u);
+  });
 }
 }
@@ -0,0 +1,144 @@
+#include <sfrp/eventrecorder.hpp>
+
+#include <algorithm>  // std::equal
+#include <stdexcept>  // std::runtime_error
+
+namespace sfrp {
+namespace {
+const char k_MAGIC[8] = {'S', 'F', 'R', 'P', 'L', 'O', 'G', '1'};
+
+template <typename T>
+void appendBytes(const T& value, std::vector<char>* out) {
+  const char* const bytes = reinterpret_cast<const char*>(&value);
+  out->insert(out->end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+bool readBytes(std::istream& stream, T* value) {
+  return bool(stream.read(reinterpret_cast<char*>(value), sizeof(T)));
+}
+}
+
+EventRecorder::EventRecorder(std::ostream& stream)
+    : m_stream(stream),
+      m_mutex(),
+      m_appended(),
+      m_written(),
+      m_buffer(k_MAGIC, k_MAGIC + sizeof(k_MAGIC)),
+      m_numRecorded(0),
+      m_numAppended(sizeof(k_MAGIC)),
+      m_numWritten(0),
+      m_stopped(false),
+      m_writer([this]() { write(); }) {}
+
+EventRecorder::~EventRecorder() {
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopped = true;
+  }
+  m_appended.notify_one();
+  m_writer.join();
+}
+
+void EventRecorder::flush() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  // Bytes appended after this call don't delay it.
+  const std::uint64_t numAppended = m_numAppended;
+  m_appended.notify_one();
+  m_written.wait(lock, [this, numAppended]() {
+    return m_numWritten >= numAppended;
+  });
+}
+
+std::size_t EventRecorder::numRecorded() const {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  return m_numRecorded;
+}
+
+void EventRecorder::append(std::uint32_t channel,
+                           double time,
+                           const std::vector<char>& bytes) {
+  {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    appendBytes(channel, &m_buffer);
+    appendBytes(time, &m_buffer);
+    appendBytes(std::uint32_t(bytes.size()), &m_buffer);
+    m_buffer.insert(m_buffer.end(), bytes.begin(), bytes.end());
+    m_numAppended += sizeof(channel) + sizeof(time) + sizeof(std::uint32_t) +
+                     bytes.size();
+    ++m_numRecorded;
+  }
+  m_appended.notify_one();
+}
+
+void EventRecorder::write() {
+  // The buffers are swapped so that pulls append to one buffer while the
+  // other is written.
+  std::vector<char> buffer;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;) {
+    m_appended.wait(lock, [this]() { return m_stopped || !m_buffer.empty(); });
+    const bool stopped = m_stopped;
+    buffer.swap(m_buffer);
+    lock.unlock();
+
+    m_stream.write(buffer.data(), buffer.size());
+    m_stream.flush();
+    const std::size_t numWritten = buffer.size();
+    buffer.clear();
+
+    lock.lock();
+    m_numWritten += numWritten;
+    m_written.notify_all();
+    if (stopped && m_buffer.empty())
+      return;
+  }
+}
+
+EventReplayer::EventReplayer(std::istream& stream)
+    : m_stream(stream), m_next(), m_channels() {
+  char magic[sizeof(k_MAGIC)];
+  if (!m_stream.read(magic, sizeof(magic)) ||
+      !std::equal(magic, magic + sizeof(magic), k_MAGIC))
+    throw std::runtime_error("sfrp::EventReplayer: not an event log");
+}
+
+double EventReplayer::nextTime() {
+  return peek() ? m_next->second.time
+                : std::numeric_limits<double>::infinity();
+}
+
+void EventReplayer::advance(double time) {
+  while (peek() && m_next->second.time <= time) {
+    const auto channel = m_channels.find(m_next->first);
+    if (channel != m_channels.end())
+      channel->second.push_back(std::move(m_next->second));
+    m_next = boost::none;
+  }
+}
+
+bool EventReplayer::peek() {
+  if (m_next)
+    return true;
+  std::uint32_t channel;
+  Record record;
+  std::uint32_t size;
+  if (!readBytes(m_stream, &channel) || !readBytes(m_stream, &record.time) ||
+      !readBytes(m_stream, &size))
+    return false;
+  record.bytes.resize(size);
+  if (!m_stream.read(record.bytes.data(), size))
+    return false;
+  m_next = std::make_pair(channel, std::move(record));
+  return true;
+}
+
+bool EventReplayer::take(std::uint32_t channel, double time, Record* record) {
+  std::deque<Record>& records = m_channels[channel];
+  if (records.empty() || records.front().time > time)
+    return false;
+  *record = std::move(records.front());
+  records.pop_front();
+  return true;
+}
+}
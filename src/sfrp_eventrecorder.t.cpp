@@ -0,0 +1,89 @@
+#include <sfrp/eventrecorder.t.hpp>
+
+#include <boost/optional/optional_io.hpp>
+#include <sfrp/behaviormap.hpp>
+#include <sfrp/behaviorutil.hpp>
+#include <sfrp/eventrecorder.hpp>
+#include <sfrp/eventutil.hpp>
+#include <sfrp/triggerutil.hpp>
+#include <stest/testcollector.hpp>
+#include <limits>
+#include <sstream>
+#include <stdexcept>  // std::runtime_error
+#include <string>
+#include <utility>  // std::pair
+#include <vector>
+
+namespace sfrp {
+void eventrecorderTests(stest::TestCollector& col) {
+  col.addTest("sfrp_eventrecorder_replay", []()->void {
+    // A graph labeling the latest count with the latest name.
+    const auto makeGraph = [](const Behavior<boost::optional<int>>& counts,
+                              const Behavior<boost::optional<std::string>>&
+                                  names) {
+      return BehaviorMap()(
+          [](int count, const std::string& name) {
+            return name + std::to_string(count);
+          },
+          EventUtil::step(0, counts), EventUtil::step(std::string(), names));
+    };
+
+    std::stringstream log;
+    std::vector<std::pair<double, std::string>> recorded;
+    {
+      EventRecorder recorder(log);
+      const auto counts = TriggerUtil::triggerInf<int>();
+      const auto names = TriggerUtil::triggerInf<std::string>();
+      const Behavior<std::string> graph =
+          makeGraph(recorder.record(0, counts.first),
+                    recorder.record(1, names.first));
+      for (int i = 0; i < 20; ++i) {
+        if (i % 3 == 0)
+          counts.second(i);
+        if (i % 7 == 2)
+          names.second("n" + std::to_string(i));
+        recorded.emplace_back(i * 0.5, *graph.pull(i * 0.5));
+      }
+      recorder.flush();
+      BOOST_CHECK_EQUAL(recorder.numRecorded(), 10u);
+    }
+
+    // The replay pulls the graph at the times of the occurrences only.
+    EventReplayer replayer(log);
+    BOOST_CHECK_EQUAL(replayer.nextTime(), 0.0);
+    const Behavior<std::string> graph = makeGraph(
+        replayer.event<int>(0), replayer.event<std::string>(1));
+    std::vector<std::pair<double, std::string>> replayed;
+    const auto collector = BehaviorMap()(
+        [&replayed](double time, const std::string& value) {
+          replayed.emplace_back(time, value);
+          return 0;
+        },
+        BehaviorUtil::time(), graph);
+    BOOST_CHECK_EQUAL(replayer.run(collector), 9u);
+
+    std::vector<std::pair<double, std::string>> expected;
+    for (const std::pair<double, std::string>& sample : recorded) {
+      const int i = int(sample.first * 2.0);
+      if (i % 3 == 0 || i % 7 == 2)
+        expected.push_back(sample);
+    }
+    BOOST_CHECK(replayed == expected);
+  });
+  col.addTest("sfrp_eventrecorder_header", []()->void {
+    // A flush without occurrences still writes the header of the log.
+    std::stringstream log;
+    EventRecorder recorder(log);
+    recorder.flush();
+    BOOST_CHECK_EQUAL(log.str(), "SFRPLOG1");
+    EventReplayer replayer(log);
+    BOOST_CHECK_EQUAL(replayer.nextTime(),
+                      std::numeric_limits<double>::infinity());
+
+    std::stringstream notALog("SFRPLOG2");
+    BOOST_CHECK_THROW(EventReplayer{notALog}, std::runtime_error);
+    std::stringstream truncated("SFRP");
+    BOOST_CHECK_THROW(EventReplayer{truncated}, std::runtime_error);
+  });
+}
+}
@@ -6,6 +6,7 @@
 #include <sfrp/behavior.hpp>
 #include <sfrp/eventutil.hpp>
 #include <stest/testcollector.hpp>
+#include <cstdint>  // std::uint64_t
 
 namespace {
 struct Color{};
@@ -67,6 +68,12 @@ void eventutilTests(stest::TestCollector& col) {
     BOOST_CHECK_EQUAL(stepped.pull(1.5), boost::make_optional(1));
     BOOST_CHECK_EQUAL(stepped.pull(2.0), boost::make_optional(2));
     BOOST_CHECK_EQUAL(stepped.pull(2.5), boost::make_optional(2));
+
+    // The value version only changes at occurrences.
+    BOOST_CHECK(stepped.node()->reportsChanges());
+    const std::uint64_t version = stepped.valueVersion();
+    BOOST_CHECK_EQUAL(stepped.pull(3.0), boost::make_optional(2));
+    BOOST_CHECK_EQUAL(stepped.valueVersion(), version);
   });
   col.addTest("sfrp_eventutil_never", []()->void {
     sfrp::Behavior<boost::optional<int>> neverInt =
@@ -75,6 +82,11 @@ void eventutilTests(stest::TestCollector& col) {
                       boost::make_optional(boost::optional<int>()));
     BOOST_CHECK_EQUAL(neverInt.pull(1.0),
                       boost::make_optional(boost::optional<int>()));
+    BOOST_CHECK(sfrp::EventUtil::isNever(neverInt));
+    BOOST_CHECK(!sfrp::EventUtil::isNever(
+        sfrp::BehaviorUtil::always(boost::make_optional(1))));
+    BOOST_CHECK(
+        !sfrp::EventUtil::isNever(sfrp::Behavior<boost::optional<int>>()));
   });
   col.addTest("sfrp_eventutil_merge", []()->void {
     sfrp::Behavior<boost::optional<int>> lhs =
@@ -101,6 +113,12 @@ void eventutilTests(stest::TestCollector& col) {
                       boost::make_optional(boost::make_optional(3)));
     BOOST_CHECK_EQUAL(merged.pull(1.5),
                       boost::make_optional(boost::optional<int>()));
+
+    // Merging with an event that never occurs is free.
+    BOOST_CHECK(sfrp::EventUtil::merge(lhs, sfrp::EventUtil::never<int>())
+                    .node() == lhs.node());
+    BOOST_CHECK(sfrp::EventUtil::merge(sfrp::EventUtil::never<int>(), rhs)
+                    .node() == rhs.node());
   });
   col.addTest("sfrp_eventutil_mergeWith", []()->void {
     sfrp::Behavior<boost::optional<int>> lhs =
@@ -236,6 +254,15 @@ void eventutilTests(stest::TestCollector& col) {
                 boost::make_optional(boost::make_optional(1)));
     BOOST_CHECK(when.pull(1.5) == boost::make_optional(boost::optional<int>()));
     BOOST_CHECK(when.pull(2.0) == boost::make_optional(boost::optional<int>()));
+
+    // Constant conditions and events that never occur are folded.
+    BOOST_CHECK(
+        sfrp::EventUtil::when(sfrp::BehaviorUtil::always(true), event).node() ==
+        event.node());
+    BOOST_CHECK(sfrp::EventUtil::isNever(
+        sfrp::EventUtil::when(sfrp::BehaviorUtil::always(false), event)));
+    BOOST_CHECK(sfrp::EventUtil::isNever(
+        sfrp::EventUtil::when(whenBehavior, sfrp::EventUtil::never<int>())));
   });
   col.addTest("sfrp_eventutil_just", []()->void {
     sfrp::Behavior<boost::optional<boost::optional<int>>> event =
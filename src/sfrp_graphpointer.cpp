@@ -0,0 +1 @@
+#include <sfrp/graphpointer.hpp>
@@ -0,0 +1,45 @@
+#include <sfrp/graphpointer.t.hpp>
+
+#include <boost/optional/optional_io.hpp>
+#include <sfrp/behavior.hpp>
+#include <sfrp/behaviorgrapharena.hpp>
+#include <sfrp/behaviormap.hpp>
+#include <sfrp/behaviorutil.hpp>
+#include <sfrp/graphpointer.hpp>
+#include <sfrp/wormhole.hpp>
+#include <stest/testcollector.hpp>
+
+namespace sfrp {
+void graphpointerTests(stest::TestCollector& col) {
+  col.addTest("sfrp_graphpointer_makeGraphPointer", []()->void {
+    GraphPointer<int> pointer = BehaviorGraphArena::makeGraphPointer<int>(3);
+    const GraphPointer<int> copy = pointer;
+    BOOST_CHECK_EQUAL(*copy, 3);
+
+    // Conversions to 'boost::shared_ptr' share the ownership of the object.
+    const boost::shared_ptr<int> shared(copy);
+    pointer.reset();
+    BOOST_CHECK_EQUAL(*shared, 3);
+
+    BehaviorGraphArena arena;
+    {
+      BehaviorGraphArenaScope scope(arena);
+      BOOST_CHECK_EQUAL(*BehaviorGraphArena::makeGraphPointer<int>(4), 4);
+    }
+    BOOST_CHECK_EQUAL(arena.numBlocks(), 1u);
+  });
+  col.addTest("sfrp_graphpointer_behavior", []()->void {
+    // A behavior keeps its node alive through its graph pointer and nodes
+    // converted with 'node()' and 'fromNode()'.
+    Wormhole<int> counter(0);
+    Behavior<int> count = counter.setInputBehavior(BehaviorMap()(
+        [](int previous) { return previous + 1; }, counter.outputBehavior()));
+    const Behavior<int> copy = Behavior<int>::fromNode(count.node());
+    BOOST_CHECK_EQUAL(copy.nodeAddress(), count.nodeAddress());
+    count = Behavior<int>();
+    BOOST_CHECK(!count.nodeAddress());
+    BOOST_CHECK_EQUAL(copy.pull(0.0), boost::make_optional(1));
+    BOOST_CHECK_EQUAL(copy.pull(1.0), boost::make_optional(2));
+  });
+}
+}
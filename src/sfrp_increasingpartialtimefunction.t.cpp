@@ -69,5 +69,23 @@ void increasingpartialtimefunctionTests(stest::TestCollector& col) {
     BOOST_CHECK(b.pull(1.5) == boost::none);
     BOOST_CHECK_EQUAL(intPtr.use_count(), 1);
   });
+  col.addTest("sfrp_increasingpartialtimefunction_pullBatch", []()->void {
+    // Check that 'pullBatch()' stops at the first undefined time and that
+    // later pulls are undefined.
+    sfrp::IncreasingPartialTimeFunction<double> b(
+        [](double t)->boost::optional<double> {
+          if (t < 1.0)
+            return t;
+          else
+            return boost::none;
+        });
+    const double times[] = {0.0, 0.25, 0.5, 1.0, 1.5};
+    double values[5];
+    BOOST_CHECK_EQUAL(b.pullBatch(times, 3, values), 3u);
+    BOOST_CHECK_EQUAL(values[0], 0.0);
+    BOOST_CHECK_EQUAL(values[2], 0.5);
+    BOOST_CHECK_EQUAL(b.pullBatch(times + 3, 2, values), 0u);
+    BOOST_CHECK(b.pull(2.0) == boost::none);
+  });
 }
 }
@@ -0,0 +1,53 @@
+#include <sfrp/incrementalengine.hpp>
+
+#include <unordered_set>
+
+namespace sfrp {
+IncrementalEngine_NodeSet::IncrementalEngine_NodeSet(
+    const boost::shared_ptr<BehaviorNode>& root)
+    : m_nodes(), m_volatileNodes(), m_polledNodes() {
+  std::unordered_set<BehaviorNode*> visited;
+  std::vector<boost::shared_ptr<BehaviorNode>> stack;
+  if (root)
+    stack.push_back(root);
+  while (!stack.empty()) {
+    const boost::shared_ptr<BehaviorNode> node = stack.back();
+    stack.pop_back();
+    if (!visited.insert(node.get()).second)
+      continue;
+
+    node->beginIncremental();
+    m_nodes.push_back(node);
+    if (node->changeMode() == BehaviorNode::e_VOLATILE)
+      m_volatileNodes.push_back(node);
+    else if (node->changeMode() == BehaviorNode::e_POLLED)
+      m_polledNodes.push_back(node);
+
+    for (const boost::weak_ptr<BehaviorNode>& weakChild : node->children()) {
+      if (const boost::shared_ptr<BehaviorNode> child = weakChild.lock())
+        stack.push_back(child);
+    }
+  }
+}
+
+IncrementalEngine_NodeSet::~IncrementalEngine_NodeSet() {
+  for (const boost::weak_ptr<BehaviorNode>& weakNode : m_nodes) {
+    if (const boost::shared_ptr<BehaviorNode> node = weakNode.lock())
+      node->endIncremental();
+  }
+}
+
+void IncrementalEngine_NodeSet::markChanges() {
+  for (const boost::weak_ptr<BehaviorNode>& weakNode : m_volatileNodes) {
+    if (const boost::shared_ptr<BehaviorNode> node = weakNode.lock())
+      node->markDirty();
+  }
+  for (const boost::weak_ptr<BehaviorNode>& weakNode : m_polledNodes) {
+    const boost::shared_ptr<BehaviorNode> node = weakNode.lock();
+    if (node && node->pollChanged())
+      node->markDirty();
+  }
+}
+
+std::size_t IncrementalEngine_NodeSet::size() const { return m_nodes.size(); }
+}
@@ -0,0 +1,93 @@
+#include <sfrp/incrementalengine.t.hpp>
+
+#include <boost/optional/optional_io.hpp>
+#include <sfrp/behaviorutil.hpp>
+#include <sfrp/incrementalengine.hpp>
+#include <sfrp/triggerutil.hpp>
+#include <sfrp/wormhole.hpp>
+#include <stest/testcollector.hpp>
+
+namespace sfrp {
+void incrementalengineTests(stest::TestCollector& col) {
+  col.addTest("sfrp_incrementalengine_constant", []()->void {
+    int numCalls = 0;
+    sfrp::Behavior<int> b = sfrp::BehaviorUtil::map([&numCalls](int i) {
+      ++numCalls;
+      return i + 1;
+    }, sfrp::BehaviorUtil::always(2));
+    sfrp::IncrementalEngine<int> engine(b);
+    // The mapping over a constant is folded into a single constant node.
+    BOOST_CHECK_EQUAL(engine.numNodes(), 1u);
+    BOOST_CHECK_EQUAL(engine.pull(0.0), boost::make_optional(3));
+    BOOST_CHECK_EQUAL(engine.pull(1.0), boost::make_optional(3));
+    BOOST_CHECK_EQUAL(engine.pull(2.0), boost::make_optional(3));
+    BOOST_CHECK_EQUAL(numCalls, 1);
+  });
+  col.addTest("sfrp_incrementalengine_volatile", []()->void {
+    int numCalls = 0;
+    sfrp::Behavior<double> b = sfrp::BehaviorUtil::map([&numCalls](double t) {
+      ++numCalls;
+      return t * 2.0;
+    }, sfrp::BehaviorUtil::time());
+    sfrp::IncrementalEngine<double> engine(b);
+    BOOST_CHECK_EQUAL(engine.pull(0.0), boost::make_optional(0.0));
+    BOOST_CHECK_EQUAL(engine.pull(1.0), boost::make_optional(2.0));
+    BOOST_CHECK_EQUAL(engine.pull(1.0), boost::make_optional(2.0));
+    BOOST_CHECK_EQUAL(numCalls, 2);
+  });
+  col.addTest("sfrp_incrementalengine_trigger", []()->void {
+    // Check that the dependents of a trigger are only evaluated when the
+    // trigger fires and at the following step.
+    int numCalls = 0;
+    auto trigger = sfrp::TriggerUtil::triggerInf<int>();
+    sfrp::Behavior<int> b = sfrp::BehaviorUtil::map(
+        [&numCalls](boost::optional<int> occurrence, double t) {
+          ++numCalls;
+          return occurrence ? *occurrence : -1;
+        },
+        trigger.first,
+        sfrp::BehaviorUtil::always(0.0));
+    sfrp::IncrementalEngine<int> engine(b);
+    BOOST_CHECK_EQUAL(engine.pull(0.0), boost::make_optional(-1));
+    BOOST_CHECK_EQUAL(engine.pull(1.0), boost::make_optional(-1));
+    BOOST_CHECK_EQUAL(numCalls, 1);
+    trigger.second(5);
+    BOOST_CHECK_EQUAL(engine.pull(2.0), boost::make_optional(5));
+    BOOST_CHECK_EQUAL(numCalls, 2);
+    BOOST_CHECK_EQUAL(engine.pull(3.0), boost::make_optional(-1));
+    BOOST_CHECK_EQUAL(numCalls, 3);
+    BOOST_CHECK_EQUAL(engine.pull(4.0), boost::make_optional(-1));
+    BOOST_CHECK_EQUAL(numCalls, 3);
+  });
+  col.addTest("sfrp_incrementalengine_wormhole", []()->void {
+    // A counter that is incremented at every trigger occurrence.
+    int numCalls = 0;
+    auto trigger = sfrp::TriggerUtil::triggerInf<int>();
+    sfrp::Wormhole<int> w(0);
+    sfrp::Behavior<int> counter =
+        w.setInputBehavior(sfrp::BehaviorUtil::map(
+            [&numCalls](boost::optional<int> occurrence, int previous) {
+              ++numCalls;
+              return occurrence ? previous + 1 : previous;
+            },
+            trigger.first,
+            w.outputBehavior()));
+    {
+      sfrp::IncrementalEngine<int> engine(counter);
+      BOOST_CHECK_EQUAL(engine.pull(0.0), boost::make_optional(0));
+      BOOST_CHECK_EQUAL(engine.pull(1.0), boost::make_optional(0));
+      trigger.second(1);
+      BOOST_CHECK_EQUAL(engine.pull(2.0), boost::make_optional(1));
+      BOOST_CHECK_EQUAL(engine.pull(3.0), boost::make_optional(1));
+      BOOST_CHECK_EQUAL(engine.pull(4.0), boost::make_optional(1));
+      BOOST_CHECK_EQUAL(engine.pull(5.0), boost::make_optional(1));
+      BOOST_CHECK_EQUAL(numCalls, 3);
+    }
+
+    // Once the engine is gone, the graph is evaluated at every step again.
+    BOOST_CHECK_EQUAL(counter.pull(6.0), boost::make_optional(1));
+    BOOST_CHECK_EQUAL(counter.pull(7.0), boost::make_optional(1));
+    BOOST_CHECK_EQUAL(numCalls, 5);
+  });
+}
+}
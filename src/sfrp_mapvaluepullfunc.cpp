@@ -1 +1,11 @@
 #include <sfrp/mapvaluepullfunc.hpp>
+
+namespace sfrp {
+MapValuePullFunc_BatchElement::MapValuePullFunc_BatchElement(std::size_t index)
+    : m_index(index) {}
+
+MapValuePullFunc_NodeCollector::MapValuePullFunc_NodeCollector(
+    std::vector<boost::shared_ptr<BehaviorNode>>* nodes,
+    bool* allKnown)
+    : m_nodes(nodes), m_allKnown(allKnown) {}
+}
@@ -3,6 +3,7 @@
 #include <boost/optional.hpp>
 #include <sfrp/mapvaluepullfunc.hpp>
 #include <stest/testcollector.hpp>
+#include <algorithm>  // std::copy
 #include <string>
 
 static void example() {
@@ -22,6 +23,14 @@ static void example() {
   boost::optional<std::string> result = mapValuePullFunc(0.0);
 }
 
+namespace {
+// A value type without a default constructor.
+struct NoDefault {
+  explicit NoDefault(double v) : value(v) {}
+  double value;
+};
+}
+
 namespace sfrp {
 void mapvaluepullfuncTests(stest::TestCollector& col) {
   col.addTest("sfrp_mapvaluepullfunc_misc", []()->void {
@@ -63,5 +72,63 @@ void mapvaluepullfuncTests(stest::TestCollector& col) {
                 boost::make_optional(std::string("31")));
     BOOST_CHECK(mapValuePullFunc(3.0) == boost::none);
   });
+  col.addTest("sfrp_mapvaluepullfunc_pullBatch", []()->void {
+    // Check vectorized evaluation with pure arguments and sequential
+    // evaluation otherwise.
+    Behavior<double> time = sfrp::Behavior<double>::fromValuePullFunc(
+        [](double t) { return boost::make_optional(t); },
+        [](const double* times, std::size_t n, double* out) {
+          std::copy(times, times + n, out);
+          return n;
+        },
+        true);
+    Behavior<int> partial = sfrp::Behavior<int>::fromValuePullFunc(
+        [](double t)->boost::optional<int> {
+          if (t < 2.0)
+            return boost::make_optional(3);
+          else
+            return boost::none;
+        });
+    auto sum = [](double d, int i) { return d + i; };
+    typedef decltype(sum) Sum;
+    auto twice = [](double d) { return d * 2.0; };
+    typedef decltype(twice) Twice;
+
+    const double times[] = {0.0, 1.0, 2.0, 3.0};
+    double values[4];
+
+    MapValuePullFunc<Twice, Behavior<double>> pureFunc(twice, time);
+    BOOST_CHECK(pureFunc.isPure());
+    BOOST_CHECK_EQUAL(pureFunc.pullBatch(times, 4, values), 4u);
+    BOOST_CHECK_EQUAL(values[3], 6.0);
+
+    MapValuePullFunc<Sum, Behavior<double>, Behavior<int>> impureFunc(
+        sum, time, partial);
+    BOOST_CHECK(!impureFunc.isPure());
+    BOOST_CHECK_EQUAL(impureFunc.pullBatch(times, 4, values), 2u);
+    BOOST_CHECK_EQUAL(values[1], 4.0);
+
+    // Buffers are reused by later batches.
+    const double laterTimes[] = {4.0, 5.0};
+    BOOST_CHECK_EQUAL(pureFunc.pullBatch(laterTimes, 2, values), 2u);
+    BOOST_CHECK_EQUAL(values[1], 10.0);
+
+    // Arguments that can't be default constructed are pulled one time at a
+    // time.
+    Behavior<NoDefault> noDefault = Behavior<NoDefault>::fromValuePullFunc(
+        [](double t) { return boost::make_optional(NoDefault(t)); },
+        [](const double* times, std::size_t n, NoDefault* out) {
+          for (std::size_t i = 0; i < n; ++i)
+            out[i] = NoDefault(times[i]);
+          return n;
+        },
+        true);
+    auto get = [](const NoDefault& n) { return n.value; };
+    typedef decltype(get) Get;
+    MapValuePullFunc<Get, Behavior<NoDefault>> noDefaultFunc(get, noDefault);
+    BOOST_CHECK(noDefaultFunc.isPure());
+    BOOST_CHECK_EQUAL(noDefaultFunc.pullBatch(times, 4, values), 4u);
+    BOOST_CHECK_EQUAL(values[3], 3.0);
+  });
 }
 }
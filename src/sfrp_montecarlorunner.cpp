@@ -0,0 +1,46 @@
+#include <sfrp/montecarlorunner.hpp>
+
+namespace sfrp {
+MonteCarloRunner_NodeOwners::MonteCarloRunner_NodeOwners()
+    : m_mutex(), m_owners() {}
+
+bool MonteCarloRunner_NodeOwners::claim(
+    std::size_t index,
+    const std::vector<const BehaviorNode*>& nodes) {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  bool shared = false;
+  for (const BehaviorNode* const node : nodes) {
+    const auto inserted = m_owners.emplace(node, index);
+    if (!inserted.second && inserted.first->second != index)
+      shared = true;
+  }
+  return !shared;
+}
+
+void MonteCarloRunner_NodeOwners::release(
+    std::size_t index,
+    const std::vector<const BehaviorNode*>& nodes) {
+  const std::lock_guard<std::mutex> lock(m_mutex);
+  for (const BehaviorNode* const node : nodes) {
+    const auto owner = m_owners.find(node);
+    if (owner != m_owners.end() && owner->second == index)
+      m_owners.erase(owner);
+  }
+}
+
+MonteCarloRunner::MonteCarloRunner(unsigned numThreads,
+                                   std::size_t arenaBlockSize)
+    : m_pool(numThreads), m_arenaBlockSize(arenaBlockSize) {}
+
+std::size_t MonteCarloRunner::numThreads() const { return m_pool.numThreads(); }
+
+std::vector<const BehaviorNode*> MonteCarloRunner::reachableNodes(
+    const boost::shared_ptr<BehaviorNode>& root) {
+  const BehaviorSchedule_Steps steps(root);
+  std::vector<const BehaviorNode*> nodes;
+  nodes.reserve(steps.size());
+  for (std::size_t i = 0; i < steps.size(); ++i)
+    nodes.push_back(steps.node(i));
+  return nodes;
+}
+}
@@ -0,0 +1,80 @@
+#include <sfrp/montecarlorunner.t.hpp>
+
+#include <boost/optional/optional_io.hpp>
+#include <sfrp/behaviorutil.hpp>
+#include <sfrp/montecarlorunner.hpp>
+#include <sfrp/vectorspaceutil.hpp>
+#include <smisc/point1dvectorspace.hpp>
+#include <stest/testcollector.hpp>
+#include <algorithm>
+#include <stdexcept>  // std::runtime_error
+#include <vector>
+
+namespace sfrp {
+namespace {
+// Return an instance whose value is the specified 'index' times the number of
+// pulls so far and which is undefined from time 'index'.
+Behavior<double> makeInstance(std::size_t index) {
+  const double end = double(index);
+  return BehaviorUtil::curtail(
+      VectorSpaceUtil::sum(BehaviorUtil::always(end)),
+      Behavior<int>::fromValuePullFunc([end](double time) {
+        return time < end ? boost::make_optional(0) : boost::none;
+      }));
+}
+}
+
+void montecarlorunnerTests(stest::TestCollector& col) {
+  col.addTest("sfrp_montecarlorunner_run", []()->void {
+    MonteCarloRunner runner(3);
+    BOOST_CHECK_EQUAL(runner.numThreads(), 3u);
+
+    // Instance 'i' is pulled at '4 * i' times, the last being 'i - 0.25'.
+    const std::vector<boost::optional<double>> results =
+        runner.run<double>(200, &makeInstance, 0.25);
+    BOOST_REQUIRE_EQUAL(results.size(), 200u);
+    BOOST_CHECK(!results[0]);
+    for (std::size_t i = 1; i < results.size(); ++i)
+      BOOST_CHECK_EQUAL(results[i], boost::make_optional(4.0 * i * i));
+
+    // Instances are no longer pulled after the end time.
+    const std::vector<boost::optional<double>> curtailed =
+        runner.run<double>(10, &makeInstance, 0.25, 1.0);
+    BOOST_CHECK_EQUAL(curtailed[1], boost::make_optional(4.0));
+    for (std::size_t i = 2; i < curtailed.size(); ++i)
+      BOOST_CHECK_EQUAL(curtailed[i], boost::make_optional(5.0 * i));
+  });
+  col.addTest("sfrp_montecarlorunner_exception", []()->void {
+    MonteCarloRunner runner(2);
+    bool caught = false;
+    try {
+      runner.run<double>(50, [](std::size_t index) {
+        if (index == 17)
+          throw std::runtime_error("bad scenario");
+        return makeInstance(index % 5);
+      }, 0.5);
+    } catch (const std::runtime_error&) {
+      caught = true;
+    }
+    BOOST_CHECK(caught);
+  });
+  col.addTest("sfrp_montecarlorunner_owners", []()->void {
+    const Behavior<double> shared = BehaviorUtil::always(1.0);
+    const Behavior<double> own = VectorSpaceUtil::sum(shared);
+    const std::vector<const BehaviorNode*> ownNodes =
+        MonteCarloRunner::reachableNodes(own.node());
+    const std::vector<const BehaviorNode*> sharedNodes =
+        MonteCarloRunner::reachableNodes(shared.node());
+    BOOST_REQUIRE_EQUAL(sharedNodes.size(), 1u);
+    BOOST_CHECK(std::find(ownNodes.begin(), ownNodes.end(), sharedNodes[0]) !=
+                ownNodes.end());
+
+    MonteCarloRunner_NodeOwners owners;
+    BOOST_CHECK(owners.claim(0, ownNodes));
+    BOOST_CHECK(owners.claim(0, sharedNodes));
+    BOOST_CHECK(!owners.claim(1, sharedNodes));
+    owners.release(0, ownNodes);
+    BOOST_CHECK(owners.claim(1, sharedNodes));
+  });
+}
+}
@@ -0,0 +1,116 @@
+#include <sfrp/pullthreadpool.hpp>
+
+#include <sfrp/behaviornode.hpp>
+#include <algorithm>  // std::find
+
+namespace sfrp {
+PullThreadPool_Batch::PullThreadPool_Batch(
+    const std::vector<boost::function<void()>>& tasks)
+    : m_tasks(tasks), m_next(0), m_numFinished(0), m_exception() {}
+
+bool PullThreadPool_Batch::claim(std::size_t* index) {
+  *index = m_next++;
+  return *index < m_tasks.size();
+}
+
+void PullThreadPool_Batch::run(std::size_t index) {
+  std::exception_ptr exception;
+  try {
+    const BehaviorNodeExclusiveScope exclusiveScope;
+    m_tasks[index]();
+  } catch (...) {
+    exception = std::current_exception();
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (exception && !m_exception)
+    m_exception = exception;
+  if (++m_numFinished == m_tasks.size())
+    m_finished.notify_all();
+}
+
+bool PullThreadPool_Batch::runOne() {
+  std::size_t index;
+  if (!claim(&index))
+    return false;
+  run(index);
+  return true;
+}
+
+void PullThreadPool_Batch::wait() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_finished.wait(lock, [this]() { return m_numFinished == m_tasks.size(); });
+  if (m_exception)
+    std::rethrow_exception(m_exception);
+}
+
+PullThreadPool::PullThreadPool(unsigned numThreads)
+    : m_mutex(), m_published(), m_batches(), m_stopped(false), m_threads() {
+  for (unsigned i = 0; i < numThreads; ++i)
+    m_threads.emplace_back([this]() { work(); });
+}
+
+PullThreadPool::~PullThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stopped = true;
+  }
+  m_published.notify_all();
+  for (std::thread& thread : m_threads)
+    thread.join();
+}
+
+void PullThreadPool::run(const std::vector<boost::function<void()>>& tasks) {
+  if (tasks.empty())
+    return;
+
+  PullThreadPool_Batch batch(tasks);
+  if (tasks.size() > 1 && !m_threads.empty()) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_batches.push_back(&batch);
+    }
+    m_published.notify_all();
+  }
+
+  while (batch.runOne()) {
+  }
+
+  // The batch must be unpublished before it goes out of scope. Pool threads
+  // only claim tasks of published batches.
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const auto i = std::find(m_batches.begin(), m_batches.end(), &batch);
+    if (i != m_batches.end())
+      m_batches.erase(i);
+  }
+  batch.wait();
+}
+
+std::size_t PullThreadPool::numThreads() const { return m_threads.size(); }
+
+void PullThreadPool::work() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  for (;;) {
+    m_published.wait(lock,
+                     [this]() { return m_stopped || !m_batches.empty(); });
+    if (m_stopped)
+      return;
+
+    // Take a task of the most recently published batch. It is the most
+    // deeply nested one and its tasks hold up all of the others.
+    PullThreadPool_Batch* const batch = m_batches.back();
+    std::size_t index;
+    if (!batch->claim(&index)) {
+      m_batches.pop_back();
+      continue;
+    }
+
+    // A batch is unpublished before its submitter waits for its claimed tasks
+    // to finish, so it remains valid while this thread runs the task.
+    lock.unlock();
+    batch->run(index);
+    lock.lock();
+  }
+}
+}
@@ -0,0 +1,81 @@
+#include <sfrp/pullthreadpool.t.hpp>
+
+#include <sfrp/behaviornode.hpp>
+#include <sfrp/pullthreadpool.hpp>
+#include <stest/testcollector.hpp>
+#include <atomic>
+#include <stdexcept>  // std::runtime_error
+#include <vector>
+
+namespace sfrp {
+void pullthreadpoolTests(stest::TestCollector& col) {
+  col.addTest("sfrp_pullthreadpool_run", []()->void {
+    PullThreadPool pool(3);
+    BOOST_CHECK_EQUAL(pool.numThreads(), 3u);
+
+    std::vector<int> results(100, 0);
+    std::vector<boost::function<void()>> tasks;
+    for (int i = 0; i < 100; ++i)
+      tasks.push_back([&results, i]() { results[i] = i * i; });
+    pool.run(tasks);
+    for (int i = 0; i < 100; ++i)
+      BOOST_CHECK_EQUAL(results[i], i * i);
+
+    // A pool without threads runs the tasks on the calling thread.
+    PullThreadPool emptyPool(0);
+    std::vector<int> results2(2, 0);
+    std::vector<boost::function<void()>> tasks2;
+    tasks2.push_back([&results2]() { results2[0] = 1; });
+    tasks2.push_back([&results2]() { results2[1] = 2; });
+    emptyPool.run(tasks2);
+    BOOST_CHECK_EQUAL(results2[0], 1);
+    BOOST_CHECK_EQUAL(results2[1], 2);
+  });
+  col.addTest("sfrp_pullthreadpool_nested", []()->void {
+    // Nested batches complete even when there are more of them than threads.
+    PullThreadPool pool(2);
+    std::atomic<int> count(0);
+    std::vector<boost::function<void()>> tasks;
+    for (int i = 0; i < 8; ++i) {
+      tasks.push_back([&pool, &count]() {
+        std::vector<boost::function<void()>> innerTasks;
+        for (int j = 0; j < 8; ++j)
+          innerTasks.push_back([&count]() { ++count; });
+        pool.run(innerTasks);
+      });
+    }
+    pool.run(tasks);
+    BOOST_CHECK_EQUAL(count.load(), 64);
+  });
+  col.addTest("sfrp_pullthreadpool_exclusive", []()->void {
+    // Tasks don't inherit the concurrency scope of the thread running them.
+    PullThreadPool pool(2);
+    std::atomic<int> numConcurrent(0);
+    std::vector<boost::function<void()>> tasks(
+        8, [&numConcurrent]() {
+          if (BehaviorNodeConcurrencyScope::isActive())
+            ++numConcurrent;
+        });
+    {
+      const BehaviorNodeConcurrencyScope concurrencyScope;
+      pool.run(tasks);
+      BOOST_CHECK(BehaviorNodeConcurrencyScope::isActive());
+    }
+    BOOST_CHECK_EQUAL(numConcurrent.load(), 0);
+  });
+  col.addTest("sfrp_pullthreadpool_exception", []()->void {
+    PullThreadPool pool(2);
+    std::atomic<int> count(0);
+    std::vector<boost::function<void()>> tasks;
+    for (int i = 0; i < 4; ++i) {
+      tasks.push_back([&count, i]() {
+        ++count;
+        if (i == 2)
+          throw std::runtime_error("failed pull");
+      });
+    }
+    BOOST_CHECK_THROW(pool.run(tasks), std::runtime_error);
+    BOOST_CHECK_EQUAL(count.load(), 4);
+  });
+}
+}
@@ -0,0 +1 @@
+#include <sfrp/sparseevent.hpp>
@@ -0,0 +1,87 @@
+#include <sfrp/sparseevent.t.hpp>
+
+#include <boost/optional/optional_io.hpp>
+#include <sfrp/behavior.hpp>
+#include <sfrp/sparseevent.hpp>
+#include <stest/testcollector.hpp>
+#include <cmath>  // std::floor
+#include <limits>
+#include <memory>  // std::make_shared
+
+namespace sfrp {
+void sparseeventTests(stest::TestCollector& col) {
+  col.addTest("sfrp_sparseevent_never", []()->void {
+    const SparseEvent<int> never;
+    BOOST_CHECK_EQUAL(never.pull(0.0),
+                      boost::make_optional(boost::optional<int>()));
+    BOOST_CHECK_EQUAL(never.pull(1.0),
+                      boost::make_optional(boost::optional<int>()));
+    BOOST_CHECK_EQUAL(never.nextOccurrence(1.0),
+                      std::numeric_limits<double>::infinity());
+    BOOST_CHECK(!never.isPending());
+  });
+  col.addTest("sfrp_sparseevent_skipping", []()->void {
+    // 'whole' occurs at the first pull of every unit interval.
+    auto numPulls = std::make_shared<int>(0);
+    auto lastInterval = std::make_shared<double>(-1.0);
+    const Behavior<boost::optional<int>> whole =
+        Behavior<boost::optional<int>>::fromValuePullFunc(
+            [numPulls, lastInterval](double time) {
+              ++*numPulls;
+              const double interval = std::floor(time);
+              if (interval <= *lastInterval)
+                return boost::make_optional(boost::optional<int>());
+              *lastInterval = interval;
+              return boost::make_optional(boost::make_optional(int(time)));
+            });
+    const SparseEvent<int> sparse(
+        whole, [](double time) { return std::floor(time) + 1.0; });
+
+    for (int i = 0; i < 40; ++i) {
+      const double time = i * 0.25;
+      BOOST_CHECK_EQUAL(
+          sparse.pull(time),
+          boost::make_optional(i % 4 == 0 ? boost::make_optional(i / 4)
+                                          : boost::optional<int>()));
+    }
+    BOOST_CHECK_EQUAL(*numPulls, 10);
+    BOOST_CHECK_EQUAL(sparse.nextOccurrence(9.75), 10.0);
+
+    // The skipping behavior is shared by all copies.
+    const Behavior<boost::optional<int>> behavior = sparse;
+    BOOST_CHECK(behavior.node() == sparse.toBehavior().node());
+  });
+  col.addTest("sfrp_sparseevent_pending", []()->void {
+    auto numPulls = std::make_shared<int>(0);
+    auto pending = std::make_shared<bool>(false);
+    const SparseEvent<int> sparse(
+        Behavior<boost::optional<int>>::fromValuePullFunc(
+            [numPulls, pending](double time) {
+              ++*numPulls;
+              const bool occurs = *pending;
+              *pending = false;
+              return boost::make_optional(occurs ? boost::make_optional(1)
+                                                 : boost::optional<int>());
+            }),
+        boost::function<double(double)>(),
+        [pending]() { return *pending; });
+    BOOST_CHECK_EQUAL(sparse.toBehavior().node()->changeMode(),
+                      BehaviorNode::e_POLLED);
+
+    // The first pull is never skipped.
+    BOOST_CHECK_EQUAL(sparse.pull(0.0),
+                      boost::make_optional(boost::optional<int>()));
+    BOOST_CHECK_EQUAL(sparse.pull(1.0),
+                      boost::make_optional(boost::optional<int>()));
+    BOOST_CHECK_EQUAL(*numPulls, 1);
+
+    *pending = true;
+    BOOST_CHECK(sparse.isPending());
+    BOOST_CHECK_EQUAL(sparse.pull(2.0),
+                      boost::make_optional(boost::make_optional(1)));
+    BOOST_CHECK_EQUAL(sparse.pull(3.0),
+                      boost::make_optional(boost::optional<int>()));
+    BOOST_CHECK_EQUAL(*numPulls, 2);
+  });
+}
+}
@@ -0,0 +1,25 @@
+#include <sfrp/sparseeventutil.hpp>
+
+namespace sfrp {
+boost::function<double(double)> SparseEventUtil::earliest(
+    const boost::function<double(double)>& leftFunc,
+    const boost::function<double(double)>& rightFunc) {
+  if (!leftFunc)
+    return rightFunc;
+  if (!rightFunc)
+    return leftFunc;
+  return [leftFunc, rightFunc](double time) {
+    return std::min(leftFunc(time), rightFunc(time));
+  };
+}
+
+boost::function<bool()> SparseEventUtil::either(
+    const boost::function<bool()>& leftFunc,
+    const boost::function<bool()>& rightFunc) {
+  if (!leftFunc)
+    return rightFunc;
+  if (!rightFunc)
+    return leftFunc;
+  return [leftFunc, rightFunc]() { return leftFunc() || rightFunc(); };
+}
+}
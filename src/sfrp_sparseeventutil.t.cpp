@@ -0,0 +1,85 @@
+#include <sfrp/sparseeventutil.t.hpp>
+
+#include <boost/optional/optional_io.hpp>
+#include <sfrp/behaviorutil.hpp>
+#include <sfrp/incrementalengine.hpp>
+#include <sfrp/sparseeventutil.hpp>
+#include <stest/testcollector.hpp>
+#include <memory>  // std::make_shared
+#include <string>
+#include <utility>  // std::make_pair
+
+namespace sfrp {
+void sparseeventutilTests(stest::TestCollector& col) {
+  col.addTest("sfrp_sparseeventutil_periodic", []()->void {
+    const SparseEvent<int> every2 = SparseEventUtil::periodic(2.0, 7);
+    BOOST_CHECK_EQUAL(every2.pull(0.0),
+                      boost::make_optional(boost::make_optional(7)));
+    BOOST_CHECK_EQUAL(every2.pull(1.0),
+                      boost::make_optional(boost::optional<int>()));
+    BOOST_CHECK_EQUAL(every2.pull(2.5),
+                      boost::make_optional(boost::make_optional(7)));
+    BOOST_CHECK_EQUAL(every2.pull(3.5),
+                      boost::make_optional(boost::optional<int>()));
+    BOOST_CHECK_EQUAL(every2.nextOccurrence(3.5), 4.0);
+  });
+  col.addTest("sfrp_sparseeventutil_combinators", []()->void {
+    auto numCalls = std::make_shared<int>(0);
+    const auto trigger = SparseEventUtil::trigger<int>();
+    const SparseEvent<std::string> strings = SparseEventUtil::map(
+        [numCalls](int i) {
+          ++*numCalls;
+          return std::to_string(i);
+        },
+        SparseEventUtil::filter([](int i) { return i > 0; }, trigger.first));
+    const SparseEvent<std::string> merged = SparseEventUtil::merge(
+        strings, SparseEventUtil::periodic(10.0, std::string("tick")));
+    const SparseEvent<std::pair<std::string, double>> snapshots =
+        SparseEventUtil::snapshot(BehaviorUtil::time(), merged);
+
+    typedef boost::optional<std::pair<std::string, double>> Occurrence;
+    BOOST_CHECK(snapshots.pull(0.0) ==
+                boost::make_optional(
+                    Occurrence(std::make_pair(std::string("tick"), 0.0))));
+    BOOST_CHECK(snapshots.pull(1.0) == boost::make_optional(Occurrence()));
+    BOOST_CHECK_EQUAL(snapshots.nextOccurrence(1.0), 10.0);
+
+    trigger.second(3);
+    BOOST_CHECK(snapshots.isPending());
+    BOOST_CHECK(snapshots.pull(2.0) ==
+                boost::make_optional(
+                    Occurrence(std::make_pair(std::string("3"), 2.0))));
+    trigger.second(-3);
+    BOOST_CHECK(snapshots.pull(3.0) == boost::make_optional(Occurrence()));
+    BOOST_CHECK(snapshots.pull(10.0) ==
+                boost::make_optional(
+                    Occurrence(std::make_pair(std::string("tick"), 10.0))));
+
+    // The mapping only ran for the occurrences that passed the filter.
+    for (int i = 11; i < 20; ++i)
+      BOOST_CHECK(snapshots.pull(i) == boost::make_optional(Occurrence()));
+    BOOST_CHECK_EQUAL(*numCalls, 1);
+  });
+  col.addTest("sfrp_sparseeventutil_incremental", []()->void {
+    // A trigger-only sparse event is skipped by an incremental engine.
+    auto numCalls = std::make_shared<int>(0);
+    const auto trigger = SparseEventUtil::trigger<int>();
+    const Behavior<int> latest = BehaviorUtil::map(
+        [numCalls](const boost::optional<int>& occurrence) {
+          ++*numCalls;
+          return occurrence ? *occurrence : -1;
+        },
+        SparseEventUtil::map([](int i) { return i * 2; }, trigger.first)
+            .toBehavior());
+    IncrementalEngine<int> engine(latest);
+    BOOST_CHECK_EQUAL(engine.pull(0.0), boost::make_optional(-1));
+    BOOST_CHECK_EQUAL(engine.pull(1.0), boost::make_optional(-1));
+    BOOST_CHECK_EQUAL(*numCalls, 1);
+    trigger.second(4);
+    BOOST_CHECK_EQUAL(engine.pull(2.0), boost::make_optional(8));
+    BOOST_CHECK_EQUAL(engine.pull(3.0), boost::make_optional(-1));
+    BOOST_CHECK_EQUAL(engine.pull(4.0), boost::make_optional(-1));
+    BOOST_CHECK_EQUAL(*numCalls, 3);
+  });
+}
+}
@@ -0,0 +1 @@
+#include <sfrp/staticbehavior.hpp>
@@ -0,0 +1,53 @@
+#include <sfrp/staticbehavior.t.hpp>
+
+#include <boost/optional/optional_io.hpp>
+#include <sfrp/behaviormap.hpp>
+#include <sfrp/staticbehavior.hpp>
+#include <sfrp/staticbehaviorutil.hpp>
+#include <stest/testcollector.hpp>
+#include <cmath>  // std::sin
+#include <functional>  // std::function
+
+namespace {
+void example1() {
+  auto twiceTime = sfrp::StaticBehaviorUtil::map(
+      [](double t) { return 2.0 * t; }, sfrp::StaticBehaviorUtil::time());
+  auto sinTwiceTime = sfrp::StaticBehaviorUtil::map(
+      [](double t) { return std::sin(t); }, twiceTime);
+  boost::optional<double> value = sinTwiceTime.pull(1.0);
+  sfrp::Behavior<double> sinTwiceTimeBehavior = sinTwiceTime;
+}
+}
+
+namespace sfrp {
+void staticbehaviorTests(stest::TestCollector& col) {
+  col.addTest("sfrp_staticbehavior_pull", []()->void {
+    int numCalls = 0;
+    auto counting = [&numCalls](double t)->boost::optional<double> {
+      ++numCalls;
+      return t < 2.0 ? boost::make_optional(t) : boost::none;
+    };
+    sfrp::StaticBehavior<std::function<boost::optional<double>(double)>> b(
+        counting);
+    BOOST_CHECK_EQUAL(b.pull(0.0), boost::make_optional(0.0));
+    BOOST_CHECK_EQUAL(b.pull(1.0), boost::make_optional(1.0));
+    BOOST_CHECK_EQUAL(b.pull(2.0), boost::none);
+    BOOST_CHECK_EQUAL(numCalls, 3);
+  });
+  col.addTest("sfrp_staticbehavior_toBehavior", []()->void {
+    sfrp::Behavior<double> b = sfrp::StaticBehaviorUtil::map(
+        [](double t) { return t * 3.0; }, sfrp::StaticBehaviorUtil::time());
+    BOOST_CHECK_EQUAL(b.pull(0.0), boost::make_optional(0.0));
+    BOOST_CHECK_EQUAL(b.pull(1.0), boost::make_optional(3.0));
+    BOOST_CHECK_EQUAL(b.pull(1.0), boost::make_optional(3.0));
+  });
+  col.addTest("sfrp_staticbehavior_behaviorMapArgument", []()->void {
+    sfrp::Behavior<double> b =
+        sfrp::BehaviorMap()([](double a, double t) { return a + t; },
+                            sfrp::StaticBehaviorUtil::always(1.0),
+                            sfrp::StaticBehaviorUtil::time());
+    BOOST_CHECK_EQUAL(b.pull(0.0), boost::make_optional(1.0));
+    BOOST_CHECK_EQUAL(b.pull(2.0), boost::make_optional(3.0));
+  });
+}
+}
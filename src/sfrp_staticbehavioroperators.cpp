@@ -0,0 +1 @@
+#include <sfrp/staticbehavioroperators.hpp>
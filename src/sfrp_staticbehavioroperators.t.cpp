@@ -0,0 +1,55 @@
+#include <sfrp/staticbehavioroperators.t.hpp>
+
+#include <boost/optional/optional_io.hpp>
+#include <sfrp/staticbehavioroperators.hpp>
+#include <sfrp/staticbehaviorutil.hpp>
+#include <stest/testcollector.hpp>
+
+static void example1() {
+  sfrp::Behavior<double> c = sfrp::StaticBehaviorUtil::time() +
+                             sfrp::StaticBehaviorUtil::always(1.0);
+}
+
+namespace sfrp {
+void staticbehavioroperatorsTests(stest::TestCollector& col) {
+  col.addTest("sfrp_staticbehavioroperators_arithmetic", []()->void {
+    auto minus = sfrp::StaticBehaviorUtil::time() -
+                 sfrp::StaticBehaviorUtil::always(1.0);
+    BOOST_CHECK_EQUAL(minus.pull(0.0), boost::make_optional(-1.0));
+    BOOST_CHECK_EQUAL(minus.pull(2.0), boost::make_optional(1.0));
+
+    auto plus = sfrp::StaticBehaviorUtil::time() +
+                sfrp::StaticBehaviorUtil::always(1.0);
+    BOOST_CHECK_EQUAL(plus.pull(0.0), boost::make_optional(1.0));
+    BOOST_CHECK_EQUAL(plus.pull(2.0), boost::make_optional(3.0));
+
+    auto negate = -sfrp::StaticBehaviorUtil::time();
+    BOOST_CHECK_EQUAL(negate.pull(1.0), boost::make_optional(-1.0));
+  });
+  col.addTest("sfrp_staticbehavioroperators_logical", []()->void {
+    auto afterOne = sfrp::StaticBehaviorUtil::pure([](double time) {
+      return time < 1.0 ? false : true;
+    });
+    auto afterHalf = sfrp::StaticBehaviorUtil::pure([](double time) {
+      return time < 0.5 ? false : true;
+    });
+    auto logicalAnd = afterOne && afterHalf;
+    auto logicalOr = afterOne || afterHalf;
+    auto logicalNot = !afterOne;
+    BOOST_CHECK(logicalAnd.pull(0.6) == boost::make_optional(false));
+    BOOST_CHECK(logicalAnd.pull(1.6) == boost::make_optional(true));
+    BOOST_CHECK(logicalOr.pull(0.6) == boost::make_optional(true));
+    BOOST_CHECK(logicalNot.pull(0.6) == boost::make_optional(true));
+  });
+  col.addTest("sfrp_staticbehavioroperators_ifThenElse", []()->void {
+    auto ifThenElse = sfrp::StaticBehaviorOperators::ifThenElse(
+        sfrp::StaticBehaviorUtil::pure([](double time) {
+          return time < 1.0 ? false : true;
+        }),
+        sfrp::StaticBehaviorUtil::always(3),
+        sfrp::StaticBehaviorUtil::always(4));
+    BOOST_CHECK(ifThenElse.pull(0.0) == boost::make_optional(4));
+    BOOST_CHECK(ifThenElse.pull(1.6) == boost::make_optional(3));
+  });
+}
+}
@@ -0,0 +1 @@
+#include <sfrp/staticbehaviorutil.hpp>
@@ -0,0 +1,62 @@
+#include <sfrp/staticbehaviorutil.t.hpp>
+
+#include <boost/optional/optional_io.hpp>
+#include <sfrp/behavior.hpp>
+#include <sfrp/behaviorutil.hpp>
+#include <sfrp/staticbehaviorutil.hpp>
+#include <stest/testcollector.hpp>
+#include <cmath>  // std::sin
+
+namespace {
+sfrp::Behavior<double> oscillator(sfrp::Behavior<double> amplitude,
+                                  double frequency) {
+  return sfrp::StaticBehaviorUtil::map(
+      [](double a, double s) { return a * s; },
+      sfrp::StaticBehaviorUtil::fromBehavior(amplitude),
+      sfrp::StaticBehaviorUtil::pure(
+          [frequency](double t) { return std::sin(frequency * t); }));
+}
+}
+
+namespace sfrp {
+void staticbehaviorutilTests(stest::TestCollector& col) {
+  col.addTest("sfrp_staticbehaviorutil_always", []()->void {
+    auto always3 = sfrp::StaticBehaviorUtil::always(3);
+    BOOST_CHECK_EQUAL(always3.pull(0.0), boost::make_optional(3));
+    BOOST_CHECK_EQUAL(always3.pull(1.0), boost::make_optional(3));
+  });
+  col.addTest("sfrp_staticbehaviorutil_time", []()->void {
+    auto time = sfrp::StaticBehaviorUtil::time();
+    BOOST_CHECK_EQUAL(time.pull(0.0), boost::make_optional(0.0));
+    BOOST_CHECK_EQUAL(time.pull(2.0), boost::make_optional(2.0));
+  });
+  col.addTest("sfrp_staticbehaviorutil_pure", []()->void {
+    auto pure =
+        sfrp::StaticBehaviorUtil::pure([](double time) { return time * 2.0; });
+    BOOST_CHECK_EQUAL(pure.pull(0.0), boost::make_optional(0.0));
+    BOOST_CHECK_EQUAL(pure.pull(1.0), boost::make_optional(2.0));
+  });
+  col.addTest("sfrp_staticbehaviorutil_fromBehavior", []()->void {
+    auto b = sfrp::StaticBehaviorUtil::fromBehavior(
+        sfrp::Behavior<int>::fromValuePullFunc([](double time) {
+          return time < 1.0 ? boost::make_optional(1) : boost::none;
+        }));
+    BOOST_CHECK_EQUAL(b.pull(0.0), boost::make_optional(1));
+    BOOST_CHECK_EQUAL(b.pull(1.0), boost::none);
+    BOOST_CHECK_EQUAL(b.pull(2.0), boost::none);
+  });
+  col.addTest("sfrp_staticbehaviorutil_map", []()->void {
+    auto mapped = sfrp::StaticBehaviorUtil::map(
+        [](double a, double b) { return a + b; },
+        sfrp::StaticBehaviorUtil::always(1.0),
+        sfrp::StaticBehaviorUtil::time());
+    BOOST_CHECK_EQUAL(mapped.pull(0.0), boost::make_optional(1.0));
+    BOOST_CHECK_EQUAL(mapped.pull(3.0), boost::make_optional(4.0));
+
+    sfrp::Behavior<double> osc =
+        oscillator(sfrp::BehaviorUtil::always(2.0), 1.0);
+    BOOST_CHECK_EQUAL(osc.pull(0.0), boost::make_optional(0.0));
+    BOOST_CHECK_CLOSE(*osc.pull(1.0), 2.0 * std::sin(1.0), 1e-9);
+  });
+}
+}
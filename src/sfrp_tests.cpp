@@ -1,40 +1,80 @@
 #include <sfrp/tests.hpp>
 
 #include <sfrp/behavior.t.hpp>
+#include <sfrp/behaviorarray.t.hpp>
+#include <sfrp/behaviorcheckpoint.t.hpp>
 #include <sfrp/behaviordebugutil.t.hpp>
+#include <sfrp/behaviordriver.t.hpp>
+#include <sfrp/behaviorgrapharena.t.hpp>
+#include <sfrp/behaviorhashcons.t.hpp>
 #include <sfrp/behaviormap.t.hpp>
+#include <sfrp/behaviornode.t.hpp>
 #include <sfrp/behavioroperators.t.hpp>
 #include <sfrp/behaviorpairutil.t.hpp>
+#include <sfrp/behaviorprofiler.t.hpp>
 #include <sfrp/behaviorpuller.t.hpp>
+#include <sfrp/behaviorschedule.t.hpp>
 #include <sfrp/behaviortimeutil.t.hpp>
 #include <sfrp/behaviorutil.t.hpp>
 #include <sfrp/cachedincreasingpartialtimefunction.t.hpp>
 #include <sfrp/eventdebugutil.t.hpp>
 #include <sfrp/eventmap.t.hpp>
 #include <sfrp/eventmapfunctionadapter.t.hpp>
+#include <sfrp/eventrecorder.t.hpp>
 #include <sfrp/eventutil.t.hpp>
+#include <sfrp/graphpointer.t.hpp>
 #include <sfrp/increasingpartialtimefunction.t.hpp>
+#include <sfrp/incrementalengine.t.hpp>
+#include <sfrp/montecarlorunner.t.hpp>
 #include <sfrp/normedvectorspaceutil.t.hpp>
+#include <sfrp/pullthreadpool.t.hpp>
+#include <sfrp/sparseevent.t.hpp>
+#include <sfrp/sparseeventutil.t.hpp>
+#include <sfrp/staticbehavior.t.hpp>
+#include <sfrp/staticbehavioroperators.t.hpp>
+#include <sfrp/staticbehaviorutil.t.hpp>
+#include <sfrp/timestampedtrigger.t.hpp>
+#include <sfrp/triggerqueue.t.hpp>
 #include <sfrp/vectorspaceutil.t.hpp>
 #include <sfrp/wormhole.t.hpp>
 
 namespace sfrp {
 void tests( stest::TestCollector & col ) {
   behaviorTests( col );
+  behaviorarrayTests( col );
+  behaviorcheckpointTests( col );
   behaviordebugutilTests( col );
+  behaviordriverTests( col );
+  behaviorgrapharenaTests( col );
+  behaviorhashconsTests( col );
   behaviormapTests( col );
+  behaviornodeTests( col );
   behavioroperatorsTests( col );
   behaviorpairutilTests( col );
+  behaviorprofilerTests( col );
   behaviorpullerTests( col );
+  behaviorscheduleTests( col );
   behaviortimeutilTests( col );
   behaviorutilTests( col );
   eventdebugutilTests( col );
   eventmapTests( col );
   eventmapfunctionadapterTests( col );
+  eventrecorderTests( col );
   eventutilTests( col );
   cachedincreasingpartialtimefunctionTests( col );
+  graphpointerTests( col );
   increasingpartialtimefunctionTests( col );
+  incrementalengineTests( col );
+  montecarlorunnerTests( col );
   normedvectorspaceutilTests( col );
+  pullthreadpoolTests( col );
+  sparseeventTests( col );
+  sparseeventutilTests( col );
+  staticbehaviorTests( col );
+  staticbehavioroperatorsTests( col );
+  staticbehaviorutilTests( col );
+  timestampedtriggerTests( col );
+  triggerqueueTests( col );
   vectorspaceutilTests( col );
   wormholeTests( col );
 }
@@ -0,0 +1 @@
+#include <sfrp/timestampedtrigger.hpp>
@@ -0,0 +1,64 @@
+#include <sfrp/timestampedtrigger.t.hpp>
+
+#include <sfrp/incrementalengine.hpp>
+#include <sfrp/timestampedtrigger.hpp>
+#include <sfrp/triggerutil.hpp>
+#include <stest/testcollector.hpp>
+#include <vector>
+
+namespace sfrp {
+void timestampedtriggerTests(stest::TestCollector& col) {
+  typedef TimestampedTrigger<int>::Occurrence Occurrence;
+  typedef boost::optional<std::vector<Occurrence>> Batch;
+  col.addTest("sfrp_timestampedtrigger_ordering", []()->void {
+    TimestampedTrigger<int> trigger;
+    BOOST_CHECK(trigger.pullVal(0.0) == boost::make_optional(Batch()));
+
+    // Occurrences are delivered in time order at the first pull at or after
+    // their time.
+    trigger.loadVal(2.5, 3);
+    trigger.loadVal(1.2, 1);
+    trigger.loadVal(1.7, 2);
+    BOOST_CHECK(trigger.changed());
+    BOOST_CHECK(trigger.pullVal(1.0) == boost::make_optional(Batch()));
+    BOOST_CHECK(trigger.pullVal(2.0) ==
+                boost::make_optional(Batch(std::vector<Occurrence>{
+                    Occurrence(1.2, 1), Occurrence(1.7, 2)})));
+    BOOST_CHECK(trigger.changed());
+    BOOST_CHECK(trigger.pullVal(3.0) ==
+                boost::make_optional(
+                    Batch(std::vector<Occurrence>{Occurrence(2.5, 3)})));
+    BOOST_CHECK(trigger.pullVal(4.0) == boost::make_optional(Batch()));
+    BOOST_CHECK(!trigger.changed());
+
+    // An occurrence before the watermark is delivered by the next pull.
+    trigger.loadVal(3.5, 4);
+    BOOST_CHECK(trigger.pullVal(5.0) ==
+                boost::make_optional(
+                    Batch(std::vector<Occurrence>{Occurrence(3.5, 4)})));
+    BOOST_CHECK_EQUAL(trigger.numLate(), 1u);
+
+    // The end follows the occurrences loaded before it.
+    trigger.loadVal(5.5, 5);
+    trigger.loadEnd();
+    BOOST_CHECK(trigger.pullVal(6.0) ==
+                boost::make_optional(
+                    Batch(std::vector<Occurrence>{Occurrence(5.5, 5)})));
+    BOOST_CHECK(!trigger.pullVal(7.0));
+  });
+  col.addTest("sfrp_timestampedtrigger_lateness", []()->void {
+    // With an allowed lateness, occurrences reported late are still
+    // delivered in time order.
+    const auto trigger = TriggerUtil::timestampedTrigger<int>(1.0);
+    IncrementalEngine<Batch> engine(trigger.first);
+    trigger.second(1.5, 2);
+    BOOST_CHECK(engine.pull(2.0) == boost::make_optional(Batch()));
+    trigger.second(1.2, 1);
+    BOOST_CHECK(engine.pull(3.0) ==
+                boost::make_optional(Batch(std::vector<Occurrence>{
+                    Occurrence(1.2, 1), Occurrence(1.5, 2)})));
+    BOOST_CHECK(engine.pull(4.0) == boost::make_optional(Batch()));
+    BOOST_CHECK(engine.pull(5.0) == boost::make_optional(Batch()));
+  });
+}
+}
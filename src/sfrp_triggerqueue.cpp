@@ -0,0 +1 @@
+#include <sfrp/triggerqueue.hpp>
@@ -0,0 +1,88 @@
+#include <sfrp/triggerqueue.t.hpp>
+
+#include <boost/optional/optional_io.hpp>
+#include <sfrp/incrementalengine.hpp>
+#include <sfrp/triggerqueue.hpp>
+#include <sfrp/triggerutil.hpp>
+#include <stest/testcollector.hpp>
+#include <thread>
+#include <vector>
+
+namespace sfrp {
+void triggerqueueTests(stest::TestCollector& col) {
+  col.addTest("sfrp_triggerqueue_batches", []()->void {
+    typedef boost::optional<std::vector<int>> Occurrence;
+    TriggerQueue<int> queue(3);
+    BOOST_CHECK_EQUAL(queue.capacity(), 4u);
+    BOOST_CHECK(!queue.changed());
+    BOOST_CHECK(queue.pullVal(0.0) == boost::make_optional(Occurrence()));
+
+    // Every value loaded between pulls is delivered in loading order.
+    queue.loadVal(1);
+    queue.loadVal(2);
+    queue.loadVal(3);
+    BOOST_CHECK(queue.changed());
+    BOOST_CHECK(queue.pullVal(1.0) ==
+                boost::make_optional(Occurrence(std::vector<int>{1, 2, 3})));
+    BOOST_CHECK(queue.changed());
+    BOOST_CHECK(queue.pullVal(2.0) == boost::make_optional(Occurrence()));
+    BOOST_CHECK(!queue.changed());
+
+    // A full queue refuses values until the next pull.
+    for (int i = 0; i < 4; ++i)
+      BOOST_CHECK(queue.tryLoadVal(i));
+    BOOST_CHECK(!queue.tryLoadVal(4));
+    BOOST_CHECK(queue.pullVal(3.0) ==
+                boost::make_optional(
+                    Occurrence(std::vector<int>{0, 1, 2, 3})));
+
+    // Values loaded before the end are delivered before the end.
+    queue.loadVal(5);
+    queue.loadVal(boost::none);
+    queue.loadVal(6);
+    BOOST_CHECK(queue.pullVal(4.0) ==
+                boost::make_optional(Occurrence(std::vector<int>{5})));
+    BOOST_CHECK(!queue.pullVal(5.0));
+  });
+  col.addTest("sfrp_triggerqueue_producers", []()->void {
+    // No values are lost when many threads load values while the graph is
+    // pulled.
+    const int numThreads = 4;
+    const int numValues = 10000;
+    const auto trigger = TriggerUtil::queuedTrigger<int>(64);
+    IncrementalEngine<boost::optional<std::vector<int>>> engine(trigger.first);
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < numThreads; ++t) {
+      producers.emplace_back([&trigger, t]() {
+        for (int i = 0; i < numValues; ++i)
+          trigger.second(boost::make_optional(t * numValues + i));
+      });
+    }
+
+    std::vector<int> lastValues(numThreads, -1);
+    int numReceived = 0;
+    double time = 0.0;
+    while (numReceived < numThreads * numValues) {
+      const boost::optional<boost::optional<std::vector<int>>> batch =
+          engine.pull(time);
+      time += 1.0;
+      BOOST_REQUIRE(batch);
+      if (!*batch)
+        continue;
+      for (int value : **batch) {
+        // Values of a single producer arrive in order.
+        BOOST_CHECK_GT(value, lastValues[value / numValues]);
+        lastValues[value / numValues] = value;
+        ++numReceived;
+      }
+    }
+    for (std::thread& producer : producers)
+      producer.join();
+    BOOST_CHECK_EQUAL(numReceived, numThreads * numValues);
+
+    trigger.second(boost::none);
+    BOOST_CHECK(!engine.pull(time));
+  });
+}
+}
@@ -1,10 +1,18 @@
 #include <sfrp/vectorspaceutil.t.hpp>
 
+#include <boost/function.hpp>
+#include <boost/optional.hpp>
+#include <sfrp/behaviormap.hpp>
 #include <sfrp/behavioroperators.hpp>
 #include <sfrp/behaviorutil.hpp>
 #include <sfrp/vectorspaceutil.hpp>
+#include <smisc/point1dnormedvectorspace.hpp>
 #include <smisc/point1dvectorspace.hpp>
 #include <stest/testcollector.hpp>
+#include <cmath>
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::uint64_t
+#include <utility>  // std::pair
 
 static sfrp::Behavior<double> calculatePosition(
     double initialPosition,
@@ -34,5 +42,96 @@ void vectorspaceutilTests(stest::TestCollector& col)
     BOOST_CHECK_EQUAL(bIntegrated.pull(1.0), 1.0);
     BOOST_CHECK_EQUAL(bIntegrated.pull(2.0), 3.0);
   });
+  col.addTest("sfrp_vectorspaceutil_integral_rules", []()->void {
+    const Behavior<double> linear =
+        sfrp::BehaviorUtil::pure([](double time) { return time; });
+    const Behavior<double> trapezoid =
+        sfrp::VectorSpaceUtil::integral(linear, VectorSpaceUtil::e_TRAPEZOID);
+    BOOST_CHECK_EQUAL(*trapezoid.pull(1.0), 0.5);
+    BOOST_CHECK_EQUAL(*trapezoid.pull(3.0), 4.5);
+
+    // Simpson's rule is exact for cubics, whatever the pull rate.
+    const Behavior<double> cubic = sfrp::BehaviorUtil::pure(
+        [](double time) { return time * time * time; });
+    const Behavior<double> simpson =
+        sfrp::VectorSpaceUtil::integral(cubic, VectorSpaceUtil::e_SIMPSON);
+    BOOST_CHECK_SMALL(*simpson.pull(1.0) - 0.25, 1e-12);
+    BOOST_CHECK_SMALL(*simpson.pull(3.0) - 20.25, 1e-12);
+
+    // Behaviors that aren't pure can't be sub-sampled.
+    const Behavior<double> impure =
+        Behavior<double>::fromValuePullFunc([](double time) { return time; });
+    BOOST_CHECK(!impure.isPure());
+    const Behavior<double> fallback =
+        sfrp::VectorSpaceUtil::integral(impure, VectorSpaceUtil::e_SIMPSON);
+    BOOST_CHECK_EQUAL(*fallback.pull(1.0), 1.0);
+    BOOST_CHECK_EQUAL(*fallback.pull(2.0), 2.5);
+
+    // A pure behavior that can't be evaluated at the time of a sub-sample falls
+    // back to the rules that use the samples it has.
+    const boost::function<std::size_t(const double*, std::size_t, double*)>
+        cubeFromOne = [](const double* times, std::size_t n, double* out) {
+          std::size_t i = 0;
+          for (; i < n && times[i] >= 1.0; ++i)
+            out[i] = times[i] * times[i] * times[i];
+          return i;
+        };
+    const Behavior<double> late = Behavior<double>::fromValuePullFunc(
+        [](double time) { return boost::make_optional(time * time * time); },
+        cubeFromOne,
+        cubeFromOne);
+    const Behavior<double> lateSimpson =
+        sfrp::VectorSpaceUtil::integral(late, VectorSpaceUtil::e_SIMPSON);
+    BOOST_CHECK_EQUAL(*lateSimpson.pull(2.0), 16.0);
+    BOOST_CHECK_SMALL(*lateSimpson.pull(4.0) - 76.0, 1e-12);
+  });
+  col.addTest("sfrp_vectorspaceutil_integral_shared", []()->void {
+    // The sub-samples of an integrand that is also an argument of the mapping
+    // of its integral leave the value of that argument intact.
+    const Behavior<double> square = sfrp::BehaviorUtil::map(
+        [](double time) { return time * time; }, sfrp::BehaviorUtil::time());
+    const Behavior<std::pair<double, double>> both = sfrp::BehaviorMap()(
+        [](double value, double integral) {
+          return std::make_pair(value, integral);
+        },
+        square,
+        sfrp::VectorSpaceUtil::adaptiveIntegral(square, 1e-12, 3));
+    for (int i = 1; i <= 3; ++i) {
+      const double time = i;
+      const std::uint64_t version = square.valueVersion();
+      const std::pair<double, double> value = *both.pull(time);
+      BOOST_CHECK_EQUAL(value.first, time * time);
+      BOOST_CHECK_SMALL(value.second - time * time * time / 3.0, 1e-12);
+      BOOST_CHECK_EQUAL(square.valueVersion(), version + 1);
+    }
+  });
+  col.addTest("sfrp_vectorspaceutil_adaptiveIntegral", []()->void {
+    const Behavior<double> sine =
+        sfrp::BehaviorUtil::pure([](double time) { return std::sin(time); });
+    const Behavior<double> integral =
+        sfrp::VectorSpaceUtil::adaptiveIntegral(sine, 1e-10);
+    const Behavior<double> rectangle = sfrp::VectorSpaceUtil::integral(sine);
+    double rectangleError = 0.0;
+    for (int i = 1; i <= 10; ++i) {
+      const double time = i * 0.3;
+      BOOST_CHECK_SMALL(*integral.pull(time) - (1.0 - std::cos(time)), 1e-8);
+      rectangleError =
+          std::fabs(*rectangle.pull(time) - (1.0 - std::cos(time)));
+    }
+    BOOST_CHECK(rectangleError > 1e-3);
+  });
+  col.addTest("sfrp_vectorspaceutil_solution", []()->void {
+    // 'x' is 'exp(t)'.
+    const Behavior<double> exponential = sfrp::VectorSpaceUtil::solution(
+        1.0, [](double x, double time) { return x; });
+    for (int i = 1; i <= 60; ++i)
+      exponential.pull(i / 60.0);
+    BOOST_CHECK_SMALL(*exponential.pull(1.0) - std::exp(1.0), 1e-8);
+
+    // Sub-steps keep the solution accurate at low pull rates.
+    const Behavior<double> substepped = sfrp::VectorSpaceUtil::solution(
+        1.0, [](double x, double time) { return x; }, 1.0 / 60.0);
+    BOOST_CHECK_SMALL(*substepped.pull(1.0) - std::exp(1.0), 1e-8);
+  });
 }
 }
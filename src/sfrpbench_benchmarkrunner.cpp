@@ -0,0 +1,91 @@
+#include <sfrpbench/benchmarkrunner.hpp>
+
+#include <algorithm>  // std::nth_element, std::max
+#include <chrono>
+#include <iomanip>  // std::setw, std::setprecision
+#include <ostream>
+
+namespace sfrpbench {
+std::atomic<std::uint64_t> BenchmarkRunner_AllocationCounter::s_count(0);
+
+const double BenchmarkRunner::k_TIME_STEP = 1.0 / 60.0;
+
+BenchmarkRunner::BenchmarkRunner(unsigned numRepetitions)
+    : m_numRepetitions(std::max(numRepetitions, 1u)), m_benchmarks() {}
+
+void BenchmarkRunner::add(const std::string& name,
+                          std::size_t numPulls,
+                          const GraphFactory& factory) {
+  m_benchmarks.push_back(Benchmark{name, numPulls, factory});
+}
+
+std::vector<BenchmarkRunner_Result> BenchmarkRunner::run(
+    const std::string& filter) const {
+  std::vector<BenchmarkRunner_Result> results;
+  for (const Benchmark& benchmark : m_benchmarks) {
+    if (benchmark.name.find(filter) == std::string::npos)
+      continue;
+
+    std::vector<double> nanosecondsPerPull;
+    std::uint64_t numAllocations = 0;
+    for (unsigned repetition = 0; repetition < m_numRepetitions;
+         ++repetition) {
+      const boost::function<void(double)> pull = benchmark.factory();
+
+      const std::uint64_t allocationsBefore =
+          BenchmarkRunner_AllocationCounter::count();
+      const auto start = std::chrono::steady_clock::now();
+      for (std::size_t i = 0; i < benchmark.numPulls; ++i)
+        pull(i * k_TIME_STEP);
+      const auto end = std::chrono::steady_clock::now();
+
+      // Allocations are deterministic so the count of any repetition will do.
+      numAllocations =
+          BenchmarkRunner_AllocationCounter::count() - allocationsBefore;
+      nanosecondsPerPull.push_back(
+          std::chrono::duration<double, std::nano>(end - start).count() /
+          std::max<std::size_t>(benchmark.numPulls, 1));
+    }
+
+    std::nth_element(nanosecondsPerPull.begin(),
+                     nanosecondsPerPull.begin() + nanosecondsPerPull.size() / 2,
+                     nanosecondsPerPull.end());
+    results.push_back(BenchmarkRunner_Result{
+        benchmark.name, benchmark.numPulls, numAllocations,
+        nanosecondsPerPull[nanosecondsPerPull.size() / 2]});
+  }
+  return results;
+}
+
+void BenchmarkRunner::print(std::ostream& stream,
+                            const std::vector<BenchmarkRunner_Result>& results,
+                            bool includeTimes) {
+  std::size_t nameWidth = 9;
+  for (const BenchmarkRunner_Result& result : results)
+    nameWidth = std::max(nameWidth, result.name.size());
+  nameWidth += 2;
+
+  stream << std::left << std::setw(nameWidth) << "benchmark" << std::right
+         << std::setw(10) << "pulls" << std::setw(14) << "allocs/pull";
+  if (includeTimes)
+    stream << std::setw(12) << "ns/pull" << std::setw(14) << "pulls/sec";
+  stream << '\n';
+
+  for (const BenchmarkRunner_Result& result : results) {
+    const double allocationsPerPull =
+        result.numPulls ? double(result.numAllocations) / result.numPulls : 0.0;
+    stream << std::left << std::setw(nameWidth) << result.name << std::right
+           << std::setw(10) << result.numPulls << std::setw(14) << std::fixed
+           << std::setprecision(3) << allocationsPerPull;
+    if (includeTimes) {
+      stream << std::setw(12) << std::setprecision(1)
+             << result.nanosecondsPerPull << std::setw(14)
+             << std::setprecision(0)
+             << (result.nanosecondsPerPull > 0.0
+                     ? 1e9 / result.nanosecondsPerPull
+                     : 0.0);
+    }
+    stream << '\n';
+  }
+}
+}
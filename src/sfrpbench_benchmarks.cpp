@@ -0,0 +1,141 @@
+#include <sfrpbench/benchmarks.hpp>
+
+#include <boost/optional.hpp>
+#include <sfrp/behavior.hpp>
+#include <sfrp/behaviormap.hpp>
+#include <sfrp/behaviorschedule.hpp>
+#include <sfrp/behaviorutil.hpp>
+#include <sfrp/eventmap.hpp>
+#include <sfrp/eventutil.hpp>
+#include <sfrp/joinutil.hpp>
+#include <sfrp/triggerutil.hpp>
+#include <sfrp/vectorspaceutil.hpp>
+#include <sfrpbench/benchmarkrunner.hpp>
+#include <smisc/point1dvectorspace.hpp>
+#include <memory>  // std::make_shared
+#include <vector>
+
+namespace {
+const std::size_t k_NUM_PULLS = 20000;
+
+// Return a function that pulls the specified 'behavior'.
+template <typename T>
+boost::function<void(double)> pullFunction(const sfrp::Behavior<T>& behavior) {
+  return [behavior](double time) { behavior.pull(time); };
+}
+
+// Return a function that pulls the specified 'behavior' with a schedule.
+template <typename T>
+boost::function<void(double)> scheduledPullFunction(
+    const sfrp::Behavior<T>& behavior) {
+  const std::shared_ptr<sfrp::BehaviorSchedule<T>> schedule =
+      std::make_shared<sfrp::BehaviorSchedule<T>>(behavior);
+  return [schedule](double time) { schedule->pull(time); };
+}
+
+// Return a volatile source behavior whose value depends upon the specified
+// 'seed'.
+sfrp::Behavior<double> source(int seed) {
+  return sfrp::Behavior<double>::fromValuePullFunc([seed](double time) {
+    return boost::make_optional(time * seed);
+  });
+}
+
+sfrp::Behavior<double> mapChain(int length) {
+  sfrp::Behavior<double> behavior = sfrp::BehaviorUtil::time();
+  for (int i = 0; i < length; ++i)
+    behavior = sfrp::BehaviorMap()([](double x) { return x + 1.0; }, behavior);
+  return behavior;
+}
+
+// Return the behaviors that are the sums of consecutive groups of four of the
+// specified 'behaviors'.
+std::vector<sfrp::Behavior<double>> sum4(
+    const std::vector<sfrp::Behavior<double>>& behaviors) {
+  std::vector<sfrp::Behavior<double>> sums;
+  for (std::size_t i = 0; i + 3 < behaviors.size(); i += 4) {
+    sums.push_back(sfrp::BehaviorMap()(
+        [](double b0, double b1, double b2, double b3) {
+          return b0 + b1 + b2 + b3;
+        },
+        behaviors[i], behaviors[i + 1], behaviors[i + 2], behaviors[i + 3]));
+  }
+  return sums;
+}
+
+sfrp::Behavior<double> fanIn() {
+  std::vector<sfrp::Behavior<double>> behaviors;
+  for (int i = 0; i < 64; ++i)
+    behaviors.push_back(source(i));
+  while (behaviors.size() > 1)
+    behaviors = sum4(behaviors);
+  return behaviors.front();
+}
+
+boost::function<void(double)> wormholeSum() {
+  return pullFunction(sfrp::VectorSpaceUtil::sum(source(1)));
+}
+
+boost::function<void(double)> wormholeIntegral() {
+  return pullFunction(sfrp::VectorSpaceUtil::integral(source(1)));
+}
+
+boost::function<void(double)> accumulate() {
+  const sfrp::Behavior<boost::optional<int>> event =
+      sfrp::Behavior<boost::optional<int>>::fromValuePullFunc([](double time) {
+        return boost::make_optional(boost::make_optional(1));
+      });
+  const auto adder = sfrp::EventMap()([](int i) -> boost::function<int(int)> {
+                                        return [i](int j) { return i + j; };
+                                      },
+                                      event);
+  return pullFunction(sfrp::EventUtil::accumulate(0, adder));
+}
+
+boost::function<void(double)> joinSwitch(int interval) {
+  auto counter = std::make_shared<int>(0);
+  const sfrp::Behavior<boost::optional<sfrp::Behavior<double>>> switches =
+      sfrp::Behavior<boost::optional<sfrp::Behavior<double>>>::
+          fromValuePullFunc([counter, interval](double time) {
+            typedef boost::optional<sfrp::Behavior<double>> Occurrence;
+            if ((*counter)++ % interval != 0)
+              return boost::make_optional(Occurrence());
+            return boost::make_optional(Occurrence(sfrp::BehaviorMap()(
+                [](double t) { return t * 2.0; }, sfrp::BehaviorUtil::time())));
+          });
+  return pullFunction(sfrp::JoinUtil::join(switches));
+}
+
+boost::function<void(double)> triggerInjection() {
+  const auto trigger = sfrp::TriggerUtil::triggerInfStep(0);
+  const sfrp::Behavior<int> doubled =
+      sfrp::BehaviorMap()([](int i) { return i * 2; }, trigger.first);
+  auto counter = std::make_shared<int>(0);
+  const boost::function<void(const int&)> set = trigger.second;
+  return [doubled, set, counter](double time) {
+    set((*counter)++);
+    doubled.pull(time);
+  };
+}
+}
+
+namespace sfrpbench {
+void benchmarks(BenchmarkRunner& runner) {
+  runner.add("mapChain/100", k_NUM_PULLS,
+             []() { return pullFunction(mapChain(100)); });
+  runner.add("mapChain/100/scheduled", k_NUM_PULLS,
+             []() { return scheduledPullFunction(mapChain(100)); });
+  runner.add("mapChain/10000", k_NUM_PULLS / 100,
+             []() { return pullFunction(mapChain(10000)); });
+  runner.add("mapChain/10000/scheduled", k_NUM_PULLS / 100,
+             []() { return scheduledPullFunction(mapChain(10000)); });
+  runner.add("fanIn/64", k_NUM_PULLS, []() { return pullFunction(fanIn()); });
+  runner.add("fanIn/64/scheduled", k_NUM_PULLS,
+             []() { return scheduledPullFunction(fanIn()); });
+  runner.add("wormholeSum", k_NUM_PULLS, &wormholeSum);
+  runner.add("wormholeIntegral", k_NUM_PULLS, &wormholeIntegral);
+  runner.add("accumulate", k_NUM_PULLS, &accumulate);
+  runner.add("joinSwitch/60", k_NUM_PULLS, []() { return joinSwitch(60); });
+  runner.add("triggerInjection", k_NUM_PULLS, &triggerInjection);
+}
+}
@@ -0,0 +1,51 @@
+// Runs the sfrp benchmarks and writes their results to standard output.
+//
+// Usage: sfrpbench_main [--no-timing] [--repetitions N] [FILTER]
+//
+// Only the benchmarks whose name contains FILTER are run. With '--no-timing'
+// only the deterministic columns are written so that the output of two
+// releases can be compared with 'diff'.
+
+#include <sfrpbench/benchmarkrunner.hpp>
+#include <sfrpbench/benchmarks.hpp>
+#include <cstdlib>  // std::malloc, std::free, std::atoi
+#include <cstring>  // std::strcmp
+#include <iostream>
+#include <new>  // std::bad_alloc
+#include <string>
+
+void* operator new(std::size_t size) {
+  sfrpbench::BenchmarkRunner_AllocationCounter::increment();
+  if (void* const p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+int main(int argc, char** argv) {
+  bool includeTimes = true;
+  unsigned numRepetitions = 5;
+  std::string filter;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--no-timing") == 0) {
+      includeTimes = false;
+    } else if (std::strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+      numRepetitions = std::atoi(argv[++i]);
+    } else if (argv[i][0] == '-') {
+      std::cerr << "Usage: " << argv[0]
+                << " [--no-timing] [--repetitions N] [FILTER]" << std::endl;
+      return 1;
+    } else {
+      filter = argv[i];
+    }
+  }
+
+  sfrpbench::BenchmarkRunner runner(numRepetitions);
+  sfrpbench::benchmarks(runner);
+  sfrpbench::BenchmarkRunner::print(std::cout, runner.run(filter),
+                                    includeTimes);
+  return 0;
+}